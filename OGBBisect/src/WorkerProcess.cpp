@@ -0,0 +1,178 @@
+#include "WorkerProcess.h"
+
+#include "Core/Logger.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+WorkerProcess::WorkerProcess(FILE* input, FILE* output, const intptr_t process) : _input(input), _output(output), _process(process)
+{
+}
+
+#ifdef _WIN32
+
+namespace
+{
+    // Enough for paths with spaces, the arguments of this tool hold no quotes
+    std::string Quote(const std::string& argument)
+    {
+        return '"' + argument + '"';
+    }
+}
+
+WorkerProcess::~WorkerProcess()
+{
+    std::fclose(_input);
+    std::fclose(_output);
+    const HANDLE process = reinterpret_cast<HANDLE>(_process);
+    WaitForSingleObject(process, INFINITE);
+    CloseHandle(process);
+}
+
+std::unique_ptr<WorkerProcess> WorkerProcess::Start(const std::string& executablePath, const std::vector<std::string>& arguments)
+{
+    SECURITY_ATTRIBUTES security{sizeof(security), nullptr, TRUE};
+    HANDLE childInput, input, output, childOutput;
+    if (!CreatePipe(&childInput, &input, &security, 0))
+    {
+        LOG("Error creating the pipes to worker " << executablePath);
+        return nullptr;
+    }
+    if (!CreatePipe(&output, &childOutput, &security, 0))
+    {
+        LOG("Error creating the pipes to worker " << executablePath);
+        CloseHandle(childInput);
+        CloseHandle(input);
+        return nullptr;
+    }
+
+    // Only the child's ends are inherited
+    SetHandleInformation(input, HANDLE_FLAG_INHERIT, 0);
+    SetHandleInformation(output, HANDLE_FLAG_INHERIT, 0);
+
+    std::string commandLine = Quote(executablePath);
+    for (const std::string& argument : arguments)
+        commandLine += ' ' + Quote(argument);
+
+    STARTUPINFOA startupInfo{};
+    startupInfo.cb = sizeof(startupInfo);
+    startupInfo.dwFlags = STARTF_USESTDHANDLES;
+    startupInfo.hStdInput = childInput;
+    startupInfo.hStdOutput = childOutput;
+    startupInfo.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+
+    PROCESS_INFORMATION processInformation{};
+    const bool isStarted = CreateProcessA(nullptr, commandLine.data(), nullptr, nullptr, TRUE, 0, nullptr, nullptr, &startupInfo,
+                                          &processInformation);
+    CloseHandle(childInput);
+    CloseHandle(childOutput);
+
+    if (!isStarted)
+    {
+        LOG("Error starting worker " << executablePath);
+        CloseHandle(input);
+        CloseHandle(output);
+        return nullptr;
+    }
+
+    CloseHandle(processInformation.hThread);
+    FILE* inputFile = _fdopen(_open_osfhandle(reinterpret_cast<intptr_t>(input), 0), "w");
+    FILE* outputFile = _fdopen(_open_osfhandle(reinterpret_cast<intptr_t>(output), _O_RDONLY), "r");
+    return std::unique_ptr<WorkerProcess>(new WorkerProcess(inputFile, outputFile, reinterpret_cast<intptr_t>(processInformation.hProcess)));
+}
+
+#else
+
+WorkerProcess::~WorkerProcess()
+{
+    std::fclose(_input);
+    std::fclose(_output);
+    waitpid(static_cast<pid_t>(_process), nullptr, 0);
+}
+
+std::unique_ptr<WorkerProcess> WorkerProcess::Start(const std::string& executablePath, const std::vector<std::string>& arguments)
+{
+    // Requests to a worker that died fail instead of killing this process
+    std::signal(SIGPIPE, SIG_IGN);
+
+    int inputPipe[2];
+    int outputPipe[2];
+    if (pipe(inputPipe) != 0)
+    {
+        LOG("Error creating the pipes to worker " << executablePath);
+        return nullptr;
+    }
+    if (pipe(outputPipe) != 0)
+    {
+        LOG("Error creating the pipes to worker " << executablePath);
+        close(inputPipe[0]);
+        close(inputPipe[1]);
+        return nullptr;
+    }
+
+    std::vector<char*> argv;
+    argv.push_back(const_cast<char*>(executablePath.c_str()));
+    for (const std::string& argument : arguments)
+        argv.push_back(const_cast<char*>(argument.c_str()));
+    argv.push_back(nullptr);
+
+    const pid_t processId = fork();
+    if (processId == 0)
+    {
+        dup2(inputPipe[0], STDIN_FILENO);
+        dup2(outputPipe[1], STDOUT_FILENO);
+        close(inputPipe[0]);
+        close(inputPipe[1]);
+        close(outputPipe[0]);
+        close(outputPipe[1]);
+        execv(executablePath.c_str(), argv.data());
+        _exit(127);
+    }
+
+    close(inputPipe[0]);
+    close(outputPipe[1]);
+    if (processId < 0)
+    {
+        LOG("Error starting worker " << executablePath);
+        close(inputPipe[1]);
+        close(outputPipe[0]);
+        return nullptr;
+    }
+
+    return std::unique_ptr<WorkerProcess>(new WorkerProcess(fdopen(inputPipe[1], "w"), fdopen(outputPipe[0], "r"), processId));
+}
+
+#endif
+
+bool WorkerProcess::Send(const std::string& command)
+{
+    return std::fputs(command.c_str(), _input) != EOF && std::fputc('\n', _input) != EOF && std::fflush(_input) == 0;
+}
+
+bool WorkerProcess::Receive(std::string& reply)
+{
+    reply.clear();
+    char buffer[4096];
+    while (std::fgets(buffer, sizeof(buffer), _output))
+    {
+        reply += buffer;
+        if (reply.back() == '\n')
+        {
+            reply.pop_back();
+            // Lines written in text mode on Windows end with both
+            if (!reply.empty() && reply.back() == '\r')
+                reply.pop_back();
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Another build of this tool running in worker mode, which answers every command line written to its standard input
+// with one line on its standard output. The worker exits once its input is closed, when this is destroyed.
+class WorkerProcess
+{
+public:
+    ~WorkerProcess();
+
+    static std::unique_ptr<WorkerProcess> Start(const std::string& executablePath, const std::vector<std::string>& arguments);
+
+    // Sending to several workers before receiving lets them work at the same time. Both return false once the worker
+    // exited.
+    bool Send(const std::string& command);
+    bool Receive(std::string& reply);
+
+private:
+    WorkerProcess(FILE* input, FILE* output, intptr_t process);
+
+    FILE* _input;
+    FILE* _output;
+    // A process handle on Windows, a process id elsewhere
+    intptr_t _process;
+};
@@ -0,0 +1,393 @@
+#include <algorithm>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Core/Logger.h"
+#include "Core/Utils.h"
+
+#include "Emulator/Disassembly/Disassembler.h"
+#include "Emulator/Divergence/CheckpointedRun.h"
+#include "Emulator/Divergence/StateSnapshot.h"
+#include "Emulator/Input/InputMoviePlayer.h"
+
+#include "WorkerProcess.h"
+
+// Runs a cartridge and an input movie on two builds of this tool and finds where they first disagree. Each build runs
+// as a worker process keeping checkpoints every few frames and answering for its own state: the hashes recorded after
+// every frame give the first frame that ends differently, and a binary search over the instructions of that frame,
+// run again from the checkpoint before it, the first instruction.
+namespace
+{
+    struct Options
+    {
+        std::string romPath;
+        std::string moviePath;
+        std::string buildPaths[2];
+        unsigned int checkpointInterval = 64;
+        // The movie's length when 0, frames past its end have no button pressed
+        unsigned int frameCount = 0;
+        // Differing bytes listed in the report, the rest are only counted
+        unsigned int memoryDifferenceCount = 32;
+        bool isWorker = false;
+    };
+
+    struct Build
+    {
+        const std::string& path;
+        std::unique_ptr<WorkerProcess> worker;
+        std::string reply;
+    };
+
+    [[nodiscard]] std::string FormatHash(const unsigned long long hash)
+    {
+        return std::format("{:016X}", hash);
+    }
+
+    // One line holding the registers and then every byte of memory in hexadecimal, 128 KB
+    [[nodiscard]] std::string FormatSnapshot(const StateSnapshot& snapshot)
+    {
+        const CpuState& cpu = snapshot.cpu;
+        std::string text = std::format("{} {:04X} {:04X} {:04X} {:04X} {:04X} {:04X} {} {} ", snapshot.cycle, cpu.af, cpu.bc, cpu.de, cpu.hl, cpu.sp,
+                                       cpu.pc, cpu.ime, snapshot.isHalted ? 1 : 0);
+
+        constexpr char digits[] = "0123456789ABCDEF";
+        for (const byte value : snapshot.memory)
+        {
+            text += digits[value >> 4];
+            text += digits[value & 0xF];
+        }
+
+        return text;
+    }
+
+    [[nodiscard]] bool ParseSnapshot(const std::string& text, StateSnapshot& snapshot)
+    {
+        std::istringstream stream(text);
+        unsigned int ime;
+        unsigned int isHalted;
+        std::string memory;
+        stream >> snapshot.cycle >> std::hex >> snapshot.cpu.af >> snapshot.cpu.bc >> snapshot.cpu.de >> snapshot.cpu.hl >> snapshot.cpu.sp >>
+            snapshot.cpu.pc >> std::dec >> ime >> isHalted >> memory;
+        if (!stream || memory.size() != StateSnapshot::MemorySize * 2)
+            return false;
+
+        snapshot.cpu.ime = static_cast<byte>(ime);
+        snapshot.isHalted = isHalted != 0;
+        snapshot.memory.resize(StateSnapshot::MemorySize);
+        for (unsigned int address = 0; address < StateSnapshot::MemorySize; address++)
+            snapshot.memory[address] = static_cast<byte>(std::stoul(memory.substr(address * 2, 2), nullptr, 16));
+
+        return true;
+    }
+
+    [[nodiscard]] std::vector<byte> ReadMovieButtons(const std::string& moviePath, int& framesPerSecond)
+    {
+        InputMoviePlayer moviePlayer(moviePath);
+        if (!moviePlayer.IsValid())
+            return {};
+
+        framesPerSecond = moviePlayer.GetHeader().framesPerSecond;
+        std::vector<byte> buttons;
+        while (!moviePlayer.IsFinished())
+            buttons.push_back(moviePlayer.ReadFrame());
+        return buttons;
+    }
+
+    // Answers one line per command line until the input ends:
+    //   record                           the frame count, then the hash before every frame and at the end
+    //   prefix <frame> <instructions>    the hash after the first instructions of the frame, and how many ran
+    //   snapshot <frame> <instructions>  the whole state after them
+    // Anything that can't be answered gets an "error" line.
+    int RunWorker(const Options& options)
+    {
+        // The replies go to the standard output, logs would get mixed in
+        Logger::SetMuted(true);
+
+        auto cartridgeBytes = std::make_shared<const std::vector<byte>>(Utils::ReadBinaryFile(options.romPath));
+        int framesPerSecond = 0;
+        std::vector<byte> buttons = ReadMovieButtons(options.moviePath, framesPerSecond);
+        if (options.frameCount)
+            buttons.resize(options.frameCount);
+
+        CheckpointedRun run(cartridgeBytes, std::move(buttons), framesPerSecond, options.checkpointInterval);
+        const bool isValid = run.IsValid() && framesPerSecond != 0;
+
+        std::string line;
+        while (std::getline(std::cin, line))
+        {
+            std::istringstream request(line);
+            std::string command;
+            unsigned int frame = 0;
+            unsigned int instructionCount = 0;
+            request >> command >> frame >> instructionCount;
+
+            std::string reply = "error";
+            if (!isValid)
+                reply = "error invalid cartridge or movie";
+            else if (command == "record")
+            {
+                reply = std::to_string(run.GetFrameCount());
+                for (const unsigned long long hash : run.Record())
+                    reply += ' ' + FormatHash(hash);
+            }
+            else if (command == "prefix" && frame < run.GetFrameCount())
+            {
+                const unsigned int instructionsRun = run.SeekInstruction(frame, instructionCount);
+                reply = FormatHash(StateSnapshot::Take(run.GetDevice()).Hash()) + ' ' + std::to_string(instructionsRun);
+            }
+            else if (command == "snapshot" && frame < run.GetFrameCount())
+            {
+                run.SeekInstruction(frame, instructionCount);
+                reply = FormatSnapshot(StateSnapshot::Take(run.GetDevice()));
+            }
+
+            std::cout << reply << std::endl;
+        }
+
+        return 0;
+    }
+
+    bool Receive(Build& build, const std::string& command)
+    {
+        if (!build.worker->Receive(build.reply))
+        {
+            LOG("Build " << build.path << " exited while answering " << command);
+            return false;
+        }
+        if (build.reply.starts_with("error"))
+        {
+            LOG("Build " << build.path << " couldn't answer " << command << ": " << build.reply);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool Ask(Build& build, const std::string& command)
+    {
+        return build.worker->Send(command) && Receive(build, command);
+    }
+
+    // Both builds work on the command at the same time, the replies are then in the builds
+    bool AskBoth(Build (&builds)[2], const std::string& command)
+    {
+        return builds[0].worker->Send(command) && builds[1].worker->Send(command) && Receive(builds[0], command) && Receive(builds[1], command);
+    }
+
+    [[nodiscard]] unsigned int ReadInstructionCount(const std::string& prefixReply)
+    {
+        return static_cast<unsigned int>(std::stoul(prefixReply.substr(prefixReply.find(' ') + 1)));
+    }
+
+    [[nodiscard]] bool IsSameHash(const Build (&builds)[2])
+    {
+        return builds[0].reply.substr(0, 16) == builds[1].reply.substr(0, 16);
+    }
+
+    void LogDifference(const std::string& name, const std::string& valueA, const std::string& valueB)
+    {
+        LOG(std::format("    {:<8} {:>12} {:>12}", name, valueA, valueB));
+    }
+
+    void LogDifferences(const StateSnapshot (&snapshots)[2], const unsigned int memoryDifferenceCount)
+    {
+        const StateSnapshot& a = snapshots[0];
+        const StateSnapshot& b = snapshots[1];
+        LogDifference("", "A", "B");
+        if (a.cycle != b.cycle)
+            LogDifference("cycle", std::to_string(a.cycle), std::to_string(b.cycle));
+
+        const char* registerNames[] = {"AF", "BC", "DE", "HL", "SP", "PC"};
+        const word registersA[] = {a.cpu.af, a.cpu.bc, a.cpu.de, a.cpu.hl, a.cpu.sp, a.cpu.pc};
+        const word registersB[] = {b.cpu.af, b.cpu.bc, b.cpu.de, b.cpu.hl, b.cpu.sp, b.cpu.pc};
+        for (unsigned int i = 0; i < std::size(registerNames); i++)
+        {
+            if (registersA[i] != registersB[i])
+                LogDifference(registerNames[i], std::format("{:04X}", registersA[i]), std::format("{:04X}", registersB[i]));
+        }
+        if (a.cpu.ime != b.cpu.ime)
+            LogDifference("IME", std::to_string(a.cpu.ime), std::to_string(b.cpu.ime));
+        if (a.isHalted != b.isHalted)
+            LogDifference("halted", a.isHalted ? "yes" : "no", b.isHalted ? "yes" : "no");
+
+        unsigned int differenceCount = 0;
+        for (unsigned int address = 0; address < StateSnapshot::MemorySize; address++)
+        {
+            if (a.memory[address] != b.memory[address] && differenceCount++ < memoryDifferenceCount)
+                LogDifference(std::format("{:04X}", address), std::format("{:02X}", a.memory[address]), std::format("{:02X}", b.memory[address]));
+        }
+        if (differenceCount > memoryDifferenceCount)
+            LOG("    and " << differenceCount - memoryDifferenceCount << " more bytes of memory");
+    }
+
+    // The first instruction that leaves the builds in different states, with what it changed differently. Before it
+    // both builds are in the same state, the first one's tells which instruction it is.
+    bool Report(Build (&builds)[2], const unsigned int frame, const unsigned int instruction, const unsigned int memoryDifferenceCount)
+    {
+        StateSnapshot before;
+        if (instruction && (!Ask(builds[0], std::format("snapshot {} {}", frame, instruction - 1)) || !ParseSnapshot(builds[0].reply, before)))
+            return false;
+
+        StateSnapshot after[2];
+        for (unsigned int i = 0; i < 2; i++)
+        {
+            if (!Ask(builds[i], std::format("snapshot {} {}", frame, instruction)) || !ParseSnapshot(builds[i].reply, after[i]))
+                return false;
+        }
+
+        if (instruction == 0)
+            LOG("Builds diverge in frame " << frame << " before its first instruction, when the buttons are applied");
+        else
+        {
+            const word pc = before.cpu.pc;
+            const byte bytes[3] = {before.memory[pc], before.memory[static_cast<word>(pc + 1)], before.memory[static_cast<word>(pc + 2)]};
+            const std::string mnemonic = before.isHalted ? "halted" : Disassembler::Format(Disassembler::Decode(bytes, pc));
+            LOG(std::format("Builds diverge in frame {} at instruction {}, cycle {}: {:04X}: {}", frame, instruction, before.cycle, pc, mnemonic));
+        }
+
+        LogDifferences(after, memoryDifferenceCount);
+        return true;
+    }
+
+    // Returns 0 when the builds agree until the end, 2 when they diverge
+    int Bisect(const Options& options)
+    {
+        const std::vector<std::string> arguments = {"--worker", "--rom", options.romPath, "--movie", options.moviePath, "--interval",
+                                                    std::to_string(options.checkpointInterval), "--frames", std::to_string(options.frameCount)};
+        Build builds[2] = {{options.buildPaths[0]}, {options.buildPaths[1]}};
+        for (Build& build : builds)
+        {
+            build.worker = WorkerProcess::Start(build.path, arguments);
+            if (!build.worker)
+                return 1;
+        }
+
+        if (!AskBoth(builds, "record"))
+            return 1;
+        unsigned int frameCounts[2];
+        std::vector<std::string> hashes[2];
+        for (unsigned int i = 0; i < 2; i++)
+        {
+            std::istringstream stream(builds[i].reply);
+            stream >> frameCounts[i];
+            for (std::string hash; stream >> hash;)
+                hashes[i].push_back(hash);
+        }
+        if (frameCounts[0] != frameCounts[1] || hashes[0].size() != hashes[1].size() || hashes[0].size() != frameCounts[0] + 1)
+        {
+            LOG("Builds ran different frame counts, " << frameCounts[0] << " and " << frameCounts[1]);
+            return 1;
+        }
+
+        const auto divergence = std::ranges::mismatch(hashes[0], hashes[1]);
+        if (divergence.in1 == hashes[0].end())
+        {
+            LOG("Builds agree after every one of the " << frameCounts[0] << " frames");
+            return 0;
+        }
+
+        // The hash before the first frame that ends differently, its instructions start equal
+        const unsigned int firstDifferentHash = static_cast<unsigned int>(divergence.in1 - hashes[0].begin());
+        if (firstDifferentHash == 0)
+        {
+            LOG("Builds diverge before the first frame, when the cartridge starts");
+            return 2;
+        }
+
+        const unsigned int frame = firstDifferentHash - 1;
+        LOG("Builds diverge in frame " << frame << ", bisecting its instructions");
+        if (!AskBoth(builds, std::format("prefix {} {}", frame, ~0u)))
+            return 1;
+        const unsigned int instructionCounts[2] = {ReadInstructionCount(builds[0].reply), ReadInstructionCount(builds[1].reply)};
+        unsigned int highInstruction = std::min(instructionCounts[0], instructionCounts[1]);
+
+        if (!AskBoth(builds, std::format("prefix {} {}", frame, highInstruction)))
+            return 1;
+        if (IsSameHash(builds))
+        {
+            if (instructionCounts[0] == instructionCounts[1])
+            {
+                // What differs is reached at the end of the frame, outside of any instruction
+                LOG("Builds diverge at the end of frame " << frame << ", after its " << highInstruction << " instructions");
+                return 2;
+            }
+
+            LOG("Builds ran " << instructionCounts[0] << " and " << instructionCounts[1] << " instructions in frame " << frame);
+            highInstruction++;
+        }
+        else
+        {
+            if (!AskBoth(builds, std::format("prefix {} 0", frame)))
+                return 1;
+
+            if (IsSameHash(builds))
+            {
+                unsigned int lowInstruction = 0;
+                while (highInstruction - lowInstruction > 1)
+                {
+                    const unsigned int middleInstruction = lowInstruction + (highInstruction - lowInstruction) / 2;
+                    if (!AskBoth(builds, std::format("prefix {} {}", frame, middleInstruction)))
+                        return 1;
+                    (IsSameHash(builds) ? lowInstruction : highInstruction) = middleInstruction;
+                }
+            }
+            else
+                highInstruction = 0;
+        }
+
+        return Report(builds, frame, highInstruction, options.memoryDifferenceCount) ? 2 : 1;
+    }
+}
+
+bool ParseArguments(const int argc, char* argv[], Options& options)
+{
+    unsigned int buildCount = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (argument == "--rom" && hasValue)
+            options.romPath = argv[++i];
+        else if (argument == "--movie" && hasValue)
+            options.moviePath = argv[++i];
+        else if (argument == "--interval" && hasValue)
+            options.checkpointInterval = std::max(static_cast<unsigned int>(std::stoul(argv[++i])), 1u);
+        else if (argument == "--frames" && hasValue)
+            options.frameCount = static_cast<unsigned int>(std::stoul(argv[++i]));
+        else if (argument == "--memory-differences" && hasValue)
+            options.memoryDifferenceCount = static_cast<unsigned int>(std::stoul(argv[++i]));
+        else if (argument == "--worker")
+            options.isWorker = true;
+        else if (argument.starts_with("--") || buildCount == 2)
+            return false;
+        else
+            options.buildPaths[buildCount++] = argument;
+    }
+
+    return !options.romPath.empty() && !options.moviePath.empty() && (options.isWorker || buildCount == 2);
+}
+
+// Finds where two builds first disagree on a movie, for instance: OGBBisect --rom game.gb --movie input.ogbm old/OGBBisect
+// new/OGBBisect. Both builds must include this tool, they're started as workers with the same arguments.
+int main(const int argc, char* argv[])
+{
+    Options options;
+
+    if (!ParseArguments(argc, argv, options))
+    {
+        DEBUGBREAKLOG("Wrong program arguments, usage: OGBBisect --rom romPath.gb --movie input.ogbm [--interval frames] [--frames n] "
+            "[--memory-differences count] buildA buildB");
+        return 1;
+    }
+
+    if (options.isWorker)
+        return RunWorker(options);
+
+    return Bisect(options);
+}
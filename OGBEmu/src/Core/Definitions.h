@@ -4,3 +4,10 @@ typedef unsigned char byte;
 typedef unsigned short word;
 typedef char signed_byte;
 typedef short signed_word;
+
+// For hot paths that only pay off when all of them ends up in the caller
+#ifdef _WIN32
+#define FORCE_INLINE __forceinline
+#else
+#define FORCE_INLINE inline __attribute__((always_inline))
+#endif
@@ -4,6 +4,9 @@
 
 void Logger::Log(const std::string& log)
 {
+    if (_muted)
+        return;
+
     std::cout << log << '\n';
 }
 
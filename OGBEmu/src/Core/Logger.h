@@ -8,7 +8,15 @@ class Logger
 public:
     static void Log(const std::string& log);
     static void DebugBreakLog(const std::string& log);
+
+    // Drops every log while set, for tools that run the emulator in tight loops
+    static void SetMuted(const bool muted) { _muted = muted; }
+    [[nodiscard]] static bool IsMuted() { return _muted; }
+
+private:
+    static inline bool _muted = false;
 };
 
-#define LOG(A) Logger::Log((std::stringstream() << A).str())  // NOLINT(bugprone-macro-parentheses)
-#define DEBUGBREAKLOG(A) Logger::DebugBreakLog((std::stringstream() << A).str())  // NOLINT(bugprone-macro-parentheses)
+// Muted logs aren't even formatted, some are hit for every byte of a memory dump
+#define LOG(A) do { if (!Logger::IsMuted()) Logger::Log((std::stringstream() << A).str()); } while (false)  // NOLINT(bugprone-macro-parentheses)
+#define DEBUGBREAKLOG(A) do { if (!Logger::IsMuted()) Logger::DebugBreakLog((std::stringstream() << A).str()); } while (false)  // NOLINT(bugprone-macro-parentheses)
@@ -1,5 +1,6 @@
 #include "Utils.h"
 
+#include <charconv>
 #include <fstream>
 
 #include "Logger.h"
@@ -21,3 +22,24 @@ std::vector<byte> Utils::ReadBinaryFile(const std::string& filePath)
 
     return {std::istreambuf_iterator(file), {}};
 }
+
+bool Utils::WriteBinaryFile(const std::string& filePath, const std::vector<byte>& bytes)
+{
+    std::ofstream file(filePath, std::ofstream::binary);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+    if (!file.good())
+    {
+        LOG("Error writing file " << filePath);
+        return false;
+    }
+
+    return true;
+}
+
+bool Utils::ParseUnsigned(const std::string& text, unsigned int& value)
+{
+    const char* end = text.data() + text.size();
+    const auto [parsedEnd, error] = std::from_chars(text.data(), end, value);
+    return error == std::errc() && parsedEnd == end;
+}
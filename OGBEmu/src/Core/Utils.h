@@ -8,5 +8,8 @@
 namespace Utils
 {
     std::vector<byte> ReadBinaryFile(const std::string& filePath);
+    bool WriteBinaryFile(const std::string& filePath, const std::vector<byte>& bytes);
+    // False unless the whole text is a decimal number that fits
+    bool ParseUnsigned(const std::string& text, unsigned int& value);
     inline bool IsPowerOfTwo(const unsigned int value) { return value != 0 && (value & value - 1) == 0; }
 };
@@ -0,0 +1,269 @@
+#include "Apu.h"
+
+#include <algorithm>
+
+#include "Emulator/Cpu.h"
+#include "Emulator/Scheduler.h"
+#include "Emulator/Audio/BaseAudioSink.h"
+#include "Emulator/Memory/AddressConstants.h"
+
+namespace
+{
+    // Frame sequencer runs at 512 Hz, clocking length counters, sweep and envelopes
+    constexpr unsigned int FrameSequencerPeriod = Cpu::CpuClock / 512;
+
+    // Frames run a little past their length when they end in the middle of an instruction
+    constexpr unsigned int FrameSampleMargin = 8;
+
+    // Scale applied to a channel's 4-bit output times the 3-bit master volume, four channels must fit in 16 bits
+    constexpr int AmplitudeUnit = 64;
+
+    constexpr word Nr50 = 0x14;
+    constexpr word Nr51 = 0x15;
+    constexpr word Nr52 = 0x16;
+    constexpr word WaveRam = 0x20;
+
+    // Bits that always read back as 1, write-only registers read as 0xFF
+    constexpr byte ReadMasks[] =
+    {
+        0x80, 0x3F, 0x00, 0xFF, 0xBF,
+        0xFF, 0x3F, 0x00, 0xFF, 0xBF,
+        0x7F, 0xFF, 0x9F, 0xFF, 0xBF,
+        0xFF, 0xFF, 0x00, 0x00, 0xBF,
+        0x00, 0x00, 0x70,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    };
+}
+
+Apu::Apu(Scheduler* scheduler) : _scheduler(scheduler),
+                                 _left(Cpu::CpuClock, SampleRate, 0),
+                                 _right(Cpu::CpuClock, SampleRate, 0),
+                                 _registers(AddressConstants::EndApuAddress - AddressConstants::StartApuAddress + 1),
+                                 _square1(&_left, &_right, true),
+                                 _square2(&_left, &_right, false),
+                                 _wave(&_left, &_right, &_registers[WaveRam]),
+                                 _noise(&_left, &_right),
+                                 _nextFrameSequencerCycle(FrameSequencerPeriod)
+{
+}
+
+byte Apu::Read(const word busAddress)
+{
+    const word internalAddress = TranslateAddress(busAddress);
+
+    if (internalAddress >= WaveRam)
+        return _registers[internalAddress];
+
+    if (internalAddress == Nr52)
+    {
+        // Length counters may have silenced channels since the last access
+        Sync();
+        return ReadMasks[Nr52] | _powered << 7 | _noise.IsEnabled() << 3 | _wave.IsEnabled() << 2 |
+            _square2.IsEnabled() << 1 | _square1.IsEnabled();
+    }
+
+    return _registers[internalAddress] | ReadMasks[internalAddress];
+}
+
+void Apu::Write(const word busAddress, const byte data)
+{
+    const word internalAddress = TranslateAddress(busAddress);
+
+    if (internalAddress >= WaveRam)
+    {
+        Sync();
+        _registers[internalAddress] = data;
+        return;
+    }
+
+    if (!_powered && internalAddress != Nr52)
+        return;
+
+    Sync();
+    const unsigned int time = GetFrameTime(_lastCycle);
+    _registers[internalAddress] = data;
+
+    if (internalAddress < Nr50)
+        return WriteChannel(internalAddress, data, time);
+    if (internalAddress == Nr50 || internalAddress == Nr51)
+        return UpdatePanning(time);
+    if (internalAddress == Nr52)
+        return SetPower(data & 0b10000000, time);
+}
+
+void Apu::SetFramesPerSecond(const unsigned int framesPerSecond)
+{
+    const unsigned int samplesPerFrame = SampleRate / framesPerSecond;
+    const unsigned int maxSamplesPerFrame = samplesPerFrame + samplesPerFrame / FrameSampleMargin + 1;
+
+    _left = BlipBuffer(Cpu::CpuClock, SampleRate, maxSamplesPerFrame);
+    _right = BlipBuffer(Cpu::CpuClock, SampleRate, maxSamplesPerFrame);
+    _samples.assign(static_cast<size_t>(maxSamplesPerFrame) * 2, 0);
+}
+
+void Apu::EndFrame()
+{
+    Sync();
+
+    const unsigned int frameDuration = GetFrameTime(_lastCycle);
+    _left.EndFrame(frameDuration);
+    _right.EndFrame(frameDuration);
+    _frameStartCycle = _lastCycle;
+
+    if (_muted)
+    {
+        _left.Clear();
+        _right.Clear();
+        return;
+    }
+
+    const unsigned int frameCount = _left.GetSamplesAvailable();
+    _left.ReadSamples(&_samples[0], frameCount, 2);
+    _right.ReadSamples(&_samples[1], frameCount, 2);
+
+    if (_sink)
+        _sink->WriteSamples(_samples.data(), frameCount);
+}
+
+void Apu::SetDoubleSpeed(const bool isDoubleSpeed)
+{
+    // Everything up to now ran at the previous speed
+    Sync();
+    _clock.SetDoubleSpeed(_scheduler->GetCurrentCycle(), isDoubleSpeed);
+}
+
+void Apu::CopyStateFrom(const Apu& other)
+{
+    Scheduler* scheduler = _scheduler;
+    BaseAudioSink* sink = _sink;
+    const bool muted = _muted;
+
+    *this = other;
+
+    _scheduler = scheduler;
+    _sink = sink;
+    // The channels were copied along, still playing into the other APU's buffers and muted like it
+    _square1.SetOutputs(&_left, &_right);
+    _square2.SetOutputs(&_left, &_right);
+    _wave.SetOutputs(&_left, &_right);
+    _noise.SetOutputs(&_left, &_right);
+    _wave.SetWaveRam(&_registers[WaveRam]);
+    SetMuted(muted);
+}
+
+void Apu::SetMuted(const bool muted)
+{
+    _muted = muted;
+    _square1.SetMuted(muted);
+    _square2.SetMuted(muted);
+    _wave.SetMuted(muted);
+    _noise.SetMuted(muted);
+}
+
+void Apu::Sync()
+{
+    const unsigned long long currentCycle = GetCurrentCycle();
+
+    while (_lastCycle < currentCycle)
+    {
+        const unsigned long long targetCycle = std::min(currentCycle, _nextFrameSequencerCycle);
+
+        RunChannels(GetFrameTime(_lastCycle), GetFrameTime(targetCycle));
+        _lastCycle = targetCycle;
+
+        if (targetCycle == _nextFrameSequencerCycle)
+        {
+            ClockFrameSequencer(GetFrameTime(targetCycle));
+            _nextFrameSequencerCycle += FrameSequencerPeriod;
+        }
+    }
+}
+
+unsigned long long Apu::GetCurrentCycle() const
+{
+    return _clock.FromCpuCycle(_scheduler->GetCurrentCycle());
+}
+
+void Apu::WriteChannel(const word internalAddress, const byte data, const unsigned int time)
+{
+    if (internalAddress < 0x05)
+        return _square1.Write(static_cast<byte>(internalAddress), data, time);
+    if (internalAddress < 0x0A)
+        return _square2.Write(static_cast<byte>(internalAddress - 0x05), data, time);
+    if (internalAddress < 0x0F)
+        return _wave.Write(static_cast<byte>(internalAddress - 0x0A), data, time);
+    _noise.Write(static_cast<byte>(internalAddress - 0x0F), data, time);
+}
+
+void Apu::RunChannels(const unsigned int startTime, const unsigned int endTime)
+{
+    _square1.Run(startTime, endTime);
+    _square2.Run(startTime, endTime);
+    _wave.Run(startTime, endTime);
+    _noise.Run(startTime, endTime);
+}
+
+void Apu::ClockFrameSequencer(const unsigned int time)
+{
+    const byte step = _frameSequencerStep;
+    _frameSequencerStep = (_frameSequencerStep + 1) & 0b111;
+
+    if (!_powered)
+        return;
+
+    if (step % 2 == 0)
+    {
+        _square1.ClockLength(time);
+        _square2.ClockLength(time);
+        _wave.ClockLength(time);
+        _noise.ClockLength(time);
+    }
+
+    if (step == 2 || step == 6)
+        _square1.ClockSweep(time);
+
+    if (step == 7)
+    {
+        _square1.ClockEnvelope(time);
+        _square2.ClockEnvelope(time);
+        _noise.ClockEnvelope(time);
+    }
+}
+
+void Apu::UpdatePanning(const unsigned int time)
+{
+    const byte masterVolume = _registers[Nr50];
+    const byte panning = _registers[Nr51];
+    const int leftVolume = ((masterVolume >> 4 & 0b111) + 1) * AmplitudeUnit;
+    const int rightVolume = ((masterVolume & 0b111) + 1) * AmplitudeUnit;
+
+    _square1.SetPanning(time, panning & 0b00010000 ? leftVolume : 0, panning & 0b00000001 ? rightVolume : 0);
+    _square2.SetPanning(time, panning & 0b00100000 ? leftVolume : 0, panning & 0b00000010 ? rightVolume : 0);
+    _wave.SetPanning(time, panning & 0b01000000 ? leftVolume : 0, panning & 0b00000100 ? rightVolume : 0);
+    _noise.SetPanning(time, panning & 0b10000000 ? leftVolume : 0, panning & 0b00001000 ? rightVolume : 0);
+}
+
+void Apu::SetPower(const bool powered, const unsigned int time)
+{
+    if (powered == _powered)
+        return;
+
+    _powered = powered;
+
+    if (powered)
+    {
+        _frameSequencerStep = 0;
+        return;
+    }
+
+    // Powering off clears every register except wave RAM
+    std::fill(_registers.begin(), _registers.begin() + Nr52, 0);
+    for (word internalAddress = 0; internalAddress < Nr50; internalAddress++)
+        WriteChannel(internalAddress, 0, time);
+    UpdatePanning(time);
+}
+
+word Apu::TranslateAddress(const word busAddress)
+{
+    return busAddress - AddressConstants::StartApuAddress;
+}
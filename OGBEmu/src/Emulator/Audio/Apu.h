@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+
+#include "Core/Definitions.h"
+
+#include "Emulator/NormalSpeedClock.h"
+
+#include "Emulator/Audio/BlipBuffer.h"
+#include "Emulator/Audio/NoiseChannel.h"
+#include "Emulator/Audio/SquareChannel.h"
+#include "Emulator/Audio/WaveChannel.h"
+
+class BaseAudioSink;
+class Scheduler;
+
+// The APU is emulated lazily: channels only run when one of their registers is accessed or when the audio frame
+// ends, catching up to the current cycle in a single call. Output goes through band-limited synthesis buffers that
+// are resampled to SampleRate once per frame.
+class Apu
+{
+public:
+    explicit Apu(Scheduler* scheduler);
+
+    [[nodiscard]] byte Read(word busAddress);
+    void Write(word busAddress, byte data);
+
+    // Sizes the buffers for a frame, they are kept small so devices are quick to create. Must be set before the first
+    // frame.
+    void SetFramesPerSecond(unsigned int framesPerSecond);
+    void EndFrame();
+    // The APU keeps running at normal speed, so it only advances one cycle every two CPU cycles in double speed
+    void SetDoubleSpeed(bool isDoubleSpeed);
+    void SetSink(BaseAudioSink* sink) { _sink = sink; }
+    // Muted frames still run the channels, waveform positions included, but don't synthesize anything, so the sink
+    // gets nothing. Unmuting can click once.
+    void SetMuted(bool muted);
+    // The sink and muting stay this APU's own
+    void CopyStateFrom(const Apu& other);
+
+    static constexpr unsigned int SampleRate = 48000;
+
+private:
+    void Sync();
+    void WriteChannel(word internalAddress, byte data, unsigned int time);
+    void RunChannels(unsigned int startTime, unsigned int endTime);
+    void ClockFrameSequencer(unsigned int time);
+    void UpdatePanning(unsigned int time);
+    void SetPower(bool powered, unsigned int time);
+    [[nodiscard]] unsigned long long GetCurrentCycle() const;
+    [[nodiscard]] unsigned int GetFrameTime(const unsigned long long cycle) const { return static_cast<unsigned int>(cycle - _frameStartCycle); }
+    static word TranslateAddress(word busAddress);
+
+    Scheduler* _scheduler;
+    BaseAudioSink* _sink = nullptr;
+
+    BlipBuffer _left;
+    BlipBuffer _right;
+    std::vector<byte> _registers;
+    std::vector<short> _samples;
+
+    SquareChannel _square1;
+    SquareChannel _square2;
+    WaveChannel _wave;
+    NoiseChannel _noise;
+
+    bool _muted = false;
+    bool _powered = false;
+    byte _frameSequencerStep = 0;
+    unsigned long long _lastCycle = 0;
+    unsigned long long _frameStartCycle = 0;
+    unsigned long long _nextFrameSequencerCycle;
+    NormalSpeedClock _clock;
+};
@@ -0,0 +1,10 @@
+#pragma once
+
+class BaseAudioSink
+{
+public:
+    virtual ~BaseAudioSink() = default;
+
+    // Samples are interleaved 16-bit stereo (left, right)
+    virtual void WriteSamples(const short* samples, unsigned int frameCount) = 0;
+};
@@ -0,0 +1,128 @@
+#include "BlipBuffer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace
+{
+    constexpr double Pi = 3.14159265358979323846;
+    constexpr double KernelCutoff = 0.94;
+    constexpr int IntegrationSteps = 64;
+
+    double BandLimitedImpulse(const double x)
+    {
+        if (std::abs(x) >= BlipBuffer::KernelHalfWidth)
+            return 0;
+
+        const double window = 0.42 + 0.5 * std::cos(Pi * x / BlipBuffer::KernelHalfWidth) + 0.08 * std::cos(2 * Pi * x / BlipBuffer::KernelHalfWidth);
+        const double angle = Pi * x * KernelCutoff;
+        const double sinc = angle == 0 ? 1. : std::sin(angle) / angle;
+
+        return KernelCutoff * sinc * window;
+    }
+
+    // kernel[phase][tap] holds the difference between consecutive samples of a band-limited step that starts
+    // phase / Phases of a sample after the first tap's center. Each phase sums to exactly 1 << deltaBits.
+    std::array<std::array<int, BlipBuffer::KernelWidth>, BlipBuffer::Phases> BuildKernel(const int deltaBits)
+    {
+        std::array<std::array<int, BlipBuffer::KernelWidth>, BlipBuffer::Phases> kernel{};
+
+        for (int phase = 0; phase < BlipBuffer::Phases; phase++)
+        {
+            const double fraction = static_cast<double>(phase) / BlipBuffer::Phases;
+            double taps[BlipBuffer::KernelWidth];
+            double total = 0;
+
+            for (int tap = 0; tap < BlipBuffer::KernelWidth; tap++)
+            {
+                const double end = tap - (BlipBuffer::KernelHalfWidth - 1) - fraction;
+                const double start = end - 1;
+
+                double area = 0;
+                for (int step = 0; step < IntegrationSteps; step++)
+                    area += BandLimitedImpulse(start + (step + 0.5) / IntegrationSteps);
+
+                taps[tap] = area / IntegrationSteps;
+                total += taps[tap];
+            }
+
+            int sum = 0;
+            for (int tap = 0; tap < BlipBuffer::KernelWidth; tap++)
+            {
+                kernel[phase][tap] = static_cast<int>(std::lround(taps[tap] / total * (1 << deltaBits)));
+                sum += kernel[phase][tap];
+            }
+
+            // Fold the rounding error into the center tap so a step always settles on its exact amplitude
+            kernel[phase][BlipBuffer::KernelHalfWidth - 1] += (1 << deltaBits) - sum;
+        }
+
+        return kernel;
+    }
+}
+
+BlipBuffer::BlipBuffer(const double clockRate, const double sampleRate, const unsigned int maxSamplesPerFrame) :
+    _buffer(maxSamplesPerFrame + KernelWidth),
+    _factor(static_cast<unsigned long long>(sampleRate / clockRate * static_cast<double>(1ull << TimeBits)))
+{
+}
+
+void BlipBuffer::AddDelta(const unsigned int clockTime, const int delta)
+{
+    static const auto kernel = BuildKernel(DeltaBits);
+
+    const unsigned long long fixedTime = _offset + clockTime * _factor;
+    const unsigned int index = static_cast<unsigned int>(fixedTime >> TimeBits);
+    const unsigned int phase = static_cast<unsigned int>(fixedTime >> (TimeBits - PhaseBits)) & (Phases - 1);
+
+    if (index + KernelWidth > _buffer.size())
+        return;
+
+    int* out = &_buffer[index];
+    const std::array<int, KernelWidth>& taps = kernel[phase];
+    for (int tap = 0; tap < KernelWidth; tap++)
+        out[tap] += taps[tap] * delta;
+}
+
+void BlipBuffer::EndFrame(const unsigned int clockDuration)
+{
+    _offset += clockDuration * _factor;
+
+    const unsigned int maxSamples = static_cast<unsigned int>(_buffer.size()) - KernelWidth;
+    _samplesAvailable = std::min(static_cast<unsigned int>(_offset >> TimeBits), maxSamples);
+}
+
+unsigned int BlipBuffer::ReadSamples(short* samples, const unsigned int count, const unsigned int stride)
+{
+    const unsigned int samplesRead = std::min(count, _samplesAvailable);
+
+    int integrator = _integrator;
+    for (unsigned int i = 0; i < samplesRead; i++)
+    {
+        integrator += _buffer[i];
+        const int sample = std::clamp(integrator >> DeltaBits, -32768, 32767);
+        samples[i * stride] = static_cast<short>(sample);
+
+        // Slowly leak the integrator to remove the DC offset of the unipolar channel outputs
+        integrator -= sample << (DeltaBits - BassShift);
+    }
+    _integrator = integrator;
+
+    // Keep the kernel tails of the unread part of the buffer
+    std::move(_buffer.begin() + samplesRead, _buffer.begin() + _samplesAvailable + KernelWidth, _buffer.begin());
+    std::fill(_buffer.begin() + _samplesAvailable + KernelWidth - samplesRead, _buffer.begin() + _samplesAvailable + KernelWidth, 0);
+
+    _samplesAvailable -= samplesRead;
+    _offset -= static_cast<unsigned long long>(samplesRead) << TimeBits;
+
+    return samplesRead;
+}
+
+void BlipBuffer::Clear()
+{
+    std::fill(_buffer.begin(), _buffer.end(), 0);
+    _offset = 0;
+    _samplesAvailable = 0;
+    _integrator = 0;
+}
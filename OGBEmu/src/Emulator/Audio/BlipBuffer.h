@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+
+// Band-limited step synthesis buffer, based on the ideas of blargg's Blip_Buffer (http://www.slack.net/~ant/).
+// Amplitude changes are added as deltas at clock times, filtered through a windowed-sinc step kernel and resampled
+// to the output rate when a frame is ended.
+class BlipBuffer
+{
+public:
+    BlipBuffer(double clockRate, double sampleRate, unsigned int maxSamplesPerFrame);
+
+    void AddDelta(unsigned int clockTime, int delta);
+    void EndFrame(unsigned int clockDuration);
+    [[nodiscard]] unsigned int GetSamplesAvailable() const { return _samplesAvailable; }
+    unsigned int ReadSamples(short* samples, unsigned int count, unsigned int stride);
+    void Clear();
+
+    static constexpr int KernelHalfWidth = 8;
+    static constexpr int KernelWidth = KernelHalfWidth * 2;
+    static constexpr int PhaseBits = 5;
+    static constexpr int Phases = 1 << PhaseBits;
+
+private:
+    static constexpr int TimeBits = 32;
+    static constexpr int DeltaBits = 15;
+    static constexpr int BassShift = 9;
+
+    std::vector<int> _buffer;
+    unsigned long long _factor;
+    unsigned long long _offset = 0;
+    unsigned int _samplesAvailable = 0;
+    int _integrator = 0;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Core/Definitions.h"
+
+// Volume envelope shared by the square and noise channels (NRx2)
+class Envelope
+{
+public:
+    void Write(const byte data)
+    {
+        _initialVolume = data >> 4;
+        _increase = data & 0b00001000;
+        _period = data & 0b00000111;
+    }
+
+    void Trigger()
+    {
+        _volume = _initialVolume;
+        _timer = _period;
+    }
+
+    // Returns true if the volume changed
+    bool Clock()
+    {
+        if (_period == 0 || --_timer != 0)
+            return false;
+
+        _timer = _period;
+
+        if (_increase && _volume < 15)
+        {
+            _volume++;
+            return true;
+        }
+        if (!_increase && _volume > 0)
+        {
+            _volume--;
+            return true;
+        }
+
+        return false;
+    }
+
+    [[nodiscard]] int GetVolume() const { return _volume; }
+    [[nodiscard]] static bool IsDacEnabled(const byte data) { return data & 0b11111000; }
+
+private:
+    byte _initialVolume = 0;
+    bool _increase = false;
+    byte _period = 0;
+    byte _timer = 0;
+    int _volume = 0;
+};
@@ -0,0 +1,91 @@
+#include "NoiseChannel.h"
+
+NoiseChannel::NoiseChannel(BlipBuffer* left, BlipBuffer* right) : SoundChannel(left, right, 64)
+{
+}
+
+void NoiseChannel::Write(const byte registerIndex, const byte data, const unsigned int time)
+{
+    switch (registerIndex)
+    {
+    case 1:
+        WriteLength(data);
+        return;
+    case 2:
+        _envelope.Write(data);
+        _dacEnabled = Envelope::IsDacEnabled(data);
+        if (!_dacEnabled)
+            Disable(time);
+        return;
+    case 3:
+        _clockShift = data >> 4;
+        _shortMode = data & 0b00001000;
+        _divisorCode = data & 0b111;
+        return;
+    case 4:
+        WriteLengthEnable(data);
+        if (data & 0b10000000)
+            Trigger(time);
+        return;
+    default:
+        return;
+    }
+}
+
+void NoiseChannel::Run(const unsigned int startTime, const unsigned int endTime)
+{
+    unsigned int time = startTime + _timer;
+
+    if (!_enabled || _clockShift > 13)
+    {
+        // Nothing to run: a disabled channel resets the shift register on trigger and big clock shifts stop it
+        _timer = time < endTime ? 0 : time - endTime;
+        return;
+    }
+
+    if (time < endTime)
+    {
+        const unsigned int period = GetPeriod();
+        const int volume = _muted ? 0 : _envelope.GetVolume();
+        word lfsr = _lfsr;
+
+        do
+        {
+            const word feedback = (lfsr ^ lfsr >> 1) & 1;
+            lfsr = static_cast<word>(lfsr >> 1 | feedback << 14);
+            if (_shortMode)
+                lfsr = static_cast<word>((lfsr & ~0x40) | feedback << 6);
+
+            if (volume)
+                SetAmplitude(time, (~lfsr & 1) * volume);
+            time += period;
+        }
+        while (time < endTime);
+
+        _lfsr = lfsr;
+    }
+
+    _timer = time - endTime;
+}
+
+void NoiseChannel::ClockEnvelope(const unsigned int time)
+{
+    if (_envelope.Clock())
+        UpdateAmplitude(time);
+}
+
+void NoiseChannel::Trigger(const unsigned int time)
+{
+    _enabled = _dacEnabled;
+    _timer = GetPeriod();
+    _lfsr = 0x7FFF;
+    TriggerLength();
+    _envelope.Trigger();
+    UpdateAmplitude(time);
+}
+
+void NoiseChannel::UpdateAmplitude(const unsigned int time)
+{
+    const int volume = _enabled ? _envelope.GetVolume() : 0;
+    SetAmplitude(time, (~_lfsr & 1) * volume);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Emulator/Audio/Envelope.h"
+#include "Emulator/Audio/SoundChannel.h"
+
+// Channel 4, pseudo-random output from a 15 or 7-bit linear feedback shift register
+class NoiseChannel final : public SoundChannel
+{
+public:
+    NoiseChannel(BlipBuffer* left, BlipBuffer* right);
+
+    void Write(byte registerIndex, byte data, unsigned int time);
+    void Run(unsigned int startTime, unsigned int endTime);
+    void ClockEnvelope(unsigned int time);
+
+private:
+    void Trigger(unsigned int time);
+    void UpdateAmplitude(unsigned int time);
+    [[nodiscard]] unsigned int GetPeriod() const { return (_divisorCode ? _divisorCode * 16u : 8u) << _clockShift; }
+
+    Envelope _envelope;
+
+    byte _clockShift = 0;
+    byte _divisorCode = 0;
+    bool _shortMode = false;
+    word _lfsr = 0x7FFF;
+    unsigned int _timer = 0;
+};
@@ -0,0 +1,6 @@
+#include "NullAudioSink.h"
+
+void NullAudioSink::WriteSamples(const short* samples, const unsigned int frameCount)
+{
+    _framesWritten += frameCount;
+}
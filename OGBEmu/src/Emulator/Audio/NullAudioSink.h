@@ -0,0 +1,14 @@
+#pragma once
+
+#include "BaseAudioSink.h"
+
+class NullAudioSink final : public BaseAudioSink
+{
+public:
+    void WriteSamples(const short* samples, unsigned int frameCount) override;
+
+    [[nodiscard]] unsigned long long GetFramesWritten() const { return _framesWritten; }
+
+private:
+    unsigned long long _framesWritten = 0;
+};
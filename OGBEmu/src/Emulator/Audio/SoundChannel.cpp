@@ -0,0 +1,62 @@
+#include "SoundChannel.h"
+
+SoundChannel::SoundChannel(BlipBuffer* left, BlipBuffer* right, const unsigned int lengthMax) : _left(left), _right(right),
+                                                                                                _lengthMax(lengthMax)
+{
+}
+
+void SoundChannel::SetPanning(const unsigned int time, const int leftGain, const int rightGain)
+{
+    _leftGain = leftGain;
+    _rightGain = rightGain;
+    UpdateOutput(time);
+}
+
+void SoundChannel::WriteLength(const byte data)
+{
+    _lengthCounter = _lengthMax - (data & (_lengthMax - 1));
+}
+
+void SoundChannel::ClockLength(const unsigned int time)
+{
+    if (!_lengthEnabled || _lengthCounter == 0)
+        return;
+
+    if (--_lengthCounter == 0)
+        Disable(time);
+}
+
+void SoundChannel::Disable(const unsigned int time)
+{
+    _enabled = false;
+    SetAmplitude(time, 0);
+}
+
+void SoundChannel::WriteLengthEnable(const byte data)
+{
+    _lengthEnabled = data & 0b01000000;
+}
+
+void SoundChannel::TriggerLength()
+{
+    if (_lengthCounter == 0)
+        _lengthCounter = _lengthMax;
+}
+
+void SoundChannel::UpdateOutput(const unsigned int time)
+{
+    const int leftOutput = _amplitude * _leftGain;
+    const int rightOutput = _amplitude * _rightGain;
+
+    if (leftOutput != _leftOutput)
+    {
+        _left->AddDelta(time, leftOutput - _leftOutput);
+        _leftOutput = leftOutput;
+    }
+
+    if (rightOutput != _rightOutput)
+    {
+        _right->AddDelta(time, rightOutput - _rightOutput);
+        _rightOutput = rightOutput;
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Core/Definitions.h"
+
+#include "Emulator/Audio/BlipBuffer.h"
+
+// Common state of the four sound channels. Times are in CPU cycles relative to the start of the current audio frame.
+class SoundChannel
+{
+public:
+    SoundChannel(BlipBuffer* left, BlipBuffer* right, unsigned int lengthMax);
+
+    [[nodiscard]] bool IsEnabled() const { return _enabled; }
+    void SetOutputs(BlipBuffer* left, BlipBuffer* right)
+    {
+        _left = left;
+        _right = right;
+    }
+    // Only the waveform position is kept up to date then, the amplitude stays where it was
+    void SetMuted(const bool muted) { _muted = muted; }
+
+    void SetPanning(unsigned int time, int leftGain, int rightGain);
+    void WriteLength(byte data);
+    void ClockLength(unsigned int time);
+    void Disable(unsigned int time);
+
+protected:
+    void WriteLengthEnable(byte data);
+    void TriggerLength();
+
+    void SetAmplitude(const unsigned int time, const int amplitude)
+    {
+        if (amplitude == _amplitude)
+            return;
+
+        _amplitude = amplitude;
+        UpdateOutput(time);
+    }
+
+    void UpdateOutput(unsigned int time);
+
+    BlipBuffer* _left;
+    BlipBuffer* _right;
+
+    bool _enabled = false;
+    bool _dacEnabled = false;
+    bool _muted = false;
+
+private:
+    int _amplitude = 0;
+    int _leftGain = 0;
+    int _rightGain = 0;
+    int _leftOutput = 0;
+    int _rightOutput = 0;
+
+    bool _lengthEnabled = false;
+    unsigned int _lengthCounter = 0;
+    unsigned int _lengthMax;
+};
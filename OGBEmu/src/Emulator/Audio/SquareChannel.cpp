@@ -0,0 +1,141 @@
+#include "SquareChannel.h"
+
+namespace
+{
+    // Bit N is the output of duty step N
+    constexpr byte DutyPatterns[] = {0b10000000, 0b10000001, 0b11100001, 0b01111110};
+}
+
+SquareChannel::SquareChannel(BlipBuffer* left, BlipBuffer* right, const bool hasSweep) : SoundChannel(left, right, 64),
+    _hasSweep(hasSweep)
+{
+}
+
+void SquareChannel::Write(const byte registerIndex, const byte data, const unsigned int time)
+{
+    switch (registerIndex)
+    {
+    case 0:
+        if (!_hasSweep)
+            return;
+        _sweepPeriod = data >> 4 & 0b111;
+        _sweepNegate = data & 0b00001000;
+        _sweepShift = data & 0b111;
+        return;
+    case 1:
+        _duty = data >> 6;
+        WriteLength(data);
+        UpdateAmplitude(time);
+        return;
+    case 2:
+        _envelope.Write(data);
+        _dacEnabled = Envelope::IsDacEnabled(data);
+        if (!_dacEnabled)
+            Disable(time);
+        return;
+    case 3:
+        _frequency = (_frequency & 0x700) | data;
+        return;
+    case 4:
+        _frequency = (_frequency & 0xFF) | (data & 0b111) << 8;
+        WriteLengthEnable(data);
+        if (data & 0b10000000)
+            Trigger(time);
+        return;
+    default:
+        return;
+    }
+}
+
+void SquareChannel::Run(const unsigned int startTime, const unsigned int endTime)
+{
+    unsigned int time = startTime + _timer;
+
+    if (time < endTime)
+    {
+        const unsigned int period = GetPeriod();
+        const int volume = _enabled && !_muted ? _envelope.GetVolume() : 0;
+
+        if (volume == 0)
+        {
+            // Silent, only keep the waveform position in sync
+            const unsigned int steps = (endTime - time - 1) / period + 1;
+            _dutyPosition = (_dutyPosition + steps) & 0b111;
+            time += steps * period;
+        }
+        else
+        {
+            const byte pattern = DutyPatterns[_duty];
+            do
+            {
+                _dutyPosition = (_dutyPosition + 1) & 0b111;
+                SetAmplitude(time, (pattern >> _dutyPosition & 1) * volume);
+                time += period;
+            }
+            while (time < endTime);
+        }
+    }
+
+    _timer = time - endTime;
+}
+
+void SquareChannel::ClockEnvelope(const unsigned int time)
+{
+    if (_envelope.Clock())
+        UpdateAmplitude(time);
+}
+
+void SquareChannel::ClockSweep(const unsigned int time)
+{
+    if (!_hasSweep || --_sweepTimer != 0)
+        return;
+
+    _sweepTimer = _sweepPeriod ? _sweepPeriod : 8;
+
+    if (!_sweepEnabled || !_sweepPeriod)
+        return;
+
+    const int newFrequency = CalculateSweep(time);
+    if (newFrequency <= 2047 && _sweepShift)
+    {
+        _frequency = newFrequency;
+        _sweepShadowFrequency = newFrequency;
+        CalculateSweep(time);
+    }
+}
+
+void SquareChannel::Trigger(const unsigned int time)
+{
+    _enabled = _dacEnabled;
+    _timer = GetPeriod();
+    TriggerLength();
+    _envelope.Trigger();
+
+    if (_hasSweep)
+    {
+        _sweepShadowFrequency = _frequency;
+        _sweepTimer = _sweepPeriod ? _sweepPeriod : 8;
+        _sweepEnabled = _sweepPeriod || _sweepShift;
+        if (_sweepShift)
+            CalculateSweep(time);
+    }
+
+    UpdateAmplitude(time);
+}
+
+void SquareChannel::UpdateAmplitude(const unsigned int time)
+{
+    const int volume = _enabled ? _envelope.GetVolume() : 0;
+    SetAmplitude(time, (DutyPatterns[_duty] >> _dutyPosition & 1) * volume);
+}
+
+int SquareChannel::CalculateSweep(const unsigned int time)
+{
+    const int delta = _sweepShadowFrequency >> _sweepShift;
+    const int newFrequency = _sweepNegate ? _sweepShadowFrequency - delta : _sweepShadowFrequency + delta;
+
+    if (newFrequency > 2047)
+        Disable(time);
+
+    return newFrequency;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Emulator/Audio/Envelope.h"
+#include "Emulator/Audio/SoundChannel.h"
+
+// Channels 1 and 2. Only channel 1 has a frequency sweep unit.
+class SquareChannel final : public SoundChannel
+{
+public:
+    SquareChannel(BlipBuffer* left, BlipBuffer* right, bool hasSweep);
+
+    void Write(byte registerIndex, byte data, unsigned int time);
+    void Run(unsigned int startTime, unsigned int endTime);
+    void ClockEnvelope(unsigned int time);
+    void ClockSweep(unsigned int time);
+
+private:
+    void Trigger(unsigned int time);
+    void UpdateAmplitude(unsigned int time);
+    [[nodiscard]] unsigned int GetPeriod() const { return (2048 - _frequency) * 4; }
+    int CalculateSweep(unsigned int time);
+
+    Envelope _envelope;
+
+    bool _hasSweep;
+    bool _sweepEnabled = false;
+    bool _sweepNegate = false;
+    byte _sweepPeriod = 0;
+    byte _sweepShift = 0;
+    byte _sweepTimer = 0;
+    int _sweepShadowFrequency = 0;
+
+    int _frequency = 0;
+    byte _duty = 0;
+    byte _dutyPosition = 0;
+    unsigned int _timer = 0;
+};
@@ -0,0 +1,66 @@
+#include "WavAudioSink.h"
+
+#include "Core/Logger.h"
+
+namespace
+{
+    constexpr unsigned short Channels = 2;
+    constexpr unsigned short BitsPerSample = 16;
+    constexpr unsigned int HeaderSize = 44;
+
+    void WriteLittleEndian(std::ofstream& file, const unsigned int value, const int size)
+    {
+        for (int i = 0; i < size; i++)
+            file.put(static_cast<char>(value >> (i * 8) & 0xFF));
+    }
+}
+
+WavAudioSink::WavAudioSink(const std::string& filePath, const unsigned int sampleRate) : _file(filePath, std::ofstream::binary),
+                                                                                          _sampleRate(sampleRate)
+{
+    if (!_file.good())
+    {
+        LOG("Error opening WAV file " << filePath);
+        return;
+    }
+
+    WriteHeader();
+}
+
+WavAudioSink::~WavAudioSink()
+{
+    if (!_file.good())
+        return;
+
+    // Patch the chunk sizes now that the amount of data is known
+    _file.seekp(0);
+    WriteHeader();
+}
+
+void WavAudioSink::WriteSamples(const short* samples, const unsigned int frameCount)
+{
+    if (!_file.good())
+        return;
+
+    const unsigned int size = frameCount * Channels * sizeof(short);
+    _file.write(reinterpret_cast<const char*>(samples), size);
+    _dataSize += size;
+}
+
+void WavAudioSink::WriteHeader()
+{
+    constexpr unsigned short blockAlign = Channels * BitsPerSample / 8;
+
+    _file.write("RIFF", 4);
+    WriteLittleEndian(_file, HeaderSize - 8 + _dataSize, 4);
+    _file.write("WAVEfmt ", 8);
+    WriteLittleEndian(_file, 16, 4);
+    WriteLittleEndian(_file, 1, 2);
+    WriteLittleEndian(_file, Channels, 2);
+    WriteLittleEndian(_file, _sampleRate, 4);
+    WriteLittleEndian(_file, _sampleRate * blockAlign, 4);
+    WriteLittleEndian(_file, blockAlign, 2);
+    WriteLittleEndian(_file, BitsPerSample, 2);
+    _file.write("data", 4);
+    WriteLittleEndian(_file, _dataSize, 4);
+}
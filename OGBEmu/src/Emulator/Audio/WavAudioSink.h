@@ -0,0 +1,23 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+
+#include "BaseAudioSink.h"
+
+class WavAudioSink final : public BaseAudioSink
+{
+public:
+    WavAudioSink(const std::string& filePath, unsigned int sampleRate);
+    ~WavAudioSink() override;
+
+    [[nodiscard]] bool IsValid() const { return _file.good(); }
+    void WriteSamples(const short* samples, unsigned int frameCount) override;
+
+private:
+    void WriteHeader();
+
+    std::ofstream _file;
+    unsigned int _sampleRate;
+    unsigned int _dataSize = 0;
+};
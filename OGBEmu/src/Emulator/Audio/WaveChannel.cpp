@@ -0,0 +1,85 @@
+#include "WaveChannel.h"
+
+namespace
+{
+    // NR32 output level 0 (mute), 100%, 50% and 25%
+    constexpr byte VolumeShifts[] = {4, 0, 1, 2};
+}
+
+WaveChannel::WaveChannel(BlipBuffer* left, BlipBuffer* right, const byte* waveRam) : SoundChannel(left, right, 256),
+    _waveRam(waveRam)
+{
+}
+
+void WaveChannel::Write(const byte registerIndex, const byte data, const unsigned int time)
+{
+    switch (registerIndex)
+    {
+    case 0:
+        _dacEnabled = data & 0b10000000;
+        if (!_dacEnabled)
+            Disable(time);
+        return;
+    case 1:
+        WriteLength(data);
+        return;
+    case 2:
+        _volumeShift = VolumeShifts[data >> 5 & 0b11];
+        UpdateAmplitude(time);
+        return;
+    case 3:
+        _frequency = (_frequency & 0x700) | data;
+        return;
+    case 4:
+        _frequency = (_frequency & 0xFF) | (data & 0b111) << 8;
+        WriteLengthEnable(data);
+        if (data & 0b10000000)
+            Trigger(time);
+        return;
+    default:
+        return;
+    }
+}
+
+void WaveChannel::Run(const unsigned int startTime, const unsigned int endTime)
+{
+    unsigned int time = startTime + _timer;
+
+    if (time < endTime)
+    {
+        const unsigned int period = GetPeriod();
+
+        if (!_enabled || _volumeShift == 4 || _muted)
+        {
+            const unsigned int steps = (endTime - time - 1) / period + 1;
+            _position = (_position + steps) & 0b11111;
+            time += steps * period;
+        }
+        else
+        {
+            do
+            {
+                _position = (_position + 1) & 0b11111;
+                SetAmplitude(time, GetSample() >> _volumeShift);
+                time += period;
+            }
+            while (time < endTime);
+        }
+    }
+
+    _timer = time - endTime;
+}
+
+void WaveChannel::Trigger(const unsigned int time)
+{
+    _enabled = _dacEnabled;
+    _timer = GetPeriod();
+    _position = 0;
+    TriggerLength();
+    UpdateAmplitude(time);
+}
+
+void WaveChannel::UpdateAmplitude(const unsigned int time)
+{
+    SetAmplitude(time, _enabled ? GetSample() >> _volumeShift : 0);
+}
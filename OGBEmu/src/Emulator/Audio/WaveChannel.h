@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Emulator/Audio/SoundChannel.h"
+
+// Channel 3, plays the 32 4-bit samples stored in wave RAM
+class WaveChannel final : public SoundChannel
+{
+public:
+    WaveChannel(BlipBuffer* left, BlipBuffer* right, const byte* waveRam);
+
+    void Write(byte registerIndex, byte data, unsigned int time);
+    void Run(unsigned int startTime, unsigned int endTime);
+    void SetWaveRam(const byte* waveRam) { _waveRam = waveRam; }
+
+private:
+    void Trigger(unsigned int time);
+    void UpdateAmplitude(unsigned int time);
+    [[nodiscard]] int GetSample() const { return _waveRam[_position / 2] >> (_position & 1 ? 0 : 4) & 0xF; }
+    [[nodiscard]] unsigned int GetPeriod() const { return (2048 - _frequency) * 2; }
+
+    const byte* _waveRam;
+
+    int _frequency = 0;
+    byte _volumeShift = 4;
+    byte _position = 0;
+    unsigned int _timer = 0;
+};
@@ -4,10 +4,15 @@
 
 #include "Core/Logger.h"
 
+#include "Emulator/GbConstants.h"
+#include "Emulator/Scheduler.h"
+#include "Emulator/Fuzzing/CoverageMap.h"
 #include "Emulator/Memory/AddressConstants.h"
 #include "Emulator/Memory/Bus.h"
+#include "Emulator/Recompiler/RecompiledModule.h"
+#include "Emulator/Trace/InstructionTraceRecorder.h"
 
-Cpu::Cpu(Bus* bus) : _registers(), _registerSp(), _bus(bus), _eiRequested(false)
+Cpu::Cpu(Bus* bus, Scheduler* scheduler) : _registers(), _registerSp(), _bus(bus), _scheduler(scheduler), _eiRequested(false)
 {
     // This is the only hardware initialization needed, everything else is done by the boot rom
     _ime = 0;
@@ -18,30 +23,161 @@ Cpu::Cpu(Bus* bus) : _registers(), _registerSp(), _bus(bus), _eiRequested(false)
     _bus->Write(0xff44, 0x90); // Hack to force boot with no screen
 }
 
-byte Cpu::Update()
+unsigned int Cpu::RunFor(const unsigned int cycleBudget)
 {
-    _cyclesThisInstruction = 0;
-
-    if (_registerPc.reg == 0x100)
+    // The boot ROM ends with the IO write unmapping it, so it's always left at the start of a run
+    if (_registerPc.reg == 0x100) [[unlikely]]
     {
         DEBUGBREAKLOG("Finished boot");
         // Hack to run tests with no screen
         _bus->Write(0xff44, 0xff);
-        _bus->Write(0xff02, 0xff);
     }
 
-    if (!_halted)
+    // Events and input may have requested interrupts since the last run
+    _interruptCheckPending = true;
+    _runEndRequested = false;
+    _tracedPage = NoTracedPage;
+
+    return _traceRecorder ? RunLoop<true>(cycleBudget) : RunLoop<false>(cycleBudget);
+}
+
+template <bool IsTraced>
+unsigned int Cpu::RunLoop(const unsigned int cycleBudget)
+{
+    unsigned int cycles = 0;
+
+    // Instructions run on a local copy. Nothing else can point to it, so the compiler keeps PC, SP and the registers
+    // in host registers across bus accesses instead of reloading them after each one. What isn't inlined into the
+    // loop runs on the members in between.
+    Cpu cpu = *this;
+    Scheduler* scheduler = _scheduler;
+    InstructionTraceRecorder* traceRecorder = _traceRecorder;
+    const bool hasHooks = _coverageMap || _recompiledModule;
+    const bool stopsAtBackwardBranch = _stopsAtBackwardBranch;
+
+    do
     {
-        const Opcode opcode = FetchNextOpcode();
-        ExecuteOpcode(opcode);
+        cpu._cyclesThisInstruction = 0;
+        cpu._backwardBranchTaken = false;
+
+        if constexpr (IsTraced)
+        {
+            InstructionTrace::Record record;
+            cpu.TraceInstruction(record);
+            traceRecorder->Append(record);
+        }
+
+        if (hasHooks) [[unlikely]]
+        {
+            *this = cpu;
+            RunHookedInstruction(cycles, cycleBudget);
+            cpu = *this;
+        }
+        else if (cpu._halted)
+            cpu._cyclesThisInstruction += 4;
+        else
+            cpu.ExecuteOpcode(cpu.FetchNextOpcode());
+
+        if (cpu._interruptCheckPending)
+        {
+            *this = cpu;
+            UpdateIme();
+            HandleInterrupts();
+            // EI takes effect after the next instruction
+            _interruptCheckPending = _eiRequested;
+            cpu = *this;
+        }
+
+        cycles += cpu._cyclesThisInstruction;
+        scheduler->Advance(cpu._cyclesThisInstruction);
     }
-    else
+    while (cycles < cycleBudget && !scheduler->HasPendingEvent() && !cpu._runEndRequested && !cpu._halted &&
+        !(cpu._backwardBranchTaken && stopsAtBackwardBranch));
+
+    *this = cpu;
+    return cycles;
+}
+
+void Cpu::RunHookedInstruction(unsigned int& cycles, const unsigned int cycleBudget)
+{
+    if (_halted)
         _cyclesThisInstruction += 4;
+    else if (_coverageMap)
+    {
+        RecordCoverage();
+        ExecuteOpcode(FetchNextOpcode());
+    }
+    else if (_traceRecorder || !RunRecompiledBlock(cycles, cycleBudget))
+        ExecuteOpcode(FetchNextOpcode());
+}
+
+void Cpu::TraceInstruction(InstructionTrace::Record& record)
+{
+    record.cycle = _scheduler->GetCurrentCycle();
+    record.state = {static_cast<word>(_registers.a << 8 | GetFlags()), _registers.bc.reg, _registers.de.reg, _registers.hl.reg, _registerSp.reg, _registerPc.reg, _ime};
+    record.isHalted = _halted;
+
+    // The encoder keeps only the bytes of the instruction, so three are always copied, from the page's memory when
+    // they don't cross its end
+    const word pc = _registerPc.reg;
+    if (pc >> 8 != _tracedPage) [[unlikely]]
+    {
+        _tracedPage = pc >> 8;
+        _tracedPageCode = _bus->GetReadPointer(pc & 0xFF00);
+    }
+
+    if (_tracedPageCode && (pc & 0xFF) <= 0xFD) [[likely]]
+    {
+        const byte* code = _tracedPageCode + (pc & 0xFF);
+        record.instruction = {code[0], code[1], code[2]};
+    }
+    else
+        record.instruction = {_bus->Read(pc), _bus->Read(static_cast<word>(pc + 1)), _bus->Read(static_cast<word>(pc + 2))};
+}
+
+bool Cpu::IsWaitingForInterrupt() const
+{
+    return _halted && !(_bus->Read(AddressConstants::StartIeAddress) & _bus->Read(AddressConstants::InterruptFlag));
+}
+
+CpuState Cpu::GetState() const
+{
+    return {static_cast<word>(_registers.a << 8 | GetFlags()), _registers.bc.reg, _registers.de.reg, _registers.hl.reg, _registerSp.reg, _registerPc.reg, _ime};
+}
 
-    UpdateIme();
-    HandleInterrupts();
+void Cpu::SetState(const CpuState& state)
+{
+    _registers.a = static_cast<byte>(state.af >> 8);
+    // The low nibble of F doesn't exist
+    _registers.f.reg = state.af & 0xF0;
+    _flagsOperation = FlagsOperation::None;
+    _registers.bc.reg = state.bc;
+    _registers.de.reg = state.de;
+    _registers.hl.reg = state.hl;
+    _registerSp.reg = state.sp;
+    _registerPc.reg = state.pc;
+    _ime = state.ime;
+    _halted = 0;
+    _eiRequested = false;
+}
 
-    return _cyclesThisInstruction;
+void Cpu::CopyStateFrom(const Cpu& other)
+{
+    Bus* bus = _bus;
+    Scheduler* scheduler = _scheduler;
+    const RecompiledModule* recompiledModule = _recompiledModule;
+    const byte* romData = _romData;
+    CoverageMap* coverageMap = _coverageMap;
+    InstructionTraceRecorder* traceRecorder = _traceRecorder;
+
+    *this = other;
+
+    _bus = bus;
+    _scheduler = scheduler;
+    _recompiledModule = recompiledModule;
+    _romData = romData;
+    _coverageMap = coverageMap;
+    _traceRecorder = traceRecorder;
 }
 
 Opcode Cpu::FetchNextOpcode()
@@ -52,6 +188,17 @@ Opcode Cpu::FetchNextOpcode()
     return opcode;
 }
 
+void Cpu::RecordCoverage() const
+{
+    if (_registerPc.reg > AddressConstants::EndRomBankNAddress)
+        return _coverageMap->RecordRam(_registerPc.reg);
+
+    // Null or outside the cartridge ROM while the boot ROM runs
+    const byte* code = _bus->GetReadPointer(_registerPc.reg);
+    if (code >= _romData && code < _romData + _coverageMap->GetRomSize())
+        _coverageMap->RecordRom(static_cast<size_t>(code - _romData));
+}
+
 void Cpu::UpdateIme()
 {
     // Since EI needs to wait one instruction to be effective, we check if the previous instruction WASN't an EI (which means we're in the next instruction) to finalize it.
@@ -119,6 +266,7 @@ void Cpu::HandleInterrupts()
     }
 
     _cyclesThisInstruction += 4;
+    _backwardBranchTaken = false;
     WriteBus(AddressConstants::InterruptFlag, interruptFlag ^ handledInterrupt); // "Acknowledge" the interrupt by zeroing its bit
     Call(jumpAddress);
 }
@@ -143,11 +291,32 @@ void Cpu::WriteBus(const word address, const byte data)
 {
     _cyclesThisInstruction += 4;
     _bus->Write(address, data);
+
+    if (address >= AddressConstants::StartIoRegistersAddress) [[unlikely]]
+        OnHighWrite(address);
+    // The MBC registers can switch the banks under the traced page
+    else if (address <= AddressConstants::EndRomBankNAddress) [[unlikely]]
+        _tracedPage = NoTracedPage;
 }
 
-void Cpu::WriteAtSp(const byte data) const
+void Cpu::WriteAtSp(const byte data)
 {
     _bus->Write(_registerSp.reg, data);
+
+    if (_registerSp.reg >= AddressConstants::StartIoRegistersAddress) [[unlikely]]
+        OnHighWrite(_registerSp.reg);
+    else if (_registerSp.reg <= AddressConstants::EndRomBankNAddress) [[unlikely]]
+        _tracedPage = NoTracedPage;
+}
+
+void Cpu::OnHighWrite(const word address)
+{
+    // IO writes can request interrupts or make the device stall the CPU, HRAM ones are plain memory
+    if (address <= AddressConstants::EndIoRegistersAddress || address == AddressConstants::StartIeAddress)
+    {
+        _interruptCheckPending = true;
+        _runEndRequested = true;
+    }
 }
 
 word Cpu::ReadImm16AtPc()
@@ -165,6 +334,113 @@ void Cpu::ExecuteOpcode(const Opcode opcode)
     return ExecuteLowFunction(opcode);
 }
 
+bool Cpu::EndInstructionInRun(unsigned int& cycles, const unsigned int cycleBudget)
+{
+    const unsigned int instructionCycles = _cyclesThisInstruction;
+    if (_interruptCheckPending || _runEndRequested || cycles + instructionCycles >= cycleBudget ||
+        _scheduler->GetCurrentCycle() + instructionCycles >= _scheduler->GetNextEventCycle() ||
+        (_backwardBranchTaken && _stopsAtBackwardBranch))
+        return false;
+
+    cycles += instructionCycles;
+    _scheduler->Advance(instructionCycles);
+    _cyclesThisInstruction = 0;
+    _backwardBranchTaken = false;
+    return true;
+}
+
+bool Cpu::RunRecompiledBlock(unsigned int& cycles, const unsigned int cycleBudget)
+{
+    if (!_recompiledModule || _registerPc.reg > AddressConstants::EndRomBankNAddress)
+        return false;
+
+    // The boot ROM and the cartridge RAM aren't translated
+    const byte* code = _bus->GetReadPointer(_registerPc.reg);
+    if (!code)
+        return false;
+
+    const RecompiledCode::Entry* entry = _recompiledModule->Find(static_cast<unsigned int>(code - _romData), _registerPc.reg);
+    if (!entry)
+        return false;
+
+    // Translated code keeps the flags in F
+    MaterializeFlags();
+
+    RecompiledCode::Context context{};
+    RecompiledCode::State& state = context.state;
+    state.a = _registers.a;
+    state.f = _registers.f.reg;
+    state.b = _registers.b;
+    state.c = _registers.c;
+    state.d = _registers.d;
+    state.e = _registers.e;
+    state.h = _registers.h;
+    state.l = _registers.l;
+    state.sp = _registerSp.reg;
+    state.pc = _registerPc.reg;
+    state.backwardBranchEnd = _backwardBranchEnd;
+    context.host = this;
+    context.runCycles = cycles;
+    context.cycleBudget = cycleBudget;
+    context.read = ReadRecompiled;
+    context.write = WriteRecompiled;
+    context.endInstruction = EndRecompiledInstruction;
+
+    entry->block(&context, entry->index);
+
+    // The last instruction is ended by the run loop
+    _registers.a = state.a;
+    _registers.f.reg = state.f;
+    _registers.b = state.b;
+    _registers.c = state.c;
+    _registers.d = state.d;
+    _registers.e = state.e;
+    _registers.h = state.h;
+    _registers.l = state.l;
+    _registerSp.reg = state.sp;
+    _registerPc.reg = state.pc;
+    _cyclesThisInstruction = static_cast<byte>(state.cycles);
+    _backwardBranchTaken = state.backwardBranchTaken;
+    _backwardBranchEnd = state.backwardBranchEnd;
+    cycles = context.runCycles;
+    return true;
+}
+
+byte Cpu::ReadRecompiled(RecompiledCode::Context* context, const word address)
+{
+    return static_cast<Cpu*>(context->host)->_bus->Read(address);
+}
+
+void Cpu::WriteRecompiled(RecompiledCode::Context* context, const word address, const byte data)
+{
+    Cpu* cpu = static_cast<Cpu*>(context->host);
+    cpu->_bus->Write(address, data);
+
+    if (address >= AddressConstants::StartIoRegistersAddress) [[unlikely]]
+        cpu->OnHighWrite(address);
+    // Bank switches can map other code where the block goes on
+    else if (address <= AddressConstants::EndRomBankNAddress) [[unlikely]]
+        context->romWritten = true;
+}
+
+bool Cpu::EndRecompiledInstruction(RecompiledCode::Context* context)
+{
+    Cpu* cpu = static_cast<Cpu*>(context->host);
+    RecompiledCode::State& state = context->state;
+    if (context->romWritten)
+        return false;
+
+    cpu->_cyclesThisInstruction = static_cast<byte>(state.cycles);
+    cpu->_backwardBranchTaken = state.backwardBranchTaken;
+    cpu->_registerPc.reg = state.pc;
+    if (!cpu->EndInstructionInRun(context->runCycles, context->cycleBudget))
+        return false;
+
+    state.cycles = 0;
+    state.backwardBranchTaken = false;
+    return true;
+}
+
 void Cpu::ExecuteHighFunction(const Opcode opcode)
 {
     if (opcode.row5 > 07 && opcode.row5 < 020)
@@ -252,7 +528,7 @@ void Cpu::ExecuteLowFunction(const Opcode opcode)
             return Jr(static_cast<signed_byte>(ReadAtPcInc()));
         if (opcode.row5 > 03 && opcode.row5 < 010)
         {
-            const byte flag = opcode.row5 < 06 ? _registers.f.z : _registers.f.c;
+            const byte flag = opcode.row5 < 06 ? GetFlagZ() : GetFlagC();
             const byte test = opcode.column == 0 ? !flag : flag;
             
             return JrTest(test, static_cast<signed_byte>(ReadAtPcInc()));
@@ -260,7 +536,7 @@ void Cpu::ExecuteLowFunction(const Opcode opcode)
 
         if (opcode.row5 > 027 && opcode.row5 < 034)
         {
-            const byte flag = opcode.row5 < 032 ? _registers.f.z : _registers.f.c;
+            const byte flag = opcode.row5 < 032 ? GetFlagZ() : GetFlagC();
             const byte test = opcode.column == 0 ? !flag : flag;
 
             _cyclesThisInstruction += 4;
@@ -332,7 +608,7 @@ void Cpu::ExecuteLowFunction(const Opcode opcode)
 
         if (opcode.row5 > 027 && opcode.row5 < 034)
         {
-            const byte flag = opcode.row5 < 032 ? _registers.f.z : _registers.f.c;
+            const byte flag = opcode.row5 < 032 ? GetFlagZ() : GetFlagC();
             const byte test = opcode.column == 0x2 ? !flag : flag;
             
             return JpTest(test, ReadImm16AtPc());
@@ -379,8 +655,8 @@ void Cpu::ExecuteLowFunction(const Opcode opcode)
 
         if (opcode.row5 > 027 && opcode.row5 < 034)
         {
-            const byte flag = opcode.row5 < 032 ? _registers.f.z : _registers.f.c;
-            const byte test = opcode.column == 0 ? !flag : flag;
+            const byte flag = opcode.row5 < 032 ? GetFlagZ() : GetFlagC();
+            const byte test = opcode.column == 0x4 ? !flag : flag;
             
             return CallTest(test, ReadImm16AtPc());
         }
@@ -398,6 +674,9 @@ void Cpu::ExecuteLowFunction(const Opcode opcode)
     {
         if (opcode.high > 0xB)
         {
+            if (opcode.high == 0xF)
+                MaterializeFlags();
+
             _cyclesThisInstruction += 4;
             return Push(_registers.registers16[opcode.high - 0xC]);
         }
@@ -513,6 +792,8 @@ void Cpu::ExecuteLowFunction(const Opcode opcode)
     }
 
     DEBUGBREAKLOG("Column function Op Code not found. Opcode: " << std::format("{:x}", opcode.code));
+    if (!_fault.IsSet())
+        _fault = {FaultType::InvalidOpcode, static_cast<word>(_registerPc.reg - 1), opcode.code};
 }
 
 void Cpu::ExecutePrefix()
@@ -604,6 +885,7 @@ void Cpu::LdImmTaSp()
 
 void Cpu::LdHlSpE8()
 {
+    _flagsOperation = FlagsOperation::None;
     _registers.f.z = 0;
     _registers.f.n = 0;
 
@@ -620,96 +902,58 @@ void Cpu::LdHlSpE8()
 void Cpu::Halt()
 {
     _halted = 1;
+    _interruptCheckPending = true;
 }
 
 void Cpu::Add(const byte val)
 {
-    const int diff = _registers.a + val;
-
-    _registers.f.n = 0;
-    _registers.f.h = (_registers.a & 0xF) + (val & 0xf) >= 0x10;
-    _registers.f.c = diff >= 0x100;
-
-    _registers.a = static_cast<byte>(diff);
-    
-    _registers.f.z = !_registers.a;
+    const int result = _registers.a + val;
+    SetFlags(FlagsOperation::Add, result, _registers.a ^ val);
+    _registers.a = static_cast<byte>(result);
 }
 
 void Cpu::Adc(const byte val)
 {
-    const int diff = _registers.a + val + _registers.f.c;
-
-    _registers.f.n = 0;
-    _registers.f.h = (_registers.a & 0xF) + (val & 0xf) + _registers.f.c >= 0x10;
-    _registers.f.c = diff >= 0x100;
-
-    _registers.a = static_cast<byte>(diff);
-    
-    _registers.f.z = !_registers.a;
+    const int result = _registers.a + val + GetFlagC();
+    SetFlags(FlagsOperation::Add, result, _registers.a ^ val);
+    _registers.a = static_cast<byte>(result);
 }
 
 void Cpu::Sub(const byte val)
 {
-    const int diff = _registers.a - val;
-
-    _registers.f.n = 1;
-    _registers.f.h = (_registers.a & 0xF) - (val & 0xf) < 0;
-    _registers.f.c = diff < 0;
-
-    _registers.a = static_cast<byte>(diff);
-    
-    _registers.f.z = !_registers.a;
+    const int result = _registers.a - val;
+    SetFlags(FlagsOperation::Sub, result, _registers.a ^ val);
+    _registers.a = static_cast<byte>(result);
 }
 
 void Cpu::Sbc(const byte val)
 {
-    const int diff = _registers.a - val - _registers.f.c;
-
-    _registers.f.n = 1;
-    _registers.f.h = (_registers.a & 0xF) - (val & 0xf) - _registers.f.c < 0;
-    _registers.f.c = diff < 0;
-
-    _registers.a = static_cast<byte>(diff);
-    
-    _registers.f.z = !_registers.a;
+    const int result = _registers.a - val - GetFlagC();
+    SetFlags(FlagsOperation::Sub, result, _registers.a ^ val);
+    _registers.a = static_cast<byte>(result);
 }
 
 void Cpu::And(const byte val)
 {
     _registers.a &= val;
-
-    _registers.f.z = !_registers.a;
-    _registers.f.n = 0;
-    _registers.f.h = 1;
-    _registers.f.c = 0;
+    SetFlags(FlagsOperation::And, _registers.a);
 }
 
 void Cpu::Xor(const byte val)
 {
     _registers.a ^= val;
-
-    _registers.f.reg = 0;
-    _registers.f.z = !_registers.a;
+    SetFlags(FlagsOperation::Or, _registers.a);
 }
 
 void Cpu::Or(const byte val)
 {
     _registers.a |= val;
-
-    _registers.f.z = !_registers.a;
-    _registers.f.n = 0;
-    _registers.f.h = 0;
-    _registers.f.c = 0;
+    SetFlags(FlagsOperation::Or, _registers.a);
 }
 
 void Cpu::Cp(const byte val)
 {
-    const int diff = _registers.a - val;
-
-    _registers.f.n = 1;
-    _registers.f.z = !(diff & 0xff);
-    _registers.f.h = (_registers.a & 0xF) - (val & 0xf) < 0;
-    _registers.f.c = diff < 0;
+    SetFlags(FlagsOperation::Sub, _registers.a - val, _registers.a ^ val);
 }
 
 void Cpu::Nop()
@@ -718,14 +962,25 @@ void Cpu::Nop()
 
 void Cpu::Stop()
 {
-    DEBUGBREAKLOG("Executing STOP");
     _registerPc.reg++;
+
+    // A CGB with a speed switch requested switches instead of stopping, KEY1 reads 0 on the DMG
+    if (_bus->Read(AddressConstants::Key1) & GbConstants::Key1SwitchRequest)
+    {
+        _speedSwitchRequested = true;
+        _runEndRequested = true;
+        return;
+    }
+
+    DEBUGBREAKLOG("Executing STOP");
 }
 
 void Cpu::Jr(const signed_byte offset)
 {
     const word newPc = _registerPc.reg + static_cast<word>(offset);
 
+    _backwardBranchTaken = offset < 0;
+    _backwardBranchEnd = _registerPc.reg;
     _registerPc.reg = newPc;
     _cyclesThisInstruction += 4;
 }
@@ -755,6 +1010,7 @@ void Cpu::AddSp()
 {
     const signed_byte e8 = static_cast<signed_byte>(ReadAtPcInc());
 
+    _flagsOperation = FlagsOperation::None;
     _registers.f.z = 0;
     _registers.f.n = 0;
     _registers.f.c = (e8 & 0xff) + (_registerSp.reg & 0xFF) >= 0x100;
@@ -766,6 +1022,8 @@ void Cpu::AddSp()
 
 void Cpu::Jp(const word address)
 {
+    _backwardBranchTaken = address < _registerPc.reg;
+    _backwardBranchEnd = _registerPc.reg;
     _registerPc.reg = address;
     _cyclesThisInstruction += 4;
 }
@@ -785,12 +1043,8 @@ void Cpu::JpHl()
 
 void Cpu::Inc8(byte& target)
 {
-    const byte prev = target;
     target++;
-
-    _registers.f.z = target == 0;
-    _registers.f.n = 0;
-    _registers.f.h = (prev & 0xF) == 0xF;
+    SetFlagsKeepCarry(FlagsOperation::Inc, target);
 }
 
 void Cpu::Inc8Add(const word address)
@@ -814,6 +1068,7 @@ void Cpu::Di()
 void Cpu::Ei()
 {
     _eiRequested = true;
+    _interruptCheckPending = true;
 }
 
 void Cpu::Call(const word address)
@@ -832,12 +1087,8 @@ void Cpu::CallTest(const byte test, const word address)
 
 void Cpu::Dec8(byte& target)
 {
-    const int diff = target - 1;
-    
-    _registers.f.h = (target & 0xF) == 0x0;
-    target = static_cast<byte>(diff);
-    _registers.f.n = 1;
-    _registers.f.z = !target;
+    target--;
+    SetFlagsKeepCarry(FlagsOperation::Dec, target);
 }
 
 void Cpu::Dec8Add(word address)
@@ -872,7 +1123,10 @@ void Cpu::Pop(Register16& register16Target)
     register16Target.lo = ReadAtSp();
 
     if (&register16Target.reg == &_registers.af.reg)
+    {
         _registers.f.nu = 0; // If we're writing to the AF register, need to guarantee that the lower 4 bits stay 0
+        _flagsOperation = FlagsOperation::None;
+    }
 
     Inc16(_registerSp.reg);
     register16Target.hi = ReadAtSp();
@@ -882,17 +1136,19 @@ void Cpu::Pop(Register16& register16Target)
 void Cpu::Rlca()
 {
     Rlc(_registers.a);
-    _registers.f.z = 0;
+    _flagsOperation = FlagsOperation::RotateAccumulator;
 }
 
 void Cpu::Rla()
 {
     Rl(_registers.a);
-    _registers.f.z = 0;
+    _flagsOperation = FlagsOperation::RotateAccumulator;
 }
 
 void Cpu::Daa()
 {
+    MaterializeFlags();
+
     if (_registers.f.n)
     {
         if (_registers.f.h)
@@ -929,6 +1185,7 @@ void Cpu::Daa()
 
 void Cpu::Scf()
 {
+    MaterializeFlags();
     _registers.f.c = 1;
     _registers.f.h = 0;
     _registers.f.n = 0;
@@ -942,23 +1199,25 @@ void Cpu::Rst(const word address)
 void Cpu::Reti()
 {
     _ime = 1;
+    _interruptCheckPending = true;
     Ret();
 }
 
 void Cpu::Rrca()
 {
     Rrc(_registers.a);
-    _registers.f.z = 0;
+    _flagsOperation = FlagsOperation::RotateAccumulator;
 }
 
 void Cpu::Rra()
 {
     Rr(_registers.a);
-    _registers.f.z = 0;
+    _flagsOperation = FlagsOperation::RotateAccumulator;
 }
 
 void Cpu::Cpl()
 {
+    MaterializeFlags();
     _registers.a ^= 0xFF;
     _registers.f.h = 1;
     _registers.f.n = 1;
@@ -966,6 +1225,7 @@ void Cpu::Cpl()
 
 void Cpu::Ccf()
 {
+    MaterializeFlags();
     _registers.f.c ^= 1;
     _registers.f.h = 0;
     _registers.f.n = 0;
@@ -975,10 +1235,8 @@ void Cpu::Rlc(byte& reg)
 {
     reg = static_cast<byte>(reg << 1 | reg >> 7);
 
-    _registers.f.c = reg & 1;
-    _registers.f.z = !reg;
-    _registers.f.h = 0;
-    _registers.f.n = 0;
+    _flagsCarry = reg & 1;
+    SetFlags(FlagsOperation::Rotate, reg);
 }
 
 void Cpu::Rrc(byte& reg)
@@ -986,79 +1244,149 @@ void Cpu::Rrc(byte& reg)
     const int low = reg & 1;
     reg = static_cast<byte>(reg >> 1 | low << 7);
 
-    _registers.f.c = static_cast<byte>(low);
-    _registers.f.z = !reg;
-    _registers.f.h = 0;
-    _registers.f.n = 0;
+    _flagsCarry = static_cast<byte>(low);
+    SetFlags(FlagsOperation::Rotate, reg);
 }
 
 void Cpu::Rl(byte& reg)
 {
-    const int wide = reg << 1 | _registers.f.c;
+    const int wide = reg << 1 | GetFlagC();
     reg = static_cast<byte>(wide);
 
-    _registers.f.c = static_cast<byte>(wide >> 8);
-    _registers.f.z = !reg;
-    _registers.f.h = 0;
-    _registers.f.n = 0;
+    _flagsCarry = static_cast<byte>(wide >> 8);
+    SetFlags(FlagsOperation::Rotate, reg);
 }
 
 void Cpu::Rr(byte& reg)
 {
     const int low = reg & 1;
-    reg = static_cast<byte>(reg >> 1 | _registers.f.c << 7);
+    reg = static_cast<byte>(reg >> 1 | GetFlagC() << 7);
 
-    _registers.f.c = static_cast<byte>(low);
-    _registers.f.z = !reg;
-    _registers.f.h = 0;
-    _registers.f.n = 0;
+    _flagsCarry = static_cast<byte>(low);
+    SetFlags(FlagsOperation::Rotate, reg);
 }
 
 void Cpu::Sla(byte& reg)
 {
     reg <<= 1;
     
-    _registers.f.c = reg >> 7;
-    _registers.f.z = !reg;
-    _registers.f.h = 0;
-    _registers.f.n = 0;
+    _flagsCarry = reg >> 7;
+    SetFlags(FlagsOperation::Rotate, reg);
 }
 
 void Cpu::Sra(byte& reg)
 {
     reg = static_cast<byte>(static_cast<signed_byte>(reg) >> 1);
     
-    _registers.f.c = reg & 1;
-    _registers.f.z = !reg;
-    _registers.f.h = 0;
-    _registers.f.n = 0;
+    _flagsCarry = reg & 1;
+    SetFlags(FlagsOperation::Rotate, reg);
 }
 
 void Cpu::Swap(byte& reg)
 {
     reg = static_cast<byte>(reg << 4 | reg >> 4);
 
-    _registers.f.c = 0;
-    _registers.f.z = !reg;
-    _registers.f.h = 0;
-    _registers.f.n = 0;
+    _flagsCarry = 0;
+    SetFlags(FlagsOperation::Rotate, reg);
 }
 
 void Cpu::Srl(byte& reg)
 {
     reg >>= 1;
 
-    _registers.f.c = reg & 1;
-    _registers.f.z = !reg;
-    _registers.f.h = 0;
-    _registers.f.n = 0;
+    _flagsCarry = reg & 1;
+    SetFlags(FlagsOperation::Rotate, reg);
 }
 
 void Cpu::Bit(const byte testBit, const byte testR8)
 {
-    _registers.f.z = !(1 << testBit & testR8);
-    _registers.f.n = 0;
-    _registers.f.h = 1;
+    SetFlagsKeepCarry(FlagsOperation::Bit, 1 << testBit & testR8);
+}
+
+void Cpu::SetFlags(const FlagsOperation operation, const int result, const byte operands)
+{
+    _flagsOperation = operation;
+    _flagsResult = result;
+    _flagsOperands = operands;
+}
+
+void Cpu::SetFlagsKeepCarry(const FlagsOperation operation, const int result)
+{
+    _flagsCarry = GetFlagC();
+    _flagsOperation = operation;
+    _flagsResult = result;
+}
+
+byte Cpu::GetFlagZ() const
+{
+    switch (_flagsOperation)
+    {
+    case FlagsOperation::None:
+        return _registers.f.z;
+    case FlagsOperation::RotateAccumulator:
+        return 0;
+    default:
+        return !(_flagsResult & 0xFF);
+    }
+}
+
+byte Cpu::GetFlagC() const
+{
+    switch (_flagsOperation)
+    {
+    case FlagsOperation::None:
+        return _registers.f.c;
+    case FlagsOperation::Add:
+    case FlagsOperation::Sub:
+        return _flagsResult >> 8 & 1;
+    case FlagsOperation::And:
+    case FlagsOperation::Or:
+        return 0;
+    default:
+        return _flagsCarry;
+    }
+}
+
+byte Cpu::GetFlags() const
+{
+    if (_flagsOperation == FlagsOperation::None)
+        return _registers.f.reg;
+
+    RegisterF flags{};
+    flags.z = GetFlagZ();
+    flags.c = GetFlagC();
+
+    switch (_flagsOperation)
+    {
+    case FlagsOperation::Add:
+        flags.h = (_flagsOperands ^ _flagsResult) >> 4 & 1;
+        break;
+    case FlagsOperation::Sub:
+        flags.n = 1;
+        flags.h = (_flagsOperands ^ _flagsResult) >> 4 & 1;
+        break;
+    case FlagsOperation::And:
+    case FlagsOperation::Bit:
+        flags.h = 1;
+        break;
+    case FlagsOperation::Inc:
+        flags.h = (_flagsResult & 0xF) == 0x0;
+        break;
+    case FlagsOperation::Dec:
+        flags.n = 1;
+        flags.h = (_flagsResult & 0xF) == 0xF;
+        break;
+    default:
+        break;
+    }
+
+    return flags.reg;
+}
+
+void Cpu::MaterializeFlags()
+{
+    _registers.f.reg = GetFlags();
+    _flagsOperation = FlagsOperation::None;
 }
 
 void Cpu::Res(const byte testBit, byte& testR8)
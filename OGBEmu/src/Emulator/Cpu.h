@@ -2,103 +2,216 @@
 
 #include "Core/Definitions.h"
 
+#include "Emulator/Fault.h"
 #include "Emulator/Opcode.h"
 
 class Bus;
+class CoverageMap;
+class InstructionTraceRecorder;
+class RecompiledModule;
+class Scheduler;
+
+namespace InstructionTrace
+{
+    struct Record;
+}
+
+namespace RecompiledCode
+{
+    struct Context;
+}
+
+struct CpuState
+{
+    word af;
+    word bc;
+    word de;
+    word hl;
+    word sp;
+    word pc;
+    byte ime;
+
+    bool operator==(const CpuState& other) const = default;
+};
 
 class Cpu
 {
 public:
-    explicit Cpu(Bus* bus);
+    Cpu(Bus* bus, Scheduler* scheduler);
 
-    byte Update();
+    // Runs instructions, advancing the scheduler after each one, until the budget is used or something the device
+    // has to handle happens: a pending event, a halt, a speed switch, a write to the IO registers or, when enabled, a
+    // backward branch. Always runs at least one instruction, returns the cycles it took.
+    unsigned int RunFor(unsigned int cycleBudget);
+    // Idle loop detection needs to see every backward branch
+    void SetStopsAtBackwardBranch(const bool stopsAtBackwardBranch) { _stopsAtBackwardBranch = stopsAtBackwardBranch; }
+    // Instructions the module translated run from it when the cartridge maps them, the module must outlive the runs.
+    // Offsets into the cartridge ROM are how its blocks are found.
+    void SetRecompiledModule(const RecompiledModule* recompiledModule, const byte* romData)
+    {
+        _recompiledModule = recompiledModule;
+        _romData = romData;
+    }
+    // Records the address of each instruction before running it, with recompiled blocks left out
+    // so none is missed. The map must outlive the runs, the ROM data is the cartridge's.
+    void SetCoverageMap(CoverageMap* coverageMap, const byte* romData)
+    {
+        _coverageMap = coverageMap;
+        _romData = romData;
+    }
+
+    // Appends a record before each instruction, halted ones included, which then run interpreted. The recorder must
+    // outlive the runs.
+    void SetTraceRecorder(InstructionTraceRecorder* traceRecorder) { _traceRecorder = traceRecorder; }
+
+    [[nodiscard]] bool IsHalted() const { return _halted; }
+    // Halted with no enabled interrupt requested, only a change to IF can wake the CPU up
+    [[nodiscard]] bool IsWaitingForInterrupt() const;
+    // Whether the last update ended with a jump to a lower address, which is how every loop closes
+    [[nodiscard]] bool HasTakenBackwardBranch() const { return _backwardBranchTaken; }
+    // Address right after the last backward branch instruction
+    [[nodiscard]] word GetBackwardBranchEnd() const { return _backwardBranchEnd; }
+    [[nodiscard]] CpuState GetState() const;
+    void SetState(const CpuState& state);
+    // Everything SetState leaves out too, like pending interrupt checks and lazily computed flags. The recompiled
+    // module, the coverage map and the trace recorder stay this CPU's own.
+    void CopyStateFrom(const Cpu& other);
+    // Set by STOP when KEY1 requested a speed switch, the device performs it
+    [[nodiscard]] bool IsSpeedSwitchRequested() const { return _speedSwitchRequested; }
+    void ClearSpeedSwitchRequest() { _speedSwitchRequested = false; }
+    // The first invalid opcode run since the fault was last cleared
+    [[nodiscard]] const Fault& GetFault() const { return _fault; }
+    void ClearFault() { _fault = {}; }
 
     static constexpr unsigned int CpuClock = 4194304;
 
 private:
     union Register16;
+
+    // Past the last 256 byte page
+    static constexpr unsigned int NoTracedPage = 0x100;
+
+    // Operation that last set the flags, which are only derived from its result when something reads them
+    enum class FlagsOperation : byte
+    {
+        None,
+        Add,
+        Sub,
+        And,
+        Or,
+        Inc,
+        Dec,
+        Rotate,
+        RotateAccumulator,
+        Bit
+    };
     
-    Opcode FetchNextOpcode();
+    // The untraced loop is built without the recorder, which the traced one inlines
+    template <bool IsTraced>
+    unsigned int RunLoop(unsigned int cycleBudget);
+    // The coverage map or the recompiled module sees the next instruction first
+    void RunHookedInstruction(unsigned int& cycles, unsigned int cycleBudget);
+    void RecordCoverage() const;
     void UpdateIme();
     void HandleInterrupts();
 
-    [[nodiscard]] byte ReadAtPcInc();
-    [[nodiscard]] byte ReadBus(word address);
-    [[nodiscard]] byte ReadAtSp() const;
-    void WriteBus(word address, byte data);
-    void WriteAtSp(byte data) const;
-    inline word ReadImm16AtPc();
+    // Everything the run loop reaches is inlined into it, a call would let its local copy escape to memory
+    FORCE_INLINE Opcode FetchNextOpcode();
+    FORCE_INLINE void TraceInstruction(InstructionTrace::Record& record);
+
+    [[nodiscard]] FORCE_INLINE byte ReadAtPcInc();
+    [[nodiscard]] FORCE_INLINE byte ReadBus(word address);
+    [[nodiscard]] FORCE_INLINE byte ReadAtSp() const;
+    FORCE_INLINE void WriteBus(word address, byte data);
+    FORCE_INLINE void WriteAtSp(byte data);
+    FORCE_INLINE void OnHighWrite(word address);
+    FORCE_INLINE word ReadImm16AtPc();
 
-    void ExecuteOpcode(Opcode opcode);
-    void ExecuteHighFunction(Opcode opcode);
-    void ExecuteLowFunction(Opcode opcode);
-    void ExecutePrefix();
+    FORCE_INLINE void ExecuteOpcode(Opcode opcode);
+    // Ends the instruction and goes on when the run loop would have gone straight to the next one, so instructions run
+    // without it keep the exact timing of separate ones
+    [[nodiscard]] bool EndInstructionInRun(unsigned int& cycles, unsigned int cycleBudget);
+    // Runs the recompiled block covering PC, returns false when there is none
+    bool RunRecompiledBlock(unsigned int& cycles, unsigned int cycleBudget);
+    static byte ReadRecompiled(RecompiledCode::Context* context, word address);
+    static void WriteRecompiled(RecompiledCode::Context* context, word address, byte data);
+    static bool EndRecompiledInstruction(RecompiledCode::Context* context);
+    FORCE_INLINE void ExecuteHighFunction(Opcode opcode);
+    FORCE_INLINE void ExecuteLowFunction(Opcode opcode);
+    FORCE_INLINE void ExecutePrefix();
 
     // Most ALU instructions were based on https://github.com/mgba-emu/mgba/blob/master/src/sm83/isa-sm83.c
-    void Ld8R(byte targetIndex, byte sourceIndex);
-    void Ld8Imm(byte targetIndex);
-    void Ld8TaImm(word address);
-    void Ld8Sa(byte targetIndex, word sourceAddress);
-    void Ld8Ta(word targetAddress, byte sourceIndex);
-    void Ld16Imm(byte targetIndex);
-    void LdSpTImm();
-    void LdSpS(word val);
-    void LdImmTaSp();
-    void LdHlSpE8();
-    void Halt();
-    void Add(byte val);
-    void Adc(byte val);
-    void Sub(byte val);
-    void Sbc(byte val);
-    void And(byte val);
-    void Xor(byte val);
-    void Or(byte val);
-    void Cp(byte val);
-    static void Nop();
-    void Stop();
-    void Jr(signed_byte offset);
-    void JrTest(byte test, signed_byte offset);
-    void Ret();
-    void RetTest(byte test);
-    void AddSp();
-    void Jp(word address);
-    void JpTest(byte test, word address);
-    void JpHl();
-    void Inc8(byte& target);
-    void Inc8Add(word address);
-    void Inc16(word& target);
-    void Di();
-    void Ei();
-    void Call(word address);
-    void CallTest(byte test, word address);
-    void Dec8(byte& target);
-    void Dec8Add(word address);
-    void Dec16(word& target);
-    void Add16(word& target);
-    void Push(Register16 register16Data);
-    void Pop(Register16& register16Target);
-    void Rlca();
-    void Rla();
-    void Daa();
-    void Scf();
-    void Rst(word address);
-    void Reti();
-    void Rrca();
-    void Rra();
-    void Cpl();
-    void Ccf();
-    void Rlc(byte& reg);
-    void Rrc(byte& reg);
-    void Rl(byte& reg);
-    void Rr(byte& reg);
-    void Sla(byte& reg);
-    void Sra(byte& reg);
-    void Swap(byte& reg);
-    void Srl(byte& reg);
-    void Bit(byte testBit, byte testR8);
-    static void Res(byte testBit, byte& testR8);
-    static void Set(byte testBit, byte& testR8);
+    FORCE_INLINE void Ld8R(byte targetIndex, byte sourceIndex);
+    FORCE_INLINE void Ld8Imm(byte targetIndex);
+    FORCE_INLINE void Ld8TaImm(word address);
+    FORCE_INLINE void Ld8Sa(byte targetIndex, word sourceAddress);
+    FORCE_INLINE void Ld8Ta(word targetAddress, byte sourceIndex);
+    FORCE_INLINE void Ld16Imm(byte targetIndex);
+    FORCE_INLINE void LdSpTImm();
+    FORCE_INLINE void LdSpS(word val);
+    FORCE_INLINE void LdImmTaSp();
+    FORCE_INLINE void LdHlSpE8();
+    FORCE_INLINE void Halt();
+    FORCE_INLINE void Add(byte val);
+    FORCE_INLINE void Adc(byte val);
+    FORCE_INLINE void Sub(byte val);
+    FORCE_INLINE void Sbc(byte val);
+    FORCE_INLINE void And(byte val);
+    FORCE_INLINE void Xor(byte val);
+    FORCE_INLINE void Or(byte val);
+    FORCE_INLINE void Cp(byte val);
+    static FORCE_INLINE void Nop();
+    FORCE_INLINE void Stop();
+    FORCE_INLINE void Jr(signed_byte offset);
+    FORCE_INLINE void JrTest(byte test, signed_byte offset);
+    FORCE_INLINE void Ret();
+    FORCE_INLINE void RetTest(byte test);
+    FORCE_INLINE void AddSp();
+    FORCE_INLINE void Jp(word address);
+    FORCE_INLINE void JpTest(byte test, word address);
+    FORCE_INLINE void JpHl();
+    FORCE_INLINE void Inc8(byte& target);
+    FORCE_INLINE void Inc8Add(word address);
+    FORCE_INLINE void Inc16(word& target);
+    FORCE_INLINE void Di();
+    FORCE_INLINE void Ei();
+    FORCE_INLINE void Call(word address);
+    FORCE_INLINE void CallTest(byte test, word address);
+    FORCE_INLINE void Dec8(byte& target);
+    FORCE_INLINE void Dec8Add(word address);
+    FORCE_INLINE void Dec16(word& target);
+    FORCE_INLINE void Add16(word& target);
+    FORCE_INLINE void Push(Register16 register16Data);
+    FORCE_INLINE void Pop(Register16& register16Target);
+    FORCE_INLINE void Rlca();
+    FORCE_INLINE void Rla();
+    FORCE_INLINE void Daa();
+    FORCE_INLINE void Scf();
+    FORCE_INLINE void Rst(word address);
+    FORCE_INLINE void Reti();
+    FORCE_INLINE void Rrca();
+    FORCE_INLINE void Rra();
+    FORCE_INLINE void Cpl();
+    FORCE_INLINE void Ccf();
+    FORCE_INLINE void Rlc(byte& reg);
+    FORCE_INLINE void Rrc(byte& reg);
+    FORCE_INLINE void Rl(byte& reg);
+    FORCE_INLINE void Rr(byte& reg);
+    FORCE_INLINE void Sla(byte& reg);
+    FORCE_INLINE void Sra(byte& reg);
+    FORCE_INLINE void Swap(byte& reg);
+    FORCE_INLINE void Srl(byte& reg);
+    FORCE_INLINE void Bit(byte testBit, byte testR8);
+    static FORCE_INLINE void Res(byte testBit, byte& testR8);
+    static FORCE_INLINE void Set(byte testBit, byte& testR8);
     
+    FORCE_INLINE void SetFlags(FlagsOperation operation, int result, byte operands = 0);
+    FORCE_INLINE void SetFlagsKeepCarry(FlagsOperation operation, int result);
+    [[nodiscard]] FORCE_INLINE byte GetFlagZ() const;
+    [[nodiscard]] FORCE_INLINE byte GetFlagC() const;
+    [[nodiscard]] FORCE_INLINE byte GetFlags() const;
+    FORCE_INLINE void MaterializeFlags();
+
     static byte ConvertReg8Index(const byte opcodeRegIndex)
     {
         return opcodeRegIndex == 0x7 ? opcodeRegIndex : opcodeRegIndex / 2 * 2 + !(opcodeRegIndex % 2);
@@ -161,9 +274,36 @@ private:
     Register16 _registerPc;
 
     Bus* _bus;
+    Scheduler* _scheduler;
+    const RecompiledModule* _recompiledModule = nullptr;
+    const byte* _romData = nullptr;
+    CoverageMap* _coverageMap = nullptr;
+    InstructionTraceRecorder* _traceRecorder = nullptr;
+    // The host memory of the 256 byte page of the last traced instruction, null when the bus doesn't map plain memory
+    // there. Banks only switch through IO writes, which end the run, and through the MBC registers, so it's dropped at
+    // the start of each run and by cartridge writes.
+    unsigned int _tracedPage = NoTracedPage;
+    const byte* _tracedPageCode = nullptr;
+
+    // Z is derived from the low byte of the result and C from bit 8, so add and subtract results are kept unwrapped.
+    // H only needs the operands' xor, the carry into bit 4 being (lhs ^ rhs ^ result) & 0x10. _flagsCarry holds C for
+    // the operations that don't compute it from the result.
+    FlagsOperation _flagsOperation = FlagsOperation::None;
+    int _flagsResult = 0;
+    byte _flagsOperands = 0;
+    byte _flagsCarry = 0;
 
     byte _cyclesThisInstruction = 0;
     byte _ime;
     byte _halted;
     bool _eiRequested;
+    // IE, IF and IME only change through the instructions setting this, and through events and input between runs.
+    // Interrupts are checked after every instruction while it's set.
+    bool _interruptCheckPending = true;
+    bool _runEndRequested = false;
+    bool _stopsAtBackwardBranch = false;
+    bool _backwardBranchTaken = false;
+    word _backwardBranchEnd = 0;
+    bool _speedSwitchRequested = false;
+    Fault _fault;
 };
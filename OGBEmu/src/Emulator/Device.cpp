@@ -1,20 +1,43 @@
 #include "Device.h"
 
+#include <algorithm>
 #include <chrono>
 
 #include "Core/Logger.h"
 #include "Core/Utils.h"
 
+#include "Emulator/GbConstants.h"
+#include "Emulator/PostBootState.h"
+#include "Emulator/ScreenSampler.h"
+#include "Emulator/Input/InputMoviePlayer.h"
+#include "Emulator/Input/InputMovieRecorder.h"
+#include "Emulator/Memory/AddressConstants.h"
+#include "Emulator/Recompiler/RecompiledModule.h"
+#include "Emulator/Trace/GoldenLogComparer.h"
+
 namespace
 {
     constexpr unsigned char DefaultSimulationFramesPerSecond = 64;
 }
 
-Device::Device(const std::vector<byte>& bootRomBytes, const std::vector<byte>& cartridgeBytes, const int framesPerSecond) : _bootRom(bootRomBytes),
-                                                                                                                            _cartridge(cartridgeBytes),
-                                                                                                                            _bus(Bus(&_bootRom, &_cartridge, &_vRam, &_wRam, &_wRamCgb, &_echoRam, &_oam, &_ioRegisters, &_hRam)),
-                                                                                                                            _cpu(&_bus),
-                                                                                                                            _framesPerSecond(framesPerSecond)
+Device::Device(const std::vector<byte>& bootRomBytes, const std::vector<byte>& cartridgeBytes, const int framesPerSecond) :
+    Device(bootRomBytes, std::make_shared<const std::vector<byte>>(cartridgeBytes), framesPerSecond)
+{
+}
+
+Device::Device(const std::vector<byte>& bootRomBytes, std::shared_ptr<const std::vector<byte>> cartridgeBytes, const int framesPerSecond) : _bootRom(bootRomBytes),
+                                                                                                                            _cartridge(std::move(cartridgeBytes)),
+                                                                                                                            _joypad(&_ioRegisters),
+                                                                                                                            _serial(&_scheduler, &_ioRegisters),
+                                                                                                                            _timer(&_scheduler, &_ioRegisters),
+                                                                                                                            _apu(&_scheduler),
+                                                                                                                            _hdma(&_scheduler, &_bus, &_vRam, &_ioRegisters),
+                                                                                                                            _bus(Bus(&_bootRom, &_cartridge, &_vRam, &_wRam, &_wRamCgb, &_oam, &_ioRegisters, &_hRam, &_joypad, &_serial, &_timer, &_apu, &_hdma)),
+                                                                                                                            _cpu(&_bus, &_scheduler),
+                                                                                                                            _idleLoopDetector(&_bus),
+                                                                                                                            _model(_cartridge.IsCgbOnly() ? HardwareModel::Cgb : HardwareModel::Dmg),
+                                                                                                                            _framesPerSecond(framesPerSecond),
+                                                                                                                            _skipsBootRom(bootRomBytes.empty())
 {
     if (!Utils::IsPowerOfTwo(_framesPerSecond))
     {
@@ -24,15 +47,126 @@ Device::Device(const std::vector<byte>& bootRomBytes, const std::vector<byte>& c
     }
 
     _frameTimeSeconds = 1. / _framesPerSecond;
+    _apu.SetFramesPerSecond(_framesPerSecond);
     _maxCyclesPerFrame = Cpu::CpuClock * _frameTimeSeconds;
+    _bus.SetCgbMode(_model == HardwareModel::Cgb);
+    _cpu.SetStopsAtBackwardBranch(_idleLoopDetector.IsEnabled());
+
+    if (_skipsBootRom && _cartridge.IsValid())
+        SkipBootRom();
 }
 
 bool Device::IsValid() const
 {
-    return _bootRom.IsValid() && _cartridge.IsValid();
+    return (_skipsBootRom || _bootRom.IsValid()) && _cartridge.IsValid();
+}
+
+void Device::SkipBootRom()
+{
+    for (const PostBootState::IoRegisterValue& ioRegister : PostBootState::GetIoRegisters(_model))
+        _bus.Write(ioRegister.address, ioRegister.value);
+
+    _timer.SetSystemCounter(PostBootState::GetSystemCounter(_model));
+    PostBootState::WriteLogo(&_bus);
+    _cpu.SetState(PostBootState::GetCpuState(_model, _cartridge.GetHeaderChecksum()));
+}
+
+bool Device::SetRecompiledModule(const RecompiledModule* recompiledModule)
+{
+    if (recompiledModule && !recompiledModule->IsFor(_cartridge.GetGlobalChecksum(), _cartridge.GetRomSize()))
+    {
+        LOG("Recompiled module was generated from another ROM, interpreting instead");
+        _cpu.SetRecompiledModule(nullptr, _cartridge.GetRomData());
+        return false;
+    }
+
+    _cpu.SetRecompiledModule(recompiledModule, _cartridge.GetRomData());
+    return true;
+}
+
+Fault Device::GetFault() const
+{
+    return _cpu.GetFault().IsSet() ? _cpu.GetFault() : _bus.GetFault();
+}
+
+void Device::ClearFault()
+{
+    _cpu.ClearFault();
+    _bus.ClearFault();
+}
+
+bool Device::CopyStateFrom(const Device& other)
+{
+    if (other._cartridge.GetRomSize() != _cartridge.GetRomSize() || other._cartridge.GetGlobalChecksum() != _cartridge.GetGlobalChecksum())
+    {
+        LOG("Can't copy the state of a device running another cartridge");
+        return false;
+    }
+
+    _cartridge.CopyStateFrom(other._cartridge);
+    _vRam = other._vRam;
+    _wRam = other._wRam;
+    _wRamCgb = other._wRamCgb;
+    _oam = other._oam;
+    _hRam = other._hRam;
+    CopyComponentStateFrom(other);
+    return true;
+}
+
+std::unique_ptr<Device> Device::Fork()
+{
+    auto fork = std::make_unique<Device>(_bootRom.GetBytes(), _cartridge.GetRomBytes(), static_cast<int>(_framesPerSecond));
+    fork->_cartridge.ShareStateFrom(_cartridge);
+    fork->_vRam.ShareStateFrom(_vRam);
+    fork->_wRam.ShareStateFrom(_wRam);
+    fork->_wRamCgb.ShareStateFrom(_wRamCgb);
+    fork->_oam.ShareStateFrom(_oam);
+    fork->_hRam.ShareStateFrom(_hRam);
+    fork->CopyComponentStateFrom(*this);
+    fork->_idleLoopDetector.CopyAnalysesFrom(_idleLoopDetector);
+    fork->_headless = _headless;
+    return fork;
 }
 
-void Device::Run()
+void Device::CopyComponentStateFrom(const Device& other)
+{
+    _scheduler = other._scheduler;
+    _ioRegisters = other._ioRegisters;
+    _joypad.CopyStateFrom(other._joypad);
+    _serial.CopyStateFrom(other._serial);
+    _timer.CopyStateFrom(other._timer);
+    _apu.CopyStateFrom(other._apu);
+    _hdma.CopyStateFrom(other._hdma);
+    _bus.CopyStateFrom(other._bus);
+    _cpu.CopyStateFrom(other._cpu);
+    _idleLoopDetector.CopyStateFrom(other._idleLoopDetector);
+
+    _isDoubleSpeed = other._isDoubleSpeed;
+    // Kept at this device's own frame rate
+    _maxCyclesPerFrame = Cpu::CpuClock * _frameTimeSeconds * (_isDoubleSpeed ? 2 : 1);
+    _stopRequested = other._stopRequested;
+    _buttons = other._buttons;
+}
+
+void Device::SampleScreen(ScreenSampler& screenSampler) const
+{
+    if (_runAheadDevice)
+    {
+        _runAheadDevice->SampleScreen(screenSampler);
+        return;
+    }
+
+    screenSampler.Sample(_vRam, _oam, _ioRegisters, _model == HardwareModel::Cgb);
+}
+
+void Device::SetRunAheadFrames(const unsigned int frameCount)
+{
+    _runAheadFrames = frameCount;
+    if (frameCount == 0)
+        _runAheadDevice.reset();
+}
+
+void Device::Run(const unsigned int maxFrames)
 {
     if (!IsValid())
         return;
@@ -51,7 +185,7 @@ void Device::Run()
 
         if (cyclesDone == 0)
         {
-            return;
+            break;
         }
 
         const auto runCurrentTime = std::chrono::steady_clock::now();
@@ -59,8 +193,13 @@ void Device::Run()
 
         totalCycles += cyclesDone;
         totalFrames++;
+
+        if (totalFrames == maxFrames || _stopRequested)
+            break;
     }
 
+    _serial.DisconnectLink();
+
     LOG("Finished running. Ran for " << runSeconds << "s, with " << totalFrames << " frames and cycled " << totalCycles
         << " times");
 }
@@ -70,10 +209,12 @@ unsigned Device::DoFrame()
     unsigned int cycleCount = 0;
 
     const auto frameStartTime = std::chrono::steady_clock::now();
+
+    UpdateInput();
     
-    while (cycleCount < _maxCyclesPerFrame)
+    while (cycleCount < _maxCyclesPerFrame && !_stopRequested)
     {
-        const byte cyclesExecuted = _cpu.Update();
+        const unsigned int cyclesExecuted = Execute(static_cast<unsigned int>(_maxCyclesPerFrame) - cycleCount);
         
         if (cyclesExecuted == 0)
         {
@@ -81,7 +222,24 @@ unsigned Device::DoFrame()
         }
 
         cycleCount += cyclesExecuted;
+
+        if (cycleCount >= _maxCyclesPerFrame)
+            break;
+
+        const unsigned int frameCyclesLeft = static_cast<unsigned int>(_maxCyclesPerFrame) - cycleCount;
+        if (_cpu.IsWaitingForInterrupt())
+            cycleCount += SkipHalt(frameCyclesLeft);
+        else if (_cpu.HasTakenBackwardBranch() && _idleLoopDetector.IsEnabled())
+            cycleCount += SkipIdleLoop(frameCyclesLeft);
     }
+
+    _apu.EndFrame();
+
+    if (_runAheadFrames)
+        RunAhead();
+
+    if (_headless)
+        return cycleCount;
     
     const auto frameEndTime = std::chrono::steady_clock::now();
     const std::chrono::duration<double> frameTime = frameEndTime - frameStartTime;
@@ -91,6 +249,181 @@ unsigned Device::DoFrame()
     return cycleCount;
 }
 
+unsigned int Device::RunFramePrefix(const unsigned int maxInstructions)
+{
+    unsigned int cycleCount = 0;
+    unsigned int instructionCount = 0;
+
+    UpdateInput();
+
+    // Stepping reaches the same states as skipping halts and idle loops does, only one instruction at a time
+    while (instructionCount < maxInstructions && cycleCount < _maxCyclesPerFrame && !_stopRequested)
+    {
+        const unsigned int cyclesExecuted = Execute(1);
+        if (cyclesExecuted == 0)
+            break;
+
+        cycleCount += cyclesExecuted;
+        instructionCount++;
+    }
+
+    return instructionCount;
+}
+
+unsigned int Device::Execute(unsigned int cycleBudget)
+{
+    // The comparer looks at every instruction, which then run one at a time so it can stop the run
+    if (_goldenLogComparer) [[unlikely]]
+    {
+        CompareGoldenLog();
+        cycleBudget = 1;
+    }
+
+    // The CPU advances the scheduler itself, and returns as soon as an event is pending
+    unsigned int cyclesExecuted = _cpu.RunFor(cycleBudget);
+    if (_cpu.IsSpeedSwitchRequested()) [[unlikely]]
+        SwitchSpeed();
+
+    HandlePendingEvents();
+
+    // VRAM DMA blocks copied by the instruction or by the events it reached, which can reach more HBlanks themselves
+    while (_hdma.HasStallCycles()) [[unlikely]]
+    {
+        const unsigned int stallCycles = _hdma.TakeStallCycles();
+        _scheduler.Advance(stallCycles);
+        HandlePendingEvents();
+        cyclesExecuted += stallCycles;
+    }
+
+    return cyclesExecuted;
+}
+
+void Device::CompareGoldenLog()
+{
+    if (_cpu.IsHalted())
+        return;
+
+    const CpuState state = _cpu.GetState();
+    std::array<byte, GoldenLog::PcMemorySize> pcMemory;
+    for (unsigned int i = 0; i < GoldenLog::PcMemorySize; i++)
+        pcMemory[i] = _bus.Read(static_cast<word>(state.pc + i));
+
+    if (!_goldenLogComparer->Compare(state, pcMemory))
+        _stopRequested = true;
+}
+
+void Device::HandlePendingEvents()
+{
+    if (!_scheduler.HasPendingEvent())
+        return;
+
+    while (_scheduler.HasPendingEvent())
+        HandleEvent(_scheduler.PopPendingEvent());
+
+    _idleLoopDetector.ResetCandidate();
+}
+
+void Device::SwitchSpeed()
+{
+    _cpu.ClearSpeedSwitchRequest();
+    _isDoubleSpeed = !_isDoubleSpeed;
+
+    const byte key1 = _ioRegisters.Read(AddressConstants::Key1) & ~(GbConstants::Key1SwitchRequest | GbConstants::Key1DoubleSpeed);
+    _ioRegisters.Write(AddressConstants::Key1, key1 | (_isDoubleSpeed ? GbConstants::Key1DoubleSpeed : 0));
+
+    // The timer and serial run on the CPU clock and follow it, the APU doesn't. The frame in progress keeps counting
+    // its cycles at the new speed, which is off by less than a frame once per switch.
+    _apu.SetDoubleSpeed(_isDoubleSpeed);
+    _hdma.SetDoubleSpeed(_isDoubleSpeed);
+    _maxCyclesPerFrame = Cpu::CpuClock * _frameTimeSeconds * (_isDoubleSpeed ? 2 : 1);
+}
+
+unsigned int Device::SkipHalt(const unsigned int frameCyclesLeft)
+{
+    // Halted time passes in 4 cycle steps, rounding up keeps the CPU waking up on the exact cycle it would have by
+    // stepping
+    const unsigned int skippedCycles = GetCyclesToNextEvent(frameCyclesLeft) + 3 & ~3u;
+
+    _scheduler.Advance(skippedCycles);
+    HandlePendingEvents();
+
+    return skippedCycles;
+}
+
+unsigned int Device::SkipIdleLoop(const unsigned int frameCyclesLeft)
+{
+    const unsigned int skippedCycles = _idleLoopDetector.OnBackwardBranch(_cpu.GetState(), _cpu.GetBackwardBranchEnd(), _scheduler.GetCurrentCycle(),
+                                                                          GetCyclesToNextEvent(frameCyclesLeft));
+
+    _scheduler.Advance(skippedCycles);
+    HandlePendingEvents();
+
+    return skippedCycles;
+}
+
+unsigned int Device::GetCyclesToNextEvent(const unsigned int frameCyclesLeft) const
+{
+    // Interrupts are only requested by scheduled events and by the input applied at the start of each frame, so
+    // nothing observable can happen before the earliest of both
+    const unsigned long long cyclesToNextEvent = _scheduler.GetNextEventCycle() - _scheduler.GetCurrentCycle();
+    return static_cast<unsigned int>(std::min<unsigned long long>(cyclesToNextEvent, frameCyclesLeft));
+}
+
+void Device::UpdateInput()
+{
+    const byte buttons = _moviePlayer ? _moviePlayer->ReadFrame() : _buttons;
+    _joypad.SetButtons(buttons);
+    _idleLoopDetector.ResetCandidate();
+
+    if (_movieRecorder)
+        _movieRecorder->WriteFrame(buttons);
+}
+
+void Device::RunAhead()
+{
+    // Saving the state is copying it to the device ahead and restoring it is carrying on with this one, a single copy
+    // per frame
+    if (_runAheadDevice)
+        _runAheadDevice->CopyStateFrom(*this);
+    else
+    {
+        _runAheadDevice = Fork();
+        _runAheadDevice->SetHeadless(true);
+        _runAheadDevice->SetAudioMuted(true);
+    }
+
+    // The buttons applied this frame, which may have come from a movie
+    _runAheadDevice->SetButtons(_joypad.GetButtons());
+    for (unsigned int frame = 0; frame < _runAheadFrames; frame++)
+        _runAheadDevice->DoFrame();
+}
+
+void Device::HandleEvent(const SchedulerEvent event)
+{
+    switch (event)
+    {
+    case SchedulerEvent::TimerOverflow:
+        _timer.OnOverflowEvent();
+        break;
+    case SchedulerEvent::SerialTransfer:
+        _serial.OnTransferEvent();
+        _stopRequested = _serial.GetMatchedStopPattern() >= 0;
+        break;
+    case SchedulerEvent::LinkSync:
+        _serial.OnLinkSyncEvent();
+        break;
+    case SchedulerEvent::LinkTransfer:
+        _serial.OnLinkTransferEvent();
+        _stopRequested = _serial.GetMatchedStopPattern() >= 0;
+        break;
+    case SchedulerEvent::HBlankDma:
+        _hdma.OnHBlankEvent();
+        break;
+    case SchedulerEvent::Count:
+        break;
+    }
+}
+
 void Device::WaitForNextFrame(const double frameTimeSeconds) const
 {
     const double remainingFrameTime = _frameTimeSeconds - frameTimeSeconds;
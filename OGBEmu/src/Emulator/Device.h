@@ -1,10 +1,19 @@
 #pragma once
 
+#include <memory>
+
 #include "Emulator/Cpu.h"
+#include "Emulator/IdleLoopDetector.h"
+#include "Emulator/Joypad.h"
+#include "Emulator/PostBootState.h"
+#include "Emulator/Scheduler.h"
+#include "Emulator/Serial.h"
+#include "Emulator/Timer.h"
+#include "Emulator/Audio/Apu.h"
 #include "Emulator/Memory/BootRom.h"
 #include "Emulator/Memory/Bus.h"
 #include "Emulator/Memory/Cartridge.h"
-#include "Emulator/Memory/EchoRam.h"
+#include "Emulator/Memory/Hdma.h"
 #include "Emulator/Memory/HRam.h"
 #include "Emulator/Memory/IoRegisters.h"
 #include "Emulator/Memory/Oam.h"
@@ -12,31 +21,155 @@
 #include "Emulator/Memory/WRam.h"
 #include "Emulator/Memory/WRamCgb.h"
 
+class CoverageMap;
+class GoldenLogComparer;
+class InputMoviePlayer;
+class InputMovieRecorder;
+class InstructionTraceRecorder;
+class RecompiledModule;
+class ScreenSampler;
+
 class Device
 {
 public:
+    // Without boot ROM bytes, the cartridge starts right away from the state the boot ROM would have left
     Device(const std::vector<byte>& bootRomBytes, const std::vector<byte>& cartridgeBytes, int framesPerSecond);
+    // Devices running the same ROM can share it
+    Device(const std::vector<byte>& bootRomBytes, std::shared_ptr<const std::vector<byte>> cartridgeBytes, int framesPerSecond);
 
     [[nodiscard]] bool IsValid() const;
-    void Run();
+    void Run(unsigned int maxFrames = 0);
+    // Runs a single frame, paced unless headless, and returns the cycles it took
+    unsigned int RunFrame() { return DoFrame(); }
+    // Runs a single instruction and handles the events it reached, returns its cycles
+    unsigned int Step() { return Execute(1); }
+    // Starts a frame and runs at most its first instructions one at a time, a halted step counting as one, then returns
+    // how many ran. The device is left in the middle of the frame and the next RunFrame starts a whole new one, this is
+    // for looking at the states in between instructions.
+    unsigned int RunFramePrefix(unsigned int maxInstructions);
+
+    void SetAudioSink(BaseAudioSink* audioSink) { _apu.SetSink(audioSink); }
+    // For runs nobody listens to, synthesizing a playing sound is most of the cost of an idle frame
+    void SetAudioMuted(const bool muted) { _apu.SetMuted(muted); }
+    void SetHeadless(const bool headless) { _headless = headless; }
+    // Skipping idle loops is exact, turning it off only helps ruling it out when chasing accuracy issues
+    void SetIdleLoopSkipping(const bool enabled)
+    {
+        _idleLoopDetector.SetEnabled(enabled);
+        _cpu.SetStopsAtBackwardBranch(enabled);
+    }
+
+    [[nodiscard]] const std::string& GetSerialOutput() const { return _serial.GetOutput(); }
+    // Stops the run as soon as the serial output ends with one of the patterns
+    void SetSerialStopPatterns(const std::vector<std::string>& stopPatterns) { _serial.SetStopPatterns(stopPatterns); }
+    [[nodiscard]] int GetMatchedSerialStopPattern() const { return _serial.GetMatchedStopPattern(); }
+    [[nodiscard]] word GetCartridgeChecksum() const { return _cartridge.GetGlobalChecksum(); }
+    [[nodiscard]] unsigned int GetFramesPerSecond() const { return _framesPerSecond; }
+    // CGB only cartridges run in CGB mode, every other one in DMG mode
+    [[nodiscard]] HardwareModel GetHardwareModel() const { return _model; }
+    [[nodiscard]] bool IsDoubleSpeed() const { return _isDoubleSpeed; }
+    [[nodiscard]] CpuState GetCpuState() const { return _cpu.GetState(); }
+    [[nodiscard]] bool IsHalted() const { return _cpu.IsHalted(); }
+    [[nodiscard]] unsigned long long GetCurrentCycle() const { return _scheduler.GetCurrentCycle(); }
+
+    // What the CPU would read at the address, invalid addresses log like the CPU reading them would
+    [[nodiscard]] byte ReadMemory(const word address) const { return _bus.Read(address); }
+    // See Bus::GetReadPointer, for reading memory in bulk
+    [[nodiscard]] const byte* GetMemoryReadPointer(const word address) const { return _bus.GetReadPointer(address); }
+    // From the device ahead when running ahead
+    void SampleScreen(ScreenSampler& screenSampler) const;
+
+    // After each frame, a second device picks up this one's state and runs that many frames further with the same
+    // buttons held. The screen is sampled from there, so a game reacting to input within those frames shows it without
+    // their latency. Frames ahead are muted and never sampled but for the last one, and are dropped on the next frame.
+    // 0 turns it off.
+    void SetRunAheadFrames(unsigned int frameCount);
+
+    // Input is sampled once per simulation frame. A movie player overrides the buttons set here, a recorder saves
+    // whatever was applied, both must outlive the run.
+    void SetButtons(const byte buttons) { _buttons = buttons; }
+    void SetInputMoviePlayer(InputMoviePlayer* moviePlayer) { _moviePlayer = moviePlayer; }
+    void SetInputMovieRecorder(InputMovieRecorder* movieRecorder) { _movieRecorder = movieRecorder; }
+
+    // Every instruction is recorded before it runs, the recorder must outlive the run
+    void SetInstructionTraceRecorder(InstructionTraceRecorder* traceRecorder) { _cpu.SetTraceRecorder(traceRecorder); }
+    // Every instruction is compared before it runs and the run stops at the first mismatch, the comparer must outlive
+    // the run
+    void SetGoldenLogComparer(GoldenLogComparer* goldenLogComparer) { _goldenLogComparer = goldenLogComparer; }
+
+    // Code translated ahead of time runs instead of being interpreted, the module must outlive the run. Returns false
+    // and keeps interpreting when it was generated from another ROM.
+    bool SetRecompiledModule(const RecompiledModule* recompiledModule);
+    // The address of every instruction is recorded before it runs, which interprets them all one by one. The map must
+    // outlive the run and is meant for this cartridge's ROM size.
+    void SetCoverageMap(CoverageMap* coverageMap) { _cpu.SetCoverageMap(coverageMap, _cartridge.GetRomData()); }
+    // The first invalid opcode or write to an unused address since the state was copied or the fault cleared. Either
+    // is only logged, the run goes on.
+    [[nodiscard]] Fault GetFault() const;
+    void ClearFault();
+
+    // Puts the device in the state of another one running the same cartridge, so both go on identically given the
+    // same input. What's attached to the device, like the audio sink, link cable, movies, traces and recompiled
+    // module, isn't part of the state. Returns false and leaves the state alone when the cartridges differ.
+    bool CopyStateFrom(const Device& other);
+    // A new device in the same state, for exploring several inputs from one point. The memory is shared copy-on-write
+    // with this device, so both only pay for the pages they write to afterwards. The fork runs headless if this device
+    // does, nothing attached is carried over.
+    [[nodiscard]] std::unique_ptr<Device> Fork();
+
+    // The cable must outlive the run, each device can then run on its own thread
+    void ConnectLink(BaseLinkCable* linkCable, const bool deterministic) { _serial.ConnectLink(linkCable, deterministic); }
 
 private:
+    void SkipBootRom();
+    // Everything but the memory, which is either copied or shared
+    void CopyComponentStateFrom(const Device& other);
     unsigned int DoFrame();
+    unsigned int Execute(unsigned int cycleBudget);
+    void UpdateInput();
+    void RunAhead();
+    void CompareGoldenLog();
+    void HandlePendingEvents();
+    void SwitchSpeed();
+    [[nodiscard]] unsigned int SkipHalt(unsigned int frameCyclesLeft);
+    [[nodiscard]] unsigned int SkipIdleLoop(unsigned int frameCyclesLeft);
+    [[nodiscard]] unsigned int GetCyclesToNextEvent(unsigned int frameCyclesLeft) const;
+    void HandleEvent(SchedulerEvent event);
     void WaitForNextFrame(double frameTimeSeconds) const;
 
+    Scheduler _scheduler;
     BootRom _bootRom;
     Cartridge _cartridge;
     VRam _vRam;
     WRam _wRam;
     WRamCgb _wRamCgb;
-    EchoRam _echoRam;
     Oam _oam;
     IoRegisters _ioRegisters;
     HRam _hRam;
+    Joypad _joypad;
+    Serial _serial;
+    Timer _timer;
+    Apu _apu;
+    Hdma _hdma;
     Bus _bus;
     Cpu _cpu;
+    IdleLoopDetector _idleLoopDetector;
 
+    HardwareModel _model;
     unsigned int _framesPerSecond;
     double _frameTimeSeconds;
+    // In CPU cycles, doubled in double speed
     double _maxCyclesPerFrame;
+    bool _isDoubleSpeed = false;
+    bool _skipsBootRom;
+    bool _headless = false;
+    bool _stopRequested = false;
+
+    byte _buttons = 0;
+    InputMoviePlayer* _moviePlayer = nullptr;
+    InputMovieRecorder* _movieRecorder = nullptr;
+    GoldenLogComparer* _goldenLogComparer = nullptr;
+
+    unsigned int _runAheadFrames = 0;
+    std::unique_ptr<Device> _runAheadDevice;
 };
@@ -0,0 +1,291 @@
+#include "ControlFlowGraph.h"
+
+#include <algorithm>
+
+#include "Disassembler.h"
+#include "Emulator/Memory/AddressConstants.h"
+
+namespace
+{
+    constexpr unsigned int BankSize = 0x4000;
+    // Bank numbers above this need the upper bank register too, which isn't followed
+    constexpr unsigned int MaxLowBankCount = 32;
+    constexpr byte LowBankMask = 0x1F;
+
+    constexpr word EntryPointAddress = 0x100;
+    constexpr word InterruptVectors[] = {AddressConstants::VBlankHandlerAddress, AddressConstants::LcdHandlerAddress,
+                                         AddressConstants::TimerHandlerAddress, AddressConstants::SerialHandlerAddress,
+                                         AddressConstants::JoypadHandlerAddress};
+
+    constexpr word StartBankRegisterAddress = 0x2000;
+    constexpr word EndBankRegisterAddress = 0x3FFF;
+
+    [[nodiscard]] bool IsBankRegister(const int address)
+    {
+        return address >= StartBankRegisterAddress && address <= EndBankRegisterAddress;
+    }
+
+    // Instructions that leave A and HL alone, keeping them known while looking for the bank a write selects
+    [[nodiscard]] bool KeepsAccumulatorAndHl(const byte opcode)
+    {
+        switch (opcode)
+        {
+        case 0x00: case 0x01: case 0x02: case 0x03: case 0x06: case 0x0B: case 0x0E: case 0x11: case 0x12: case 0x13: case 0x16:
+        case 0x1B: case 0x1E: case 0xC5: case 0xD5: case 0xE0: case 0xE5: case 0xF3: case 0xF5: case 0xFB:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    [[nodiscard]] bool EndsFlow(const Disassembler::Flow flow)
+    {
+        using Disassembler::Flow;
+        return flow == Flow::Jump || flow == Flow::Return || flow == Flow::IndirectJump || flow == Flow::Illegal;
+    }
+}
+
+ControlFlowGraph::ControlFlowGraph(const std::vector<byte>& rom) : _rom(rom), _bankCount(static_cast<unsigned int>(rom.size() / BankSize))
+{
+    if (_bankCount < 2)
+        return;
+
+    _flags.resize(static_cast<size_t>(_bankCount) * BankSize);
+    Explore();
+    BuildBlocks();
+}
+
+word ControlFlowGraph::GetAddress(const unsigned int romOffset)
+{
+    return static_cast<word>(romOffset < BankSize ? romOffset : AddressConstants::StartRomBankNAddress + romOffset % BankSize);
+}
+
+std::vector<unsigned int> ControlFlowGraph::GetInstructionOffsets() const
+{
+    std::vector<unsigned int> offsets;
+    offsets.reserve(_instructionCount);
+
+    for (unsigned int romOffset = 0; romOffset < _flags.size(); romOffset++)
+    {
+        if (_flags[romOffset] & IsInstructionFlag)
+            offsets.push_back(romOffset);
+    }
+
+    return offsets;
+}
+
+const ControlFlowGraph::Block* ControlFlowGraph::FindBlock(const unsigned int romOffset) const
+{
+    const auto block = std::ranges::lower_bound(_blocks, romOffset, {}, &Block::romOffset);
+    return block != _blocks.end() && block->romOffset == romOffset ? &*block : nullptr;
+}
+
+void ControlFlowGraph::Explore()
+{
+    std::vector<Target> targets;
+
+    targets.push_back({0, EntryPointAddress});
+    for (word address = 0x00; address <= 0x38; address += 0x08)
+        targets.push_back({0, address});
+    for (const word address : InterruptVectors)
+        targets.push_back({0, address});
+
+    for (const Target& target : targets)
+        _flags[target.address] |= IsEntryFlag;
+
+    while (!targets.empty())
+    {
+        const Target target = targets.back();
+        targets.pop_back();
+        ExploreFrom(target, targets);
+    }
+
+    std::ranges::sort(_jumpEdges, {}, &Edge::siteOffset);
+    std::ranges::sort(_callEdges, {}, &Edge::siteOffset);
+    std::ranges::sort(_bankSwitchSites, {}, &BankSwitchSite::romOffset);
+
+    for (unsigned int romOffset = 0; romOffset < _flags.size(); romOffset++)
+    {
+        if (_flags[romOffset] & IsJumpTargetFlag)
+            _jumpTargets.push_back(romOffset);
+    }
+}
+
+void ControlFlowGraph::ExploreFrom(const Target& start, std::vector<Target>& targets)
+{
+    const unsigned int bankOffset = start.bank * BankSize;
+    word address = start.address;
+
+    // Constants last loaded on the way here, -1 when unknown
+    int accumulator = -1;
+    int hl = -1;
+    int selectedBank = -1;
+
+    while (true)
+    {
+        const unsigned int offsetInBank = address % BankSize;
+        const unsigned int romOffset = bankOffset + offsetInBank;
+        if (_flags[romOffset] & IsInstructionFlag)
+            break;
+
+        const byte size = Disassembler::GetSize(_rom[romOffset]);
+        // Whatever the next region maps follows, instructions running past the end of a bank are left alone
+        if (offsetInBank + size > BankSize)
+            break;
+
+        _flags[romOffset] |= IsInstructionFlag;
+        _instructionCount++;
+
+        const Disassembler::Instruction instruction = Disassembler::Decode(&_rom[romOffset], address);
+        const Disassembler::Flow flow = instruction.info->flow;
+        const byte opcode = instruction.GetOpcode();
+
+        // Value written to the bank register, -2 when there is no such write
+        int bankWrite = -2;
+        switch (opcode)
+        {
+        case 0x3E:
+            accumulator = instruction.GetImmediate8();
+            break;
+        case 0xAF:
+            accumulator = 0;
+            break;
+        case 0x21:
+            hl = instruction.GetImmediate16();
+            break;
+        case 0xEA:
+            if (IsBankRegister(instruction.GetImmediate16()))
+                bankWrite = accumulator;
+            break;
+        case 0x77:
+            if (IsBankRegister(hl))
+                bankWrite = accumulator;
+            break;
+        case 0x36:
+            if (IsBankRegister(hl))
+                bankWrite = instruction.GetImmediate8();
+            break;
+        default:
+            if (!KeepsAccumulatorAndHl(opcode))
+                accumulator = hl = -1;
+            break;
+        }
+
+        if (bankWrite != -2)
+        {
+            selectedBank = GetSelectedBank(bankWrite);
+            _bankSwitchSites.push_back({romOffset, address, selectedBank});
+        }
+
+        if (instruction.hasTarget)
+        {
+            const bool isCall = flow == Disassembler::Flow::Call || flow == Disassembler::Flow::ConditionalCall;
+            AddTargets(start.bank, selectedBank, romOffset, instruction.target, targets, isCall ? _callEdges : _jumpEdges);
+            // The callee may switch banks
+            if (isCall)
+                selectedBank = -1;
+        }
+
+        if (EndsFlow(flow) || offsetInBank + size == BankSize)
+            break;
+
+        const unsigned int nextOffset = romOffset + size;
+        if (flow != Disassembler::Flow::Next || _flags[nextOffset] & IsFallenIntoFlag)
+            _flags[nextOffset] |= IsLeaderFlag;
+        _flags[nextOffset] |= IsFallenIntoFlag;
+
+        address = static_cast<word>(address + size);
+    }
+}
+
+void ControlFlowGraph::AddTargets(const unsigned int fromBank, const int selectedBank, const unsigned int siteOffset, const word address,
+                                  std::vector<Target>& targets, std::vector<Edge>& edges)
+{
+    const auto add = [&](const unsigned int bank)
+    {
+        const unsigned int romOffset = bank * BankSize + address % BankSize;
+        _flags[romOffset] |= IsJumpTargetFlag;
+        edges.push_back({siteOffset, romOffset});
+        targets.push_back({bank, address});
+    };
+
+    if (address <= AddressConstants::EndRomBank0Address)
+    {
+        add(0);
+        return;
+    }
+
+    // Code in RAM isn't known ahead of time
+    if (address > AddressConstants::EndRomBankNAddress)
+        return;
+
+    if (selectedBank > 0)
+        add(selectedBank);
+    else if (fromBank != 0)
+        add(fromBank);
+    else
+    {
+        for (unsigned int bank = 1; bank < _bankCount; bank++)
+            add(bank);
+    }
+}
+
+void ControlFlowGraph::BuildBlocks()
+{
+    for (unsigned int romOffset = 0; romOffset < _flags.size(); romOffset++)
+    {
+        if (!(_flags[romOffset] & IsInstructionFlag) || !IsLeader(romOffset))
+            continue;
+
+        Block block;
+        block.romOffset = romOffset;
+        block.address = GetAddress(romOffset);
+        block.firstSuccessor = static_cast<unsigned int>(_successors.size());
+
+        unsigned int current = romOffset;
+        Disassembler::Flow flow;
+        bool fallsThrough;
+        while (true)
+        {
+            const Disassembler::OpcodeInfo& info = Disassembler::GetOpcodeInfo(_rom[current]);
+            flow = info.flow;
+            block.size += info.size;
+            block.instructionCount++;
+
+            const unsigned int next = current + info.size;
+            fallsThrough = !EndsFlow(flow) && next % BankSize != 0;
+            if (!fallsThrough || flow != Disassembler::Flow::Next || IsLeader(next))
+                break;
+
+            current = next;
+        }
+
+        if (flow == Disassembler::Flow::Jump || flow == Disassembler::Flow::ConditionalJump)
+        {
+            const auto [first, last] = std::ranges::equal_range(_jumpEdges, current, {}, &Edge::siteOffset);
+            for (auto edge = first; edge != last; ++edge)
+                _successors.push_back(edge->targetOffset);
+        }
+
+        if (fallsThrough)
+            _successors.push_back(romOffset + block.size);
+
+        block.successorCount = static_cast<unsigned int>(_successors.size()) - block.firstSuccessor;
+        _blocks.push_back(block);
+    }
+}
+
+bool ControlFlowGraph::IsLeader(const unsigned int romOffset) const
+{
+    return _flags[romOffset] & (IsEntryFlag | IsJumpTargetFlag | IsLeaderFlag) || !(_flags[romOffset] & IsFallenIntoFlag);
+}
+
+int ControlFlowGraph::GetSelectedBank(const int value) const
+{
+    if (value < 0 || _bankCount > MaxLowBankCount)
+        return -1;
+
+    // Selecting bank 0 maps bank 1, but masking by the bank count can come back to bank 0, which isn't switchable
+    const unsigned int bank = (value & LowBankMask ? value & LowBankMask : 1) % _bankCount;
+    return bank == 0 ? -1 : static_cast<int>(bank);
+}
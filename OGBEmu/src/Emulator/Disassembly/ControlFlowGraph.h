@@ -0,0 +1,107 @@
+#pragma once
+
+#include <vector>
+
+#include "Core/Definitions.h"
+
+// Finds the code of a ROM by following its control flow from the entry point and the RST and interrupt vectors, then
+// splits it into basic blocks. Everything is indexed by ROM offset, bank 0 running at 0x0000 and every other bank at
+// 0x4000.
+//
+// Jumps and calls from bank 0 into the switchable bank could land in any bank, so they are followed in each one,
+// unless the bank was just selected with a constant: LD A,n or XOR A, then LD (nn),A or LD (HL),A after LD HL,nn, or
+// LD (HL),n. Bank numbers follow MBC1, the only banked controller emulated.
+class ControlFlowGraph
+{
+public:
+    struct Block
+    {
+        unsigned int romOffset = 0;
+        word address = 0;
+        // Bytes and instructions, the last one being the only branch in the block
+        unsigned int size = 0;
+        unsigned int instructionCount = 0;
+        // Range of GetSuccessors, the ROM offsets of the blocks execution can go on with
+        unsigned int firstSuccessor = 0;
+        unsigned int successorCount = 0;
+    };
+
+    struct Edge
+    {
+        // Offset of the branch and of the code it goes to
+        unsigned int siteOffset;
+        unsigned int targetOffset;
+    };
+
+    struct BankSwitchSite
+    {
+        unsigned int romOffset;
+        word address;
+        // -1 when the bank isn't a constant
+        int bank;
+    };
+
+    explicit ControlFlowGraph(const std::vector<byte>& rom);
+
+    [[nodiscard]] static word GetAddress(unsigned int romOffset);
+
+    [[nodiscard]] bool IsInstruction(const unsigned int romOffset) const { return romOffset < _flags.size() && _flags[romOffset] & IsInstructionFlag; }
+    [[nodiscard]] unsigned int GetInstructionCount() const { return _instructionCount; }
+    // ROM offsets of every instruction found, sorted
+    [[nodiscard]] std::vector<unsigned int> GetInstructionOffsets() const;
+
+    // Sorted by ROM offset
+    [[nodiscard]] const std::vector<Block>& GetBlocks() const { return _blocks; }
+    [[nodiscard]] const std::vector<unsigned int>& GetSuccessors() const { return _successors; }
+    // nullptr when no block starts at romOffset
+    [[nodiscard]] const Block* FindBlock(unsigned int romOffset) const;
+
+    // ROM offsets that jumps, calls and RSTs go to, sorted
+    [[nodiscard]] const std::vector<unsigned int>& GetJumpTargets() const { return _jumpTargets; }
+    // Calls and RSTs, sorted by site
+    [[nodiscard]] const std::vector<Edge>& GetCallEdges() const { return _callEdges; }
+    // Sorted by ROM offset
+    [[nodiscard]] const std::vector<BankSwitchSite>& GetBankSwitchSites() const { return _bankSwitchSites; }
+
+private:
+    enum Flags : byte
+    {
+        IsInstructionFlag = 1 << 0,
+        IsEntryFlag = 1 << 1,
+        IsJumpTargetFlag = 1 << 2,
+        // An instruction runs on into this one
+        IsFallenIntoFlag = 1 << 3,
+        // Starts a block although an instruction runs on into it, which is a conditional branch or a call, or several
+        // instructions do
+        IsLeaderFlag = 1 << 4,
+    };
+
+    struct Target
+    {
+        unsigned int bank;
+        word address;
+    };
+
+    void Explore();
+    void ExploreFrom(const Target& start, std::vector<Target>& targets);
+    // Adds where a branch from fromBank to address may land, in selectedBank when it's known
+    void AddTargets(unsigned int fromBank, int selectedBank, unsigned int siteOffset, word address, std::vector<Target>& targets,
+                    std::vector<Edge>& edges);
+    void BuildBlocks();
+    [[nodiscard]] bool IsLeader(unsigned int romOffset) const;
+    // Bank mapped by writing value to the bank register, -1 when it isn't known
+    [[nodiscard]] int GetSelectedBank(int value) const;
+
+    const std::vector<byte>& _rom;
+    unsigned int _bankCount;
+    std::vector<byte> _flags;
+    unsigned int _instructionCount = 0;
+
+    std::vector<Block> _blocks;
+    std::vector<unsigned int> _successors;
+    std::vector<unsigned int> _jumpTargets;
+    std::vector<Edge> _callEdges;
+    std::vector<BankSwitchSite> _bankSwitchSites;
+    // Where each jump goes, sorted by site once explored
+    std::vector<Edge> _jumpEdges;
+};
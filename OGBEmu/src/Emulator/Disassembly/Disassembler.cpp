@@ -0,0 +1,223 @@
+#include "Disassembler.h"
+
+#include <cstdlib>
+#include <format>
+
+namespace
+{
+    constexpr const char* Registers[] = {"B", "C", "D", "E", "H", "L", "(HL)", "A"};
+    constexpr const char* RegisterPairs[] = {"BC", "DE", "HL", "SP"};
+    // PUSH and POP take AF instead of SP
+    constexpr const char* StackRegisterPairs[] = {"BC", "DE", "HL", "AF"};
+    constexpr const char* Conditions[] = {"NZ", "Z", "NC", "C"};
+    constexpr const char* AluOperations[] = {"ADD A,", "ADC A,", "SUB ", "SBC A,", "AND ", "XOR ", "OR ", "CP "};
+    constexpr const char* AccumulatorOperations[] = {"RLCA", "RRCA", "RLA", "RRA", "DAA", "CPL", "SCF", "CCF"};
+    constexpr const char* PrefixedOperations[] = {"RLC ", "RRC ", "RL ", "RR ", "SLA ", "SRA ", "SWAP ", "SRL "};
+    constexpr const char* AccumulatorLoads[] = {"(BC)", "(DE)", "(HL+)", "(HL-)"};
+    constexpr byte HlOperand = 6;
+
+    Disassembler::OpcodeInfo Make(std::string mnemonic, const byte size, const byte cycles, const Disassembler::Flow flow = Disassembler::Flow::Next,
+                                  const byte branchCycles = 0)
+    {
+        return {std::move(mnemonic), size, cycles, branchCycles, flow};
+    }
+
+    Disassembler::OpcodeInfo MakeUnprefixed(const byte opcode)
+    {
+        using Disassembler::Flow;
+
+        const byte x = opcode >> 6;
+        const byte y = opcode >> 3 & 0b111;
+        const byte z = opcode & 0b111;
+        const byte p = y >> 1;
+        const bool q = y & 1;
+
+        if (x == 1)
+        {
+            if (y == HlOperand && z == HlOperand)
+                return Make("HALT", 1, 4);
+            return Make(std::format("LD {},{}", Registers[y], Registers[z]), 1, y == HlOperand || z == HlOperand ? 8 : 4);
+        }
+
+        if (x == 2)
+            return Make(std::string(AluOperations[y]) + Registers[z], 1, z == HlOperand ? 8 : 4);
+
+        if (x == 0)
+        {
+            switch (z)
+            {
+            case 0:
+                if (y == 0)
+                    return Make("NOP", 1, 4);
+                if (y == 1)
+                    return Make("LD (a16),SP", 3, 20);
+                if (y == 2)
+                    return Make("STOP", 2, 4);
+                if (y == 3)
+                    return Make("JR r8", 2, 12, Flow::Jump);
+                return Make(std::format("JR {},r8", Conditions[y - 4]), 2, 8, Flow::ConditionalJump, 12);
+            case 1:
+                return q ? Make(std::format("ADD HL,{}", RegisterPairs[p]), 1, 8) : Make(std::format("LD {},d16", RegisterPairs[p]), 3, 12);
+            case 2:
+                return q ? Make(std::format("LD A,{}", AccumulatorLoads[p]), 1, 8) : Make(std::format("LD {},A", AccumulatorLoads[p]), 1, 8);
+            case 3:
+                return Make(std::format("{} {}", q ? "DEC" : "INC", RegisterPairs[p]), 1, 8);
+            case 4:
+                return Make(std::format("INC {}", Registers[y]), 1, y == HlOperand ? 12 : 4);
+            case 5:
+                return Make(std::format("DEC {}", Registers[y]), 1, y == HlOperand ? 12 : 4);
+            case 6:
+                return Make(std::format("LD {},d8", Registers[y]), 2, y == HlOperand ? 12 : 8);
+            default:
+                return Make(AccumulatorOperations[y], 1, 4);
+            }
+        }
+
+        switch (z)
+        {
+        case 0:
+            if (y < 4)
+                return Make(std::format("RET {}", Conditions[y]), 1, 8, Flow::ConditionalReturn, 20);
+            if (y == 4)
+                return Make("LDH (a8),A", 2, 12);
+            if (y == 5)
+                return Make("ADD SP,s8", 2, 16);
+            if (y == 6)
+                return Make("LDH A,(a8)", 2, 12);
+            return Make("LD HL,SPs8", 2, 12);
+        case 1:
+            if (!q)
+                return Make(std::format("POP {}", StackRegisterPairs[p]), 1, 12);
+            if (p == 0)
+                return Make("RET", 1, 16, Flow::Return);
+            if (p == 1)
+                return Make("RETI", 1, 16, Flow::Return);
+            if (p == 2)
+                return Make("JP HL", 1, 4, Flow::IndirectJump);
+            return Make("LD SP,HL", 1, 8);
+        case 2:
+            if (y < 4)
+                return Make(std::format("JP {},a16", Conditions[y]), 3, 12, Flow::ConditionalJump, 16);
+            if (y == 4)
+                return Make("LD (C),A", 1, 8);
+            if (y == 5)
+                return Make("LD (a16),A", 3, 16);
+            if (y == 6)
+                return Make("LD A,(C)", 1, 8);
+            return Make("LD A,(a16)", 3, 16);
+        case 3:
+            if (y == 0)
+                return Make("JP a16", 3, 16, Flow::Jump);
+            if (y == 1)
+                return Make("PREFIX CB", 2, 8);
+            if (y == 6)
+                return Make("DI", 1, 4);
+            if (y == 7)
+                return Make("EI", 1, 4);
+            break;
+        case 4:
+            if (y < 4)
+                return Make(std::format("CALL {},a16", Conditions[y]), 3, 12, Flow::ConditionalCall, 24);
+            break;
+        case 5:
+            if (!q)
+                return Make(std::format("PUSH {}", StackRegisterPairs[p]), 1, 16);
+            if (p == 0)
+                return Make("CALL a16", 3, 24, Flow::Call);
+            break;
+        case 6:
+            return Make(std::string(AluOperations[y]) + "d8", 2, 8);
+        default:
+            return Make(std::format("RST ${:02X}", y * 8), 1, 16, Flow::Call);
+        }
+
+        return Make(std::format("ILLEGAL ${:02X}", opcode), 1, 4, Flow::Illegal);
+    }
+
+    Disassembler::OpcodeInfo MakePrefixed(const byte opcode)
+    {
+        const byte x = opcode >> 6;
+        const byte y = opcode >> 3 & 0b111;
+        const byte z = opcode & 0b111;
+
+        if (x == 0)
+            return Make(std::string(PrefixedOperations[y]) + Registers[z], 2, z == HlOperand ? 16 : 8);
+
+        constexpr const char* bitOperations[] = {"", "BIT", "RES", "SET"};
+        // BIT only reads (HL)
+        const byte hlCycles = x == 1 ? 12 : 16;
+        return Make(std::format("{} {},{}", bitOperations[x], y, Registers[z]), 2, z == HlOperand ? hlCycles : 8);
+    }
+
+    template <typename Function>
+    std::array<Disassembler::OpcodeInfo, 256> MakeTable(Function makeInfo)
+    {
+        std::array<Disassembler::OpcodeInfo, 256> table;
+        for (unsigned int opcode = 0; opcode < table.size(); opcode++)
+            table[opcode] = makeInfo(static_cast<byte>(opcode));
+        return table;
+    }
+
+    void ReplaceOperand(std::string& text, const std::string& placeholder, const std::string& value)
+    {
+        if (const size_t position = text.find(placeholder); position != std::string::npos)
+            text.replace(position, placeholder.size(), value);
+    }
+}
+
+const Disassembler::OpcodeInfo& Disassembler::GetOpcodeInfo(const byte opcode)
+{
+    static const std::array<OpcodeInfo, 256> table = MakeTable(MakeUnprefixed);
+    return table[opcode];
+}
+
+const Disassembler::OpcodeInfo& Disassembler::GetPrefixedOpcodeInfo(const byte opcode)
+{
+    static const std::array<OpcodeInfo, 256> table = MakeTable(MakePrefixed);
+    return table[opcode];
+}
+
+Disassembler::Instruction Disassembler::Decode(const byte* bytes, const word address)
+{
+    Instruction instruction;
+    instruction.address = address;
+    instruction.info = bytes[0] == 0xCB ? &GetPrefixedOpcodeInfo(bytes[1]) : &GetOpcodeInfo(bytes[0]);
+
+    for (byte i = 0; i < instruction.info->size; i++)
+        instruction.bytes[i] = bytes[i];
+
+    const byte opcode = bytes[0];
+    const Flow flow = instruction.info->flow;
+    const word nextAddress = static_cast<word>(address + instruction.info->size);
+
+    if (flow == Flow::Jump || flow == Flow::ConditionalJump || flow == Flow::Call || flow == Flow::ConditionalCall)
+    {
+        instruction.hasTarget = true;
+        // JR, RST, then JP and CALL
+        if (instruction.info->size == 2)
+            instruction.target = static_cast<word>(nextAddress + static_cast<signed_byte>(bytes[1]));
+        else if (instruction.info->size == 1)
+            instruction.target = opcode & 0x38;
+        else
+            instruction.target = instruction.GetImmediate16();
+    }
+
+    return instruction;
+}
+
+std::string Disassembler::Format(const Instruction& instruction)
+{
+    std::string text = instruction.info->mnemonic;
+
+    if (instruction.GetOpcode() == 0xCB)
+        return text;
+
+    const auto signedOffset = static_cast<signed_byte>(instruction.GetImmediate8());
+    ReplaceOperand(text, "d16", std::format("${:04X}", instruction.GetImmediate16()));
+    ReplaceOperand(text, "a16", std::format("${:04X}", instruction.GetImmediate16()));
+    ReplaceOperand(text, "d8", std::format("${:02X}", instruction.GetImmediate8()));
+    ReplaceOperand(text, "a8", std::format("$FF{:02X}", instruction.GetImmediate8()));
+    ReplaceOperand(text, "r8", std::format("${:04X}", instruction.target));
+    ReplaceOperand(text, "s8", std::format("{}{}", signedOffset < 0 ? "-" : "+", std::abs(static_cast<int>(signedOffset))));
+    return text;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <string>
+
+#include "Core/Definitions.h"
+
+// Decodes SM83 instructions without running them, from tables generated once with the same operand encoding the CPU
+// decodes: x (bits 7-6), y (bits 5-3) and z (bits 2-0) of the opcode.
+namespace Disassembler
+{
+    // How execution goes on after an instruction
+    enum class Flow : byte
+    {
+        Next,
+        Jump,
+        ConditionalJump,
+        // CALL and RST
+        Call,
+        ConditionalCall,
+        // RET and RETI
+        Return,
+        ConditionalReturn,
+        // JP HL, which only goes somewhere known at run time
+        IndirectJump,
+        // Illegal opcodes lock the CPU up
+        Illegal
+    };
+
+    struct OpcodeInfo
+    {
+        // Operands are placeholders: d8 and d16 immediates, a8 the low byte of a high memory address, a16 an address,
+        // r8 a relative jump and s8 a signed offset
+        std::string mnemonic;
+        byte size = 1;
+        byte cycles = 4;
+        // Cycles when a conditional branch is taken
+        byte branchCycles = 0;
+        Flow flow = Flow::Next;
+    };
+
+    struct Instruction
+    {
+        word address = 0;
+        // Only the bytes of the instruction are set
+        std::array<byte, 3> bytes{};
+        const OpcodeInfo* info = nullptr;
+        // Where jumps, calls and RSTs go when it's known statically
+        bool hasTarget = false;
+        word target = 0;
+
+        [[nodiscard]] byte GetOpcode() const { return bytes[0]; }
+        [[nodiscard]] byte GetImmediate8() const { return bytes[1]; }
+        [[nodiscard]] word GetImmediate16() const { return static_cast<word>(bytes[1] | bytes[2] << 8); }
+    };
+
+    // CB prefixed instructions are described by their second byte's entry, which includes the prefix
+    [[nodiscard]] const OpcodeInfo& GetOpcodeInfo(byte opcode);
+    [[nodiscard]] const OpcodeInfo& GetPrefixedOpcodeInfo(byte opcode);
+    [[nodiscard]] inline byte GetSize(const byte opcode) { return GetOpcodeInfo(opcode).size; }
+
+    // bytes must hold the whole instruction, GetSize of its first byte
+    [[nodiscard]] Instruction Decode(const byte* bytes, word address);
+    [[nodiscard]] std::string Format(const Instruction& instruction);
+}
@@ -0,0 +1,79 @@
+#include "CheckpointedRun.h"
+
+#include <algorithm>
+
+#include "Emulator/Device.h"
+#include "Emulator/Divergence/StateSnapshot.h"
+
+CheckpointedRun::CheckpointedRun(std::shared_ptr<const std::vector<byte>> cartridgeBytes, std::vector<byte> frameButtons, const int framesPerSecond,
+                                 const unsigned int checkpointInterval) : _frameButtons(std::move(frameButtons)),
+                                                                          _checkpointInterval(std::max(checkpointInterval, 1u))
+{
+    _device = std::make_unique<Device>(std::vector<byte>(), std::move(cartridgeBytes), framesPerSecond);
+    _device->SetHeadless(true);
+    // Muting leaves the state as it would be, only nothing is synthesized
+    _device->SetAudioMuted(true);
+}
+
+CheckpointedRun::~CheckpointedRun() = default;
+
+bool CheckpointedRun::IsValid() const
+{
+    return _device->IsValid();
+}
+
+std::vector<unsigned long long> CheckpointedRun::Record()
+{
+    std::vector<unsigned long long> hashes;
+    _checkpoints.clear();
+    _scratchFrame = NoFrame;
+
+    hashes.reserve(GetFrameCount() + 1);
+    for (unsigned int frame = 0; frame <= GetFrameCount(); frame++)
+    {
+        if (frame % _checkpointInterval == 0 || frame == GetFrameCount())
+            _checkpoints.push_back(_device->Fork());
+        hashes.push_back(StateSnapshot::Take(*_device).Hash());
+
+        if (frame < GetFrameCount())
+        {
+            _device->SetButtons(_frameButtons[frame]);
+            _device->RunFrame();
+        }
+    }
+
+    _scratch = _device->Fork();
+    _scratch->SetAudioMuted(true);
+    return hashes;
+}
+
+unsigned int CheckpointedRun::GetCheckpointFrame(const unsigned int checkpoint) const
+{
+    return std::min(checkpoint * _checkpointInterval, GetFrameCount());
+}
+
+const Device& CheckpointedRun::SeekFrame(const unsigned int frame)
+{
+    const unsigned int checkpointFrame = GetCheckpointFrame(frame / _checkpointInterval);
+    if (_scratchFrame == NoFrame || _scratchFrame < checkpointFrame || _scratchFrame > frame)
+    {
+        _scratch->CopyStateFrom(*_checkpoints[frame / _checkpointInterval]);
+        _scratchFrame = checkpointFrame;
+    }
+
+    for (; _scratchFrame < frame; _scratchFrame++)
+    {
+        _scratch->SetButtons(_frameButtons[_scratchFrame]);
+        _scratch->RunFrame();
+    }
+
+    return *_scratch;
+}
+
+unsigned int CheckpointedRun::SeekInstruction(const unsigned int frame, const unsigned int instructionCount)
+{
+    SeekFrame(frame);
+    _scratch->SetButtons(_frameButtons[frame]);
+    _scratchFrame = NoFrame;
+    return _scratch->RunFramePrefix(instructionCount);
+}
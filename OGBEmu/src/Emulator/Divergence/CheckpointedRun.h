@@ -0,0 +1,51 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Core/Definitions.h"
+
+class Device;
+
+// Plays the buttons of a movie on a cartridge, keeping a fork of the device every few frames. Any later state is then
+// reached by running at most that many frames from the closest checkpoint instead of from boot. Forks share their
+// memory pages copy-on-write, so each checkpoint only holds the pages written since the one before.
+class CheckpointedRun
+{
+public:
+    // One entry of the buttons per frame, the run lasts as many frames
+    CheckpointedRun(std::shared_ptr<const std::vector<byte>> cartridgeBytes, std::vector<byte> frameButtons, int framesPerSecond,
+                    unsigned int checkpointInterval);
+    ~CheckpointedRun();
+
+    [[nodiscard]] bool IsValid() const;
+    [[nodiscard]] unsigned int GetFrameCount() const { return static_cast<unsigned int>(_frameButtons.size()); }
+
+    // Runs every frame, with a checkpoint before each interval and one after the last frame. Returns the hash of the
+    // state snapshot before every frame and after the last one, the frame count + 1 of them: two runs that part and
+    // meet again between checkpoints still differ in a hash.
+    std::vector<unsigned long long> Record();
+    // Every interval, then the frame count
+    [[nodiscard]] unsigned int GetCheckpointFrame(unsigned int checkpoint) const;
+
+    // Seeks are meant for after recording. This is the device right before the frame runs, the frame count for the end
+    // of the run, and is only valid until the next seek.
+    const Device& SeekFrame(unsigned int frame);
+    // Leaves the device after the first instructions of a frame before the frame count, see Device::RunFramePrefix.
+    // Returns how many ran, less than asked when the frame ended first.
+    unsigned int SeekInstruction(unsigned int frame, unsigned int instructionCount);
+    [[nodiscard]] const Device& GetDevice() const { return *_scratch; }
+
+private:
+    static constexpr unsigned int NoFrame = ~0u;
+
+    std::unique_ptr<Device> _device;
+    std::vector<byte> _frameButtons;
+    unsigned int _checkpointInterval;
+    std::vector<std::unique_ptr<Device>> _checkpoints;
+
+    // Where seeks run, which goes on from the previous seek when that's closer than the checkpoint
+    std::unique_ptr<Device> _scratch;
+    // None after a prefix, the scratch device is then in the middle of a frame
+    unsigned int _scratchFrame = NoFrame;
+};
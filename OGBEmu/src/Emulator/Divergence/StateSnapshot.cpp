@@ -0,0 +1,65 @@
+#include "StateSnapshot.h"
+
+#include <cstring>
+
+#include "Emulator/Device.h"
+#include "Emulator/Memory/AddressConstants.h"
+
+namespace
+{
+    // 64-bit FNV-1a
+    constexpr unsigned long long HashOffsetBasis = 0xCBF29CE484222325;
+    constexpr unsigned long long HashPrime = 0x100000001B3;
+    // Bus::GetReadPointer stays contiguous within one
+    constexpr unsigned int BlockSize = 256;
+
+    void HashBytes(unsigned long long& hash, unsigned long long value, const unsigned int size)
+    {
+        for (unsigned int i = 0; i < size; i++, value >>= 8)
+            hash = (hash ^ (value & 0xFF)) * HashPrime;
+    }
+}
+
+StateSnapshot StateSnapshot::Take(const Device& device)
+{
+    StateSnapshot snapshot;
+    snapshot.cycle = device.GetCurrentCycle();
+    snapshot.cpu = device.GetCpuState();
+    snapshot.isHalted = device.IsHalted();
+
+    // Echo RAM only mirrors the work RAM and the unused area reads 0, both stay 0 here without logging invalid reads
+    snapshot.memory.resize(MemorySize);
+    for (unsigned int address = 0; address < AddressConstants::StartEchoRamAddress; address += BlockSize)
+    {
+        // Plain memory is copied a block at a time, this runs after every frame when bisecting
+        if (const byte* block = device.GetMemoryReadPointer(static_cast<word>(address)))
+            std::memcpy(&snapshot.memory[address], block, BlockSize);
+        else
+        {
+            for (unsigned int i = address; i < address + BlockSize; i++)
+                snapshot.memory[i] = device.ReadMemory(static_cast<word>(i));
+        }
+    }
+    for (unsigned int address = AddressConstants::EndEchoRamAddress + 1; address < MemorySize; address++)
+    {
+        if (address < AddressConstants::StartNotUsedAddress || address > AddressConstants::EndNotUsedAddress)
+            snapshot.memory[address] = device.ReadMemory(static_cast<word>(address));
+    }
+
+    return snapshot;
+}
+
+unsigned long long StateSnapshot::Hash() const
+{
+    unsigned long long hash = HashOffsetBasis;
+    HashBytes(hash, cycle, 8);
+    for (const word reg : {cpu.af, cpu.bc, cpu.de, cpu.hl, cpu.sp, cpu.pc})
+        HashBytes(hash, reg, 2);
+    HashBytes(hash, cpu.ime, 1);
+    HashBytes(hash, isHalted, 1);
+
+    for (const byte value : memory)
+        hash = (hash ^ value) * HashPrime;
+
+    return hash;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vector>
+
+#include "Core/Definitions.h"
+
+#include "Emulator/Cpu.h"
+
+class Device;
+
+// What two builds compare to tell whether a run is still in step: the CPU, the cycle and everything the CPU can read.
+// Banks that aren't mapped and internal counters aren't part of it, a difference there shows up once it reaches what
+// the CPU sees.
+struct StateSnapshot
+{
+    static constexpr unsigned int MemorySize = 0x10000;
+
+    unsigned long long cycle = 0;
+    CpuState cpu{};
+    bool isHalted = false;
+    // Indexed by address
+    std::vector<byte> memory;
+
+    [[nodiscard]] static StateSnapshot Take(const Device& device);
+    // Computed byte by byte in a fixed order, so equal snapshots hash the same whatever the build
+    [[nodiscard]] unsigned long long Hash() const;
+};
@@ -0,0 +1,48 @@
+#include "Environment.h"
+
+#include "Emulator/Device.h"
+
+Environment::Environment(std::shared_ptr<const std::vector<byte>> cartridgeBytes, const std::vector<word>& watchedAddresses,
+                         const unsigned int screenScale, const int framesPerSecond) : _device(std::make_unique<Device>(std::vector<byte>(), std::move(cartridgeBytes), framesPerSecond)),
+                                                                                      _watchedAddresses(watchedAddresses),
+                                                                                      _watchedBytes(watchedAddresses.size()),
+                                                                                      _screenSampler(screenScale)
+{
+    _device->SetHeadless(true);
+    if (_device->IsValid())
+        Sample();
+}
+
+Environment::~Environment() = default;
+
+bool Environment::IsValid() const
+{
+    return _device->IsValid();
+}
+
+bool Environment::Reset(const Device& snapshot)
+{
+    if (!_device->CopyStateFrom(snapshot))
+        return false;
+
+    Sample();
+    return true;
+}
+
+const std::vector<byte>& Environment::Step(const byte buttons, const unsigned int frames)
+{
+    _device->SetButtons(buttons);
+    for (unsigned int frame = 0; frame < frames; frame++)
+        _device->RunFrame();
+
+    Sample();
+    return _watchedBytes;
+}
+
+void Environment::Sample()
+{
+    for (size_t i = 0; i < _watchedAddresses.size(); i++)
+        _watchedBytes[i] = _device->ReadMemory(_watchedAddresses[i]);
+
+    _device->SampleScreen(_screenSampler);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Core/Definitions.h"
+
+#include "Emulator/ScreenSampler.h"
+
+class Device;
+
+// A device driven from a training loop, stepped a few frames at a time with the same buttons held. After each step
+// the watched memory bytes, which rewards are computed from, and a downsampled grayscale screen are in buffers
+// allocated up front. Stepping doesn't allocate, except for a memory page the first time an environment's game writes
+// to it, so many environments can be stepped in turn on each thread.
+class Environment
+{
+public:
+    // Environments given the same ROM pointer share it. Watched addresses are anywhere the CPU can read, the screen
+    // scale is a ScreenSampler one.
+    Environment(std::shared_ptr<const std::vector<byte>> cartridgeBytes, const std::vector<word>& watchedAddresses,
+                unsigned int screenScale, int framesPerSecond);
+    ~Environment();
+
+    [[nodiscard]] bool IsValid() const;
+    // Starts an episode from the state of a device running the same cartridge, for instance another environment's.
+    // Returns false and keeps the current state otherwise.
+    bool Reset(const Device& snapshot);
+    // Runs the frames holding the buttons and returns the watched bytes, in the order of their addresses
+    const std::vector<byte>& Step(byte buttons, unsigned int frames);
+
+    [[nodiscard]] const std::vector<byte>& GetWatchedBytes() const { return _watchedBytes; }
+    [[nodiscard]] const std::vector<byte>& GetScreen() const { return _screenSampler.GetPixels(); }
+    [[nodiscard]] unsigned int GetScreenWidth() const { return _screenSampler.GetWidth(); }
+    [[nodiscard]] unsigned int GetScreenHeight() const { return _screenSampler.GetHeight(); }
+    [[nodiscard]] const Device& GetDevice() const { return *_device; }
+
+private:
+    void Sample();
+
+    std::unique_ptr<Device> _device;
+    std::vector<word> _watchedAddresses;
+    std::vector<byte> _watchedBytes;
+    ScreenSampler _screenSampler;
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Core/Definitions.h"
+
+// Something no working cartridge does, which the CPU and the bus log and record instead of stopping. Real hardware
+// locks up on invalid opcodes, unused and unmapped writes are just ignored.
+enum class FaultType : byte
+{
+    None,
+    InvalidOpcode,
+    UnmappedWrite,
+    NotUsedWrite
+};
+
+struct Fault
+{
+    FaultType type = FaultType::None;
+    // Where the invalid opcode is or where the write went
+    word address = 0;
+    // The opcode or the written byte
+    byte value = 0;
+
+    [[nodiscard]] bool IsSet() const { return type != FaultType::None; }
+};
@@ -0,0 +1,70 @@
+#include "CoverageMap.h"
+
+namespace
+{
+    // Banks as the MBCs switch them, in the upper half of the ROM area
+    constexpr size_t RomBankSize = 16 * 1024;
+}
+
+CoverageMap::CoverageMap(const size_t romSize) : _romSize(romSize), _words((romSize + RamAddressCount + WordBits - 1) / WordBits)
+{
+    _setWords.reserve(_words.size());
+}
+
+size_t CoverageMap::CountCovered() const
+{
+    size_t count = 0;
+    for (const size_t index : _setWords)
+        count += static_cast<size_t>(std::popcount(_words[index]));
+
+    return count;
+}
+
+size_t CoverageMap::CountCoveredInBank(const unsigned int bank) const
+{
+    return CountCovered(bank * RomBankSize, RomBankSize);
+}
+
+size_t CoverageMap::CountCoveredInRam() const
+{
+    return CountCovered(_romSize, RamAddressCount);
+}
+
+size_t CoverageMap::CountCovered(const size_t firstBit, size_t bitCount) const
+{
+    if (firstBit >= GetBitCount())
+        return 0;
+    if (firstBit + bitCount > GetBitCount())
+        bitCount = GetBitCount() - firstBit;
+
+    size_t count = 0;
+    for (size_t bit = firstBit; bit < firstBit + bitCount; bit++)
+        count += IsCovered(bit);
+
+    return count;
+}
+
+size_t CoverageMap::Merge(const CoverageMap& other)
+{
+    size_t newBits = 0;
+    for (const size_t index : other._setWords)
+    {
+        const uint64_t added = other._words[index] & ~_words[index];
+        if (!added)
+            continue;
+
+        if (!_words[index])
+            _setWords.push_back(index);
+        _words[index] |= added;
+        newBits += static_cast<size_t>(std::popcount(added));
+    }
+
+    return newBits;
+}
+
+void CoverageMap::Clear()
+{
+    for (const size_t index : _setWords)
+        _words[index] = 0;
+    _setWords.clear();
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Core/Definitions.h"
+
+// Addresses instructions were run from, one bit each. The cartridge ROM gets a bit per byte so the same address in two
+// banks counts twice, the address space above it gets one per address for code copied to RAM. The words set since the
+// last clear are listed, so clearing and merging the coverage of a short run only visit those.
+class CoverageMap
+{
+public:
+    explicit CoverageMap(size_t romSize);
+
+    void RecordRom(const size_t romOffset) { Record(romOffset); }
+    void RecordRam(const word address) { Record(_romSize + address - RamStartAddress); }
+
+    [[nodiscard]] size_t GetRomSize() const { return _romSize; }
+    // ROM offsets first, then the addresses from 0x8000
+    [[nodiscard]] size_t GetBitCount() const { return _romSize + RamAddressCount; }
+    [[nodiscard]] bool IsCovered(const size_t bit) const { return _words[bit / WordBits] >> bit % WordBits & 1; }
+    [[nodiscard]] size_t CountCovered() const;
+    [[nodiscard]] size_t CountCoveredInBank(unsigned int bank) const;
+    [[nodiscard]] size_t CountCoveredInRam() const;
+
+    // Adds the coverage of a map for the same ROM, returns how many bits were new
+    size_t Merge(const CoverageMap& other);
+    void Clear();
+
+    template <typename Callback>
+    void ForEachCovered(Callback callback) const
+    {
+        for (const size_t index : _setWords)
+        {
+            for (uint64_t bits = _words[index]; bits; bits &= bits - 1)
+                callback(index * WordBits + static_cast<size_t>(std::countr_zero(bits)));
+        }
+    }
+
+private:
+    static constexpr word RamStartAddress = 0x8000;
+    static constexpr size_t RamAddressCount = 0x8000;
+    static constexpr size_t WordBits = 64;
+
+    void Record(const size_t bit)
+    {
+        uint64_t& bits = _words[bit / WordBits];
+        if (!bits)
+            _setWords.push_back(bit / WordBits);
+        bits |= uint64_t{1} << bit % WordBits;
+    }
+    [[nodiscard]] size_t CountCovered(size_t firstBit, size_t bitCount) const;
+
+    size_t _romSize;
+    std::vector<uint64_t> _words;
+    // Indices of the non zero words, reserved for all of them so recording never allocates
+    std::vector<size_t> _setWords;
+};
@@ -0,0 +1,57 @@
+#include "FuzzHarness.h"
+
+#include <algorithm>
+
+#include "Emulator/Device.h"
+
+FuzzHarness::FuzzHarness(std::shared_ptr<const std::vector<byte>> cartridgeBytes, const unsigned int framesPerInput, const unsigned int maxFrames,
+                         const unsigned int warmUpFrames, const int framesPerSecond) : _coverage(cartridgeBytes->size()),
+                                                                                       _framesPerInput(std::max(framesPerInput, 1u)),
+                                                                                       _maxFrames(maxFrames)
+{
+    _snapshot = std::make_unique<Device>(std::vector<byte>(), std::move(cartridgeBytes), framesPerSecond);
+    _snapshot->SetHeadless(true);
+    if (!_snapshot->IsValid())
+        return;
+
+    for (unsigned int frame = 0; frame < warmUpFrames; frame++)
+        _snapshot->RunFrame();
+    // Faults are looked for in what the input leads to
+    _snapshot->ClearFault();
+
+    _device = _snapshot->Fork();
+    _device->SetAudioMuted(true);
+    _device->SetCoverageMap(&_coverage);
+}
+
+FuzzHarness::~FuzzHarness() = default;
+
+bool FuzzHarness::IsValid() const
+{
+    return _device != nullptr;
+}
+
+Fault FuzzHarness::Run(const byte* input, const size_t size)
+{
+    _device->CopyStateFrom(*_snapshot);
+    _coverage.Clear();
+    _framesRun = 0;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        _device->SetButtons(input[i]);
+        for (unsigned int frame = 0; frame < _framesPerInput; frame++)
+        {
+            if (_framesRun == _maxFrames)
+                return {};
+
+            _device->RunFrame();
+            _framesRun++;
+
+            if (const Fault fault = _device->GetFault(); fault.IsSet())
+                return fault;
+        }
+    }
+
+    return {};
+}
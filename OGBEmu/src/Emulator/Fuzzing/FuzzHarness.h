@@ -0,0 +1,39 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Core/Definitions.h"
+
+#include "Emulator/Fault.h"
+#include "Emulator/Fuzzing/CoverageMap.h"
+
+class Device;
+
+// Runs a cartridge on joypad input from a fuzzer. Every run starts from one snapshot, taken once the cartridge has
+// booted and run its warm-up frames, by copying its state instead of booting again. Each input byte is the buttons held
+// for a few frames, and a run stops at the end of the input, at the first fault or after the maximum frame count.
+class FuzzHarness
+{
+public:
+    FuzzHarness(std::shared_ptr<const std::vector<byte>> cartridgeBytes, unsigned int framesPerInput, unsigned int maxFrames,
+                unsigned int warmUpFrames, int framesPerSecond);
+    ~FuzzHarness();
+
+    [[nodiscard]] bool IsValid() const;
+    // Returns the first fault of the run, if any
+    Fault Run(const byte* input, size_t size);
+
+    // Only what the last run executed, the warm-up isn't part of it
+    [[nodiscard]] const CoverageMap& GetCoverage() const { return _coverage; }
+    [[nodiscard]] unsigned int GetFramesRun() const { return _framesRun; }
+    [[nodiscard]] const Device& GetDevice() const { return *_device; }
+
+private:
+    std::unique_ptr<Device> _snapshot;
+    std::unique_ptr<Device> _device;
+    CoverageMap _coverage;
+    unsigned int _framesPerInput;
+    unsigned int _maxFrames;
+    unsigned int _framesRun = 0;
+};
@@ -9,6 +9,11 @@ namespace GbConstants
     constexpr word MinCartridgeRomSize = 32 * 1024;
     constexpr word RomBankSize = 32 * 1024;
     constexpr word RamBankSize = 8 * 1024;
+    constexpr word WRamBankSize = 4 * 1024;
+    constexpr word VRamBankSize = 8 * 1024;
+    // Banks 1 to 7 are switched in at 0xD000, bank 0 is fixed
+    constexpr byte CgbSwitchableWRamBankCount = 7;
+    constexpr byte CgbVRamBankCount = 2;
 
     // Flags values
     constexpr byte CgbFlag = 0xC0;
@@ -18,4 +23,15 @@ namespace GbConstants
     constexpr byte RamSizeFlag4Bank = 0x3;
     constexpr byte RamSizeFlag16Bank = 0x4;
     constexpr byte RamSizeFlag8Bank = 0x5;
+
+    // KEY1 bits
+    constexpr byte Key1SwitchRequest = 0b00000001;
+    constexpr byte Key1DoubleSpeed = 0b10000000;
+
+    // Interrupt flags
+    constexpr byte VBlankInterrupt = 0b00000001;
+    constexpr byte LcdInterrupt = 0b00000010;
+    constexpr byte TimerInterrupt = 0b00000100;
+    constexpr byte SerialInterrupt = 0b00001000;
+    constexpr byte JoypadInterrupt = 0b00010000;
 };
@@ -0,0 +1,292 @@
+#include "IdleLoopDetector.h"
+
+#include "Emulator/Memory/AddressConstants.h"
+#include "Emulator/Memory/Bus.h"
+
+namespace
+{
+    constexpr unsigned int MaxLoopSize = 32;
+    constexpr unsigned int AddressSpaceSize = 0x10000;
+
+    // Registers written by the loop body
+    constexpr byte RegisterB = 0b00000001;
+    constexpr byte RegisterC = 0b00000010;
+    constexpr byte RegisterD = 0b00000100;
+    constexpr byte RegisterE = 0b00001000;
+    constexpr byte RegisterH = 0b00010000;
+    constexpr byte RegisterL = 0b00100000;
+    constexpr byte RegisterA = 0b01000000;
+    constexpr byte RegisterSp = 0b10000000;
+
+    // Indexed by the 3 bit register operand of the opcode, (HL) is handled separately
+    constexpr byte Registers8[] = {RegisterB, RegisterC, RegisterD, RegisterE, RegisterH, RegisterL, 0, RegisterA};
+    constexpr byte Registers16[] = {RegisterB | RegisterC, RegisterD | RegisterE, RegisterH | RegisterL, RegisterSp};
+    constexpr byte HlOperand = 6;
+
+    // Memory read through a register pair, the pair must stay constant for the read address to be known
+    constexpr byte ReadsBc = 0b0001;
+    constexpr byte ReadsDe = 0b0010;
+    constexpr byte ReadsHl = 0b0100;
+    constexpr byte ReadsHighC = 0b1000;
+
+    // Registers that change with time alone, without any event being scheduled for it
+    bool IsVolatileAddress(const word address)
+    {
+        return (address >= AddressConstants::Div && address <= AddressConstants::Tac) ||
+            (address >= AddressConstants::StartApuAddress && address <= AddressConstants::EndApuAddress);
+    }
+}
+
+IdleLoopDetector::IdleLoopDetector(Bus* bus) : _bus(bus), _loopKinds(AddressSpaceSize, LoopKind::Unknown)
+{
+}
+
+void IdleLoopDetector::CopyStateFrom(const IdleLoopDetector& other)
+{
+    _enabled = other._enabled;
+    _hasCandidate = other._hasCandidate;
+    _candidateState = other._candidateState;
+    _candidateCycle = other._candidateCycle;
+}
+
+void IdleLoopDetector::CopyAnalysesFrom(const IdleLoopDetector& other)
+{
+    _loopKinds = other._loopKinds;
+    _idleLoops = other._idleLoops;
+}
+
+unsigned int IdleLoopDetector::OnBackwardBranch(const CpuState& state, const word branchEnd, const unsigned long long currentCycle,
+                                                const unsigned int maxSkipCycles)
+{
+    if (!_enabled)
+        return 0;
+
+    LoopKind& loopKind = _loopKinds[state.pc];
+    if (loopKind == LoopKind::NotIdle)
+    {
+        _hasCandidate = false;
+        return 0;
+    }
+
+    IdleLoop& loop = _idleLoops[state.pc];
+    if (loopKind == LoopKind::Unknown || !MatchesCode(state.pc, loop))
+    {
+        loop = {};
+        loopKind = Analyze(state.pc, loop) ? LoopKind::Idle : LoopKind::NotIdle;
+        if (loopKind == LoopKind::NotIdle)
+        {
+            _idleLoops.erase(state.pc);
+            _hasCandidate = false;
+            return 0;
+        }
+    }
+
+    // The period check makes sure exactly one pass through the analysed body happened since the last arrival, and not
+    // some other path that ended up coming back here
+    const bool isFixedPoint = _hasCandidate && _candidateState == state && currentCycle - _candidateCycle == loop.iterationCycles &&
+        state.pc + loop.code.size() == branchEnd && !ReadsVolatilePointer(state, loop);
+
+    _hasCandidate = true;
+    _candidateState = state;
+    _candidateCycle = currentCycle;
+
+    if (!isFixedPoint)
+        return 0;
+
+    const unsigned int skippedCycles = maxSkipCycles / loop.iterationCycles * loop.iterationCycles;
+    _candidateCycle += skippedCycles;
+    return skippedCycles;
+}
+
+bool IdleLoopDetector::Analyze(const word startAddress, IdleLoop& loop) const
+{
+    // Code running from OAM or IO space is not worth the trouble
+    if (startAddress >= AddressConstants::StartOamAddress && startAddress < AddressConstants::StartHRamAddress)
+        return false;
+
+    byte writtenRegisters = 0;
+    unsigned int address = startAddress;
+
+    while (address + 3 <= AddressSpaceSize && address - startAddress < MaxLoopSize)
+    {
+        const byte opcode = _bus->Read(static_cast<word>(address));
+        const byte x = opcode >> 6;
+        const byte y = opcode >> 3 & 0b111;
+        const byte z = opcode & 0b111;
+
+        unsigned int length = 1;
+        unsigned int cycles = 4;
+        bool closesLoop = false;
+
+        if (opcode == 0x00)
+        {
+        }
+        else if ((opcode & 0xCF) == 0x01)
+        {
+            writtenRegisters |= Registers16[opcode >> 4];
+            length = 3;
+            cycles = 12;
+        }
+        else if ((opcode & 0xC7) == 0x03)
+        {
+            writtenRegisters |= Registers16[opcode >> 4];
+            cycles = 8;
+        }
+        else if ((opcode & 0xCF) == 0x09)
+        {
+            writtenRegisters |= RegisterH | RegisterL;
+            cycles = 8;
+        }
+        else if (x == 0 && (z == 4 || z == 5 || z == 6))
+        {
+            // INC r, DEC r and LD r,d8, the (HL) forms write memory
+            if (y == HlOperand)
+                return false;
+
+            writtenRegisters |= Registers8[y];
+            length = z == 6 ? 2 : 1;
+            cycles = z == 6 ? 8 : 4;
+        }
+        else if (opcode == 0x0A || opcode == 0x1A)
+        {
+            loop.pointerReads |= opcode == 0x0A ? ReadsBc : ReadsDe;
+            writtenRegisters |= RegisterA;
+            cycles = 8;
+        }
+        else if (x == 0 && z == 7)
+        {
+            // Accumulator rotates, DAA, CPL, SCF and CCF
+            writtenRegisters |= RegisterA;
+        }
+        else if (x == 1)
+        {
+            // LD r,r', HALT and the stores through HL share this block
+            if (opcode == 0x76 || y == HlOperand)
+                return false;
+
+            if (z == HlOperand)
+            {
+                loop.pointerReads |= ReadsHl;
+                cycles = 8;
+            }
+            writtenRegisters |= Registers8[y];
+        }
+        else if (x == 2)
+        {
+            if (z == HlOperand)
+            {
+                loop.pointerReads |= ReadsHl;
+                cycles = 8;
+            }
+            writtenRegisters |= RegisterA;
+        }
+        else if ((opcode & 0xC7) == 0xC6)
+        {
+            writtenRegisters |= RegisterA;
+            length = 2;
+            cycles = 8;
+        }
+        else if (opcode == 0xF0 || opcode == 0xFA)
+        {
+            const word readAddress = opcode == 0xF0
+                                         ? static_cast<word>(AddressConstants::StartIoRegistersAddress + _bus->Read(static_cast<word>(address + 1)))
+                                         : static_cast<word>(_bus->Read(static_cast<word>(address + 1)) | _bus->Read(static_cast<word>(address + 2)) << 8);
+            if (IsVolatileAddress(readAddress))
+                return false;
+
+            writtenRegisters |= RegisterA;
+            length = opcode == 0xF0 ? 2 : 3;
+            cycles = opcode == 0xF0 ? 12 : 16;
+        }
+        else if (opcode == 0xF2)
+        {
+            loop.pointerReads |= ReadsHighC;
+            writtenRegisters |= RegisterA;
+            cycles = 8;
+        }
+        else if (opcode == 0xCB)
+        {
+            const byte prefixOpcode = _bus->Read(static_cast<word>(address + 1));
+            const byte operand = prefixOpcode & 0b111;
+            const bool isBit = prefixOpcode >> 6 == 1;
+
+            length = 2;
+            cycles = 8;
+
+            if (operand == HlOperand)
+            {
+                // Only BIT leaves memory alone
+                if (!isBit)
+                    return false;
+
+                loop.pointerReads |= ReadsHl;
+                cycles = 12;
+            }
+            else if (!isBit)
+                writtenRegisters |= Registers8[operand];
+        }
+        else if (opcode == 0x18 || (opcode & 0xE7) == 0x20 || opcode == 0xC3 || (opcode & 0xE7) == 0xC2)
+        {
+            const bool isRelative = opcode < 0x40;
+            const bool isConditional = opcode != 0x18 && opcode != 0xC3;
+            length = isRelative ? 2 : 3;
+
+            const unsigned int nextAddress = address + length;
+            const word target = isRelative
+                                    ? static_cast<word>(nextAddress + static_cast<signed_byte>(_bus->Read(static_cast<word>(address + 1))))
+                                    : static_cast<word>(_bus->Read(static_cast<word>(address + 1)) | _bus->Read(static_cast<word>(address + 2)) << 8);
+
+            if (target == startAddress)
+            {
+                closesLoop = true;
+                cycles = isRelative ? 12 : 16;
+            }
+            else if (isConditional && target >= nextAddress)
+            {
+                // Exit out of the loop, never taken while the loop spins
+                cycles = isRelative ? 8 : 12;
+            }
+            else
+                return false;
+        }
+        else
+            return false;
+
+        for (unsigned int i = 0; i < length; i++)
+            loop.code.push_back(_bus->Read(static_cast<word>(address + i)));
+
+        loop.iterationCycles += cycles;
+        address += length;
+
+        if (closesLoop)
+        {
+            // Pointers must not move inside the loop, so the addresses read are the ones of the registers on arrival
+            const bool pointerWritten = (loop.pointerReads & ReadsBc && writtenRegisters & (RegisterB | RegisterC)) ||
+                (loop.pointerReads & ReadsDe && writtenRegisters & (RegisterD | RegisterE)) ||
+                (loop.pointerReads & ReadsHl && writtenRegisters & (RegisterH | RegisterL)) ||
+                (loop.pointerReads & ReadsHighC && writtenRegisters & RegisterC);
+            return !pointerWritten;
+        }
+    }
+
+    return false;
+}
+
+bool IdleLoopDetector::MatchesCode(const word startAddress, const IdleLoop& loop) const
+{
+    for (unsigned int i = 0; i < loop.code.size(); i++)
+    {
+        if (_bus->Read(static_cast<word>(startAddress + i)) != loop.code[i])
+            return false;
+    }
+
+    return true;
+}
+
+bool IdleLoopDetector::ReadsVolatilePointer(const CpuState& state, const IdleLoop& loop)
+{
+    return (loop.pointerReads & ReadsBc && IsVolatileAddress(state.bc)) ||
+        (loop.pointerReads & ReadsDe && IsVolatileAddress(state.de)) ||
+        (loop.pointerReads & ReadsHl && IsVolatileAddress(state.hl)) ||
+        (loop.pointerReads & ReadsHighC && IsVolatileAddress(static_cast<word>(AddressConstants::StartIoRegistersAddress + (state.bc & 0xFF))));
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "Core/Definitions.h"
+
+#include "Emulator/Cpu.h"
+
+class Bus;
+
+// Finds busy-wait loops, like polling a flag set by an interrupt handler, so their time can be skipped up to the next
+// scheduled event. A loop qualifies when its body has no side effects and only reads memory that cannot change until
+// an event fires. Once the CPU arrives at the loop start twice in a row with the same registers, one iteration apart
+// and with no event handled in between, every following iteration is known to be identical and whole iterations can
+// be skipped.
+//
+// The analysis is cached per loop start address. Idle loops keep a copy of their code, which is checked before every
+// skip, so code that was banked out or rewritten in RAM is analysed again instead of being trusted.
+class IdleLoopDetector
+{
+public:
+    explicit IdleLoopDetector(Bus* bus);
+
+    [[nodiscard]] bool IsEnabled() const { return _enabled; }
+    void SetEnabled(const bool enabled) { _enabled = enabled; }
+    // Only the loop being watched is copied. The analyses are a cache each detector keeps for itself: idle loops are
+    // checked against the code before every skip, and a loop wrongly taken for busy only runs without skipping, which
+    // ends in the same state. This leaves the 64 KB of loop kinds out of every state copy.
+    void CopyStateFrom(const IdleLoopDetector& other);
+    // Starts from the other detector's analyses too, for a new device that would otherwise analyse every loop again
+    void CopyAnalysesFrom(const IdleLoopDetector& other);
+
+    // Must be called whenever memory may have changed outside of the CPU, like when an event is handled, since the
+    // last iteration seen may have read the old values
+    void ResetCandidate() { _hasCandidate = false; }
+
+    // Called when the CPU just jumped back to state.pc. Returns the number of cycles that can be skipped, always a
+    // whole number of loop iterations and never more than maxSkipCycles.
+    [[nodiscard]] unsigned int OnBackwardBranch(const CpuState& state, word branchEnd, unsigned long long currentCycle,
+                                                unsigned int maxSkipCycles);
+
+private:
+    enum class LoopKind : byte
+    {
+        Unknown,
+        NotIdle,
+        Idle
+    };
+
+    struct IdleLoop
+    {
+        std::vector<byte> code;
+        unsigned int iterationCycles = 0;
+        byte pointerReads = 0;
+    };
+
+    [[nodiscard]] bool Analyze(word startAddress, IdleLoop& loop) const;
+    [[nodiscard]] bool MatchesCode(word startAddress, const IdleLoop& loop) const;
+    [[nodiscard]] static bool ReadsVolatilePointer(const CpuState& state, const IdleLoop& loop);
+
+    Bus* _bus;
+    bool _enabled = true;
+
+    std::vector<LoopKind> _loopKinds;
+    std::unordered_map<word, IdleLoop> _idleLoops;
+
+    bool _hasCandidate = false;
+    CpuState _candidateState{};
+    unsigned long long _candidateCycle = 0;
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Core/Definitions.h"
+
+// Input movie file layout, all values little endian:
+//   0  magic "OGBM"
+//   4  version
+//   5  simulation frames per second the movie was recorded at
+//   7  cartridge global checksum, to detect playback against the wrong ROM
+//   9  frame count, patched when recording ends
+//  13  reserved
+//  16  one JoypadButtons bitmask per simulation frame
+namespace InputMovie
+{
+    constexpr char Magic[4] = {'O', 'G', 'B', 'M'};
+    constexpr byte Version = 1;
+    constexpr unsigned int HeaderSize = 16;
+
+    // Frames are buffered in blocks so movies of any length are streamed from and to disk
+    constexpr unsigned int BlockSize = 4096;
+
+    struct Header
+    {
+        unsigned short framesPerSecond = 0;
+        word romChecksum = 0;
+        unsigned int frameCount = 0;
+    };
+}
@@ -0,0 +1,62 @@
+#include "InputMoviePlayer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Core/Logger.h"
+
+InputMoviePlayer::InputMoviePlayer(const std::string& filePath) : _file(filePath, std::ifstream::binary)
+{
+    if (!_file.good())
+    {
+        LOG("Error opening input movie " << filePath);
+        return;
+    }
+
+    _isValid = ReadHeader();
+    if (!_isValid)
+        LOG("Invalid input movie " << filePath);
+}
+
+byte InputMoviePlayer::ReadFrame()
+{
+    if (!_isValid || IsFinished())
+        return 0;
+
+    if (_blockPosition == _block.size())
+        ReadBlock();
+
+    if (_block.empty())
+    {
+        LOG("Input movie is truncated, expected " << _header.frameCount << " frames, got " << _framesRead);
+        _header.frameCount = _framesRead;
+        return 0;
+    }
+
+    _framesRead++;
+    return _block[_blockPosition++];
+}
+
+bool InputMoviePlayer::ReadHeader()
+{
+    byte header[InputMovie::HeaderSize];
+    if (!_file.read(reinterpret_cast<char*>(header), InputMovie::HeaderSize))
+        return false;
+
+    if (std::memcmp(header, InputMovie::Magic, sizeof(InputMovie::Magic)) != 0 || header[4] != InputMovie::Version)
+        return false;
+
+    _header.framesPerSecond = static_cast<unsigned short>(header[5] | header[6] << 8);
+    _header.romChecksum = static_cast<word>(header[7] | header[8] << 8);
+    _header.frameCount = header[9] | header[10] << 8 | header[11] << 16 | static_cast<unsigned int>(header[12]) << 24;
+    return true;
+}
+
+void InputMoviePlayer::ReadBlock()
+{
+    const unsigned int remainingFrames = _header.frameCount - _framesRead;
+    _block.resize(std::min(remainingFrames, InputMovie::BlockSize));
+    _file.read(reinterpret_cast<char*>(_block.data()), static_cast<std::streamsize>(_block.size()));
+    _block.resize(static_cast<size_t>(_file.gcount()));
+    _blockPosition = 0;
+}
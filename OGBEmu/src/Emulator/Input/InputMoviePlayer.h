@@ -0,0 +1,32 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "InputMovie.h"
+
+// Streams the frames of a movie file, only one block is resident at a time. Once the movie ends all buttons are
+// released.
+class InputMoviePlayer
+{
+public:
+    explicit InputMoviePlayer(const std::string& filePath);
+
+    [[nodiscard]] bool IsValid() const { return _isValid; }
+    [[nodiscard]] const InputMovie::Header& GetHeader() const { return _header; }
+    [[nodiscard]] bool IsFinished() const { return _framesRead == _header.frameCount; }
+
+    [[nodiscard]] byte ReadFrame();
+
+private:
+    bool ReadHeader();
+    void ReadBlock();
+
+    std::ifstream _file;
+    InputMovie::Header _header;
+    std::vector<byte> _block;
+    unsigned int _blockPosition = 0;
+    unsigned int _framesRead = 0;
+    bool _isValid = false;
+};
@@ -0,0 +1,63 @@
+#include "InputMovieRecorder.h"
+
+#include "Core/Logger.h"
+
+InputMovieRecorder::InputMovieRecorder(const std::string& filePath, const unsigned short framesPerSecond, const word romChecksum) :
+    _file(filePath, std::ofstream::binary)
+{
+    if (!_file.good())
+    {
+        LOG("Error opening input movie " << filePath);
+        return;
+    }
+
+    _header.framesPerSecond = framesPerSecond;
+    _header.romChecksum = romChecksum;
+    _block.reserve(InputMovie::BlockSize);
+
+    WriteHeader();
+}
+
+InputMovieRecorder::~InputMovieRecorder()
+{
+    if (!_file.good())
+        return;
+
+    FlushBlock();
+    _file.seekp(0);
+    WriteHeader();
+}
+
+void InputMovieRecorder::WriteFrame(const byte buttons)
+{
+    if (!_file.good())
+        return;
+
+    _block.push_back(buttons);
+    _header.frameCount++;
+
+    if (_block.size() == InputMovie::BlockSize)
+        FlushBlock();
+}
+
+void InputMovieRecorder::WriteHeader()
+{
+    const byte header[InputMovie::HeaderSize] =
+    {
+        static_cast<byte>(InputMovie::Magic[0]), static_cast<byte>(InputMovie::Magic[1]),
+        static_cast<byte>(InputMovie::Magic[2]), static_cast<byte>(InputMovie::Magic[3]),
+        InputMovie::Version,
+        static_cast<byte>(_header.framesPerSecond), static_cast<byte>(_header.framesPerSecond >> 8),
+        static_cast<byte>(_header.romChecksum), static_cast<byte>(_header.romChecksum >> 8),
+        static_cast<byte>(_header.frameCount), static_cast<byte>(_header.frameCount >> 8),
+        static_cast<byte>(_header.frameCount >> 16), static_cast<byte>(_header.frameCount >> 24),
+    };
+
+    _file.write(reinterpret_cast<const char*>(header), InputMovie::HeaderSize);
+}
+
+void InputMovieRecorder::FlushBlock()
+{
+    _file.write(reinterpret_cast<const char*>(_block.data()), static_cast<std::streamsize>(_block.size()));
+    _block.clear();
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "InputMovie.h"
+
+// Writes a movie file one frame at a time, frames are flushed to disk block by block. The header's frame count is
+// patched when the recorder is destroyed.
+class InputMovieRecorder
+{
+public:
+    InputMovieRecorder(const std::string& filePath, unsigned short framesPerSecond, word romChecksum);
+    ~InputMovieRecorder();
+
+    [[nodiscard]] bool IsValid() const { return _file.good(); }
+    [[nodiscard]] unsigned int GetFrameCount() const { return _header.frameCount; }
+
+    void WriteFrame(byte buttons);
+
+private:
+    void WriteHeader();
+    void FlushBlock();
+
+    std::ofstream _file;
+    InputMovie::Header _header;
+    std::vector<byte> _block;
+};
@@ -0,0 +1,56 @@
+#include "Joypad.h"
+
+#include "Emulator/GbConstants.h"
+#include "Emulator/Memory/IoRegisters.h"
+
+namespace
+{
+    constexpr byte SelectDirectionsFlag = 0b00010000;
+    constexpr byte SelectActionsFlag = 0b00100000;
+    constexpr byte SelectMask = SelectDirectionsFlag | SelectActionsFlag;
+    constexpr byte LinesMask = 0b00001111;
+    constexpr byte UnusedBits = 0b11000000;
+}
+
+Joypad::Joypad(IoRegisters* ioRegisters) : _ioRegisters(ioRegisters)
+{
+}
+
+byte Joypad::Read(word busAddress) const
+{
+    return UnusedBits | _select | _lines;
+}
+
+void Joypad::Write(word busAddress, const byte data)
+{
+    _select = data & SelectMask;
+    UpdateLines();
+}
+
+void Joypad::SetButtons(const byte buttons)
+{
+    _buttons = buttons;
+    UpdateLines();
+}
+
+void Joypad::CopyStateFrom(const Joypad& other)
+{
+    _buttons = other._buttons;
+    _select = other._select;
+    _lines = other._lines;
+}
+
+void Joypad::UpdateLines()
+{
+    byte pressed = 0;
+    if (!(_select & SelectDirectionsFlag))
+        pressed |= _buttons & LinesMask;
+    if (!(_select & SelectActionsFlag))
+        pressed |= _buttons >> 4;
+
+    const byte lines = ~pressed & LinesMask;
+    if (_lines & ~lines)
+        _ioRegisters->RequestInterrupt(GbConstants::JoypadInterrupt);
+
+    _lines = lines;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Core/Definitions.h"
+
+class IoRegisters;
+
+// Button state bitmask, one bit per button, set when pressed. The low nibble maps to the direction lines and the high
+// nibble to the action lines, in the order the hardware exposes them.
+namespace JoypadButtons
+{
+    constexpr byte Right = 0b00000001;
+    constexpr byte Left = 0b00000010;
+    constexpr byte Up = 0b00000100;
+    constexpr byte Down = 0b00001000;
+    constexpr byte A = 0b00010000;
+    constexpr byte B = 0b00100000;
+    constexpr byte Select = 0b01000000;
+    constexpr byte Start = 0b10000000;
+}
+
+// P1 register. The 4 input lines are active low and only reflect the groups selected by bits 4 and 5. The joypad
+// interrupt is requested whenever a line goes from high to low, either from a button press or from a selection change.
+class Joypad
+{
+public:
+    explicit Joypad(IoRegisters* ioRegisters);
+
+    [[nodiscard]] byte Read(word busAddress) const;
+    void Write(word busAddress, byte data);
+
+    [[nodiscard]] byte GetButtons() const { return _buttons; }
+    void SetButtons(byte buttons);
+    void CopyStateFrom(const Joypad& other);
+
+private:
+    void UpdateLines();
+
+    IoRegisters* _ioRegisters;
+
+    byte _buttons = 0;
+    byte _select = 0b00110000;
+    byte _lines = 0b00001111;
+};
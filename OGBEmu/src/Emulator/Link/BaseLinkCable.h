@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Core/Definitions.h"
+
+enum class LinkMessageType : byte
+{
+    // Sender's emulated time, lets the other side know how far it may run ahead
+    Time,
+    // A transfer clocked by the sender, exchanged at the given cycle
+    Transfer,
+    // The receiver's shift register contents for the last transfer
+    Reply,
+    Disconnect,
+};
+
+struct LinkMessage
+{
+    LinkMessageType type;
+    byte data;
+    unsigned long long cycle;
+};
+
+// One end of a link cable. Messages arrive in the order they were sent.
+class BaseLinkCable
+{
+public:
+    virtual ~BaseLinkCable() = default;
+
+    virtual void Send(const LinkMessage& message) = 0;
+    // Returns false if no message is available and wait is false. A closed connection reads as a Disconnect message.
+    virtual bool Receive(LinkMessage& message, bool wait) = 0;
+};
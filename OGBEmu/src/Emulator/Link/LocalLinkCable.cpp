@@ -0,0 +1,38 @@
+#include "LocalLinkCable.h"
+
+std::pair<std::unique_ptr<LocalLinkCable>, std::unique_ptr<LocalLinkCable>> LocalLinkCable::CreatePair()
+{
+    const std::shared_ptr<SharedState> sharedState = std::make_shared<SharedState>();
+
+    return {std::unique_ptr<LocalLinkCable>(new LocalLinkCable(sharedState, 0)), std::unique_ptr<LocalLinkCable>(new LocalLinkCable(sharedState, 1))};
+}
+
+LocalLinkCable::LocalLinkCable(std::shared_ptr<SharedState> sharedState, const int end) : _sharedState(std::move(sharedState)), _end(end)
+{
+}
+
+void LocalLinkCable::Send(const LinkMessage& message)
+{
+    {
+        std::lock_guard lock(_sharedState->mutex);
+        _sharedState->queues[1 - _end].push_back(message);
+    }
+
+    _sharedState->messageSent.notify_all();
+}
+
+bool LocalLinkCable::Receive(LinkMessage& message, const bool wait)
+{
+    std::unique_lock lock(_sharedState->mutex);
+    std::deque<LinkMessage>& queue = _sharedState->queues[_end];
+
+    if (wait)
+        _sharedState->messageSent.wait(lock, [&queue] { return !queue.empty(); });
+    else if (queue.empty())
+        return false;
+
+    message = queue.front();
+    queue.pop_front();
+
+    return true;
+}
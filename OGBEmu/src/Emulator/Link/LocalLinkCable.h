@@ -0,0 +1,32 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "BaseLinkCable.h"
+
+// Link cable between two devices in the same process, each end is used from its device's thread
+class LocalLinkCable final : public BaseLinkCable
+{
+public:
+    static std::pair<std::unique_ptr<LocalLinkCable>, std::unique_ptr<LocalLinkCable>> CreatePair();
+
+    void Send(const LinkMessage& message) override;
+    bool Receive(LinkMessage& message, bool wait) override;
+
+private:
+    struct SharedState
+    {
+        std::mutex mutex;
+        std::condition_variable messageSent;
+        std::deque<LinkMessage> queues[2];
+    };
+
+    LocalLinkCable(std::shared_ptr<SharedState> sharedState, int end);
+
+    std::shared_ptr<SharedState> _sharedState;
+    int _end;
+};
@@ -0,0 +1,171 @@
+#include "SocketLinkCable.h"
+
+#include "Core/Logger.h"
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Type, data and the cycle as 8 little endian bytes
+    constexpr unsigned int MessageSize = 10;
+}
+
+#ifdef _WIN32
+
+SocketLinkCable::SocketLinkCable(const int socket) : _socket(socket)
+{
+}
+
+SocketLinkCable::~SocketLinkCable() = default;
+
+std::unique_ptr<SocketLinkCable> SocketLinkCable::Listen(const std::string& socketPath)
+{
+    LOG("Socket link cable is not supported on Windows");
+    return nullptr;
+}
+
+std::unique_ptr<SocketLinkCable> SocketLinkCable::Connect(const std::string& socketPath)
+{
+    LOG("Socket link cable is not supported on Windows");
+    return nullptr;
+}
+
+void SocketLinkCable::Send(const LinkMessage& message)
+{
+}
+
+bool SocketLinkCable::Receive(LinkMessage& message, const bool wait)
+{
+    message = {LinkMessageType::Disconnect, 0, 0};
+    return true;
+}
+
+bool SocketLinkCable::ReadExactly(byte* buffer, const unsigned int size) const
+{
+    return false;
+}
+
+#else
+
+SocketLinkCable::SocketLinkCable(const int socket) : _socket(socket)
+{
+}
+
+SocketLinkCable::~SocketLinkCable()
+{
+    close(_socket);
+}
+
+std::unique_ptr<SocketLinkCable> SocketLinkCable::Listen(const std::string& socketPath)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    socketPath.copy(address.sun_path, sizeof(address.sun_path) - 1);
+
+    const int listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socketPath.c_str());
+
+    if (listenSocket < 0 || bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listenSocket, 1) != 0)
+    {
+        LOG("Error listening on link socket " << socketPath);
+        if (listenSocket >= 0)
+            close(listenSocket);
+        return nullptr;
+    }
+
+    LOG("Waiting for link cable connection on " << socketPath);
+    const int connectionSocket = accept(listenSocket, nullptr, nullptr);
+    close(listenSocket);
+    unlink(socketPath.c_str());
+
+    if (connectionSocket < 0)
+    {
+        LOG("Error accepting link cable connection on " << socketPath);
+        return nullptr;
+    }
+
+    return std::unique_ptr<SocketLinkCable>(new SocketLinkCable(connectionSocket));
+}
+
+std::unique_ptr<SocketLinkCable> SocketLinkCable::Connect(const std::string& socketPath)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    socketPath.copy(address.sun_path, sizeof(address.sun_path) - 1);
+
+    const int connectionSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (connectionSocket < 0 || connect(connectionSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        LOG("Error connecting to link socket " << socketPath);
+        if (connectionSocket >= 0)
+            close(connectionSocket);
+        return nullptr;
+    }
+
+    return std::unique_ptr<SocketLinkCable>(new SocketLinkCable(connectionSocket));
+}
+
+void SocketLinkCable::Send(const LinkMessage& message)
+{
+    byte buffer[MessageSize];
+    buffer[0] = static_cast<byte>(message.type);
+    buffer[1] = message.data;
+    for (int i = 0; i < 8; i++)
+        buffer[2 + i] = static_cast<byte>(message.cycle >> (i * 8));
+
+    unsigned int sent = 0;
+    while (sent < MessageSize)
+    {
+        const ssize_t result = send(_socket, buffer + sent, MessageSize - sent, MSG_NOSIGNAL);
+        if (result <= 0)
+            return;
+        sent += static_cast<unsigned int>(result);
+    }
+}
+
+bool SocketLinkCable::Receive(LinkMessage& message, const bool wait)
+{
+    if (!wait)
+    {
+        pollfd pollDescriptor{_socket, POLLIN, 0};
+        if (poll(&pollDescriptor, 1, 0) <= 0)
+            return false;
+    }
+
+    byte buffer[MessageSize];
+    if (!ReadExactly(buffer, MessageSize))
+    {
+        message = {LinkMessageType::Disconnect, 0, 0};
+        return true;
+    }
+
+    message.type = static_cast<LinkMessageType>(buffer[0]);
+    message.data = buffer[1];
+    message.cycle = 0;
+    for (int i = 0; i < 8; i++)
+        message.cycle |= static_cast<unsigned long long>(buffer[2 + i]) << (i * 8);
+
+    return true;
+}
+
+bool SocketLinkCable::ReadExactly(byte* buffer, const unsigned int size) const
+{
+    unsigned int received = 0;
+    while (received < size)
+    {
+        const ssize_t result = recv(_socket, buffer + received, size - received, 0);
+        if (result <= 0)
+            return false;
+        received += static_cast<unsigned int>(result);
+    }
+
+    return true;
+}
+
+#endif
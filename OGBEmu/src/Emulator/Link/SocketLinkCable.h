@@ -0,0 +1,27 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "BaseLinkCable.h"
+
+// Link cable to a device in another process over a Unix domain socket. One side listens on the socket path and
+// the other connects to it.
+class SocketLinkCable final : public BaseLinkCable
+{
+public:
+    ~SocketLinkCable() override;
+
+    static std::unique_ptr<SocketLinkCable> Listen(const std::string& socketPath);
+    static std::unique_ptr<SocketLinkCable> Connect(const std::string& socketPath);
+
+    void Send(const LinkMessage& message) override;
+    bool Receive(LinkMessage& message, bool wait) override;
+
+private:
+    explicit SocketLinkCable(int socket);
+
+    bool ReadExactly(byte* buffer, unsigned int size) const;
+
+    int _socket;
+};
@@ -0,0 +1,110 @@
+#include "LockstepRunner.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "Emulator/Device.h"
+
+LockstepRunner::LockstepRunner(const std::vector<byte>& cartridgeBytes, const unsigned int laneCount, const int framesPerSecond,
+                               const unsigned int threadCount) : _cartridgeBytes(std::make_shared<const std::vector<byte>>(cartridgeBytes)),
+                                                                 _framesPerSecond(framesPerSecond),
+                                                                 _threadCount(threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency())),
+                                                                 _laneButtons(laneCount),
+                                                                 _laneGroups(laneCount)
+{
+    _groups.emplace_back().device = CreateDevice();
+}
+
+LockstepRunner::~LockstepRunner() = default;
+
+bool LockstepRunner::IsValid() const
+{
+    return !_laneGroups.empty() && _groups[0].device->IsValid();
+}
+
+void LockstepRunner::RunFrame()
+{
+    SplitGroups();
+
+    const unsigned int threadCount = std::min(_threadCount, GetGroupCount());
+    if (threadCount <= 1)
+    {
+        RunGroups(0, 1);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (unsigned int i = 1; i < threadCount; i++)
+        threads.emplace_back(&LockstepRunner::RunGroups, this, i, threadCount);
+
+    RunGroups(0, threadCount);
+
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+const Device& LockstepRunner::GetDevice(const unsigned int lane) const
+{
+    return *_groups[_laneGroups[lane]].device;
+}
+
+void LockstepRunner::SplitGroups()
+{
+    const unsigned int groupCount = GetGroupCount();
+    std::vector<bool> hasButtons(groupCount);
+
+    for (unsigned int lane = 0; lane < _laneGroups.size(); lane++)
+    {
+        const unsigned int groupIndex = _laneGroups[lane];
+        const byte buttons = _laneButtons[lane];
+
+        if (!hasButtons[groupIndex])
+        {
+            hasButtons[groupIndex] = true;
+            _groups[groupIndex].buttons = buttons;
+            continue;
+        }
+
+        if (_groups[groupIndex].buttons == buttons)
+            continue;
+
+        const std::vector<unsigned int>& splits = _groups[groupIndex].splits;
+        const auto split = std::ranges::find_if(splits, [this, buttons](const unsigned int index) { return _groups[index].buttons == buttons; });
+        if (split != splits.end())
+        {
+            _laneGroups[lane] = *split;
+            continue;
+        }
+
+        // Still before the frame runs, so the fork has the state every lane of the group shares
+        std::unique_ptr<Device> device = _groups[groupIndex].device->Fork();
+
+        const auto newIndex = static_cast<unsigned int>(_groups.size());
+        Group& group = _groups.emplace_back();
+        group.device = std::move(device);
+        group.buttons = buttons;
+
+        _groups[groupIndex].splits.push_back(newIndex);
+        _laneGroups[lane] = newIndex;
+    }
+
+    for (Group& group : _groups)
+    {
+        group.splits.clear();
+        group.device->SetButtons(group.buttons);
+    }
+}
+
+void LockstepRunner::RunGroups(const unsigned int firstGroup, const unsigned int groupStep)
+{
+    for (unsigned int i = firstGroup; i < _groups.size(); i += groupStep)
+        _groups[i].device->RunFrame();
+}
+
+std::unique_ptr<Device> LockstepRunner::CreateDevice() const
+{
+    auto device = std::make_unique<Device>(std::vector<byte>(), _cartridgeBytes, _framesPerSecond);
+    device->SetHeadless(true);
+    return device;
+}
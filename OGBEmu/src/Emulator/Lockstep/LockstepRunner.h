@@ -0,0 +1,54 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Core/Definitions.h"
+
+class Device;
+
+// Runs many copies of one cartridge with their own input, a frame at a time on every lane. Emulation is
+// deterministic, so lanes that got the same buttons on every frame so far are in the same state: they share a device
+// and each frame runs once for all of them. When their buttons differ the group splits, every new group starting from
+// a fork of its device. Groups that split run on their own, spread over the worker threads.
+class LockstepRunner
+{
+public:
+    // Every lane starts from the state right after the boot ROM. A thread count of 0 uses one per hardware thread.
+    LockstepRunner(const std::vector<byte>& cartridgeBytes, unsigned int laneCount, int framesPerSecond, unsigned int threadCount = 1);
+    ~LockstepRunner();
+
+    [[nodiscard]] bool IsValid() const;
+    [[nodiscard]] unsigned int GetLaneCount() const { return static_cast<unsigned int>(_laneGroups.size()); }
+    // Distinct states among the lanes, which is how many devices a frame runs
+    [[nodiscard]] unsigned int GetGroupCount() const { return static_cast<unsigned int>(_groups.size()); }
+
+    // Used from the next frame on, like Device::SetButtons
+    void SetButtons(const unsigned int lane, const byte buttons) { _laneButtons[lane] = buttons; }
+    void RunFrame();
+
+    // Shared by every lane of its group, until a later frame splits it
+    [[nodiscard]] const Device& GetDevice(unsigned int lane) const;
+
+private:
+    struct Group
+    {
+        std::unique_ptr<Device> device;
+        // Of the lanes in the group, set by the first one for each frame
+        byte buttons = 0;
+        // Groups split from this one for the coming frame, by buttons
+        std::vector<unsigned int> splits;
+    };
+
+    void SplitGroups();
+    void RunGroups(unsigned int firstGroup, unsigned int groupStep);
+    [[nodiscard]] std::unique_ptr<Device> CreateDevice() const;
+
+    std::shared_ptr<const std::vector<byte>> _cartridgeBytes;
+    int _framesPerSecond;
+    unsigned int _threadCount;
+
+    std::vector<byte> _laneButtons;
+    std::vector<unsigned int> _laneGroups;
+    std::vector<Group> _groups;
+};
@@ -5,6 +5,8 @@
 namespace AddressConstants
 {
     // Cartridge rom addresses
+    constexpr word CartridgeLogoStartAddress = 0x104;
+    constexpr word CartridgeLogoEndAddress = 0x133;
     constexpr word CartridgeTitleStartAddress = 0x134;
     constexpr word CartridgeTitleNewEndAddress = 0x13F;
     constexpr word CartridgeTitleOldEndAddress = 0x143;
@@ -53,9 +55,39 @@ namespace AddressConstants
     constexpr word EndIeAddress = 0xFFFF;
 
     // IO addresses
+    constexpr word Joypad = 0xFF00;
+    constexpr word SerialData = 0xFF01;
+    constexpr word SerialControl = 0xFF02;
+    constexpr word Div = 0xFF04;
+    constexpr word Tima = 0xFF05;
+    constexpr word Tma = 0xFF06;
+    constexpr word Tac = 0xFF07;
     constexpr word InterruptFlag = 0xFF0F;
+    constexpr word StartApuAddress = 0xFF10;
+    constexpr word EndApuAddress = 0xFF3F;
+    constexpr word ApuControl = 0xFF26;
+    constexpr word StartWaveRamAddress = 0xFF30;
+    constexpr word Lcdc = 0xFF40;
+    constexpr word LcdStatus = 0xFF41;
+    constexpr word Scy = 0xFF42;
+    constexpr word Scx = 0xFF43;
+    constexpr word Ly = 0xFF44;
+    constexpr word Lyc = 0xFF45;
     constexpr word DmaStart = 0xFF46;
+    constexpr word Bgp = 0xFF47;
+    constexpr word Obp0 = 0xFF48;
+    constexpr word Obp1 = 0xFF49;
+    constexpr word Wy = 0xFF4A;
+    constexpr word Wx = 0xFF4B;
+    constexpr word Key1 = 0xFF4D;
+    constexpr word VRamBank = 0xFF4F;
     constexpr word BootRomBank = 0xFF50;
+    constexpr word Hdma1 = 0xFF51;
+    constexpr word Hdma2 = 0xFF52;
+    constexpr word Hdma3 = 0xFF53;
+    constexpr word Hdma4 = 0xFF54;
+    constexpr word Hdma5 = 0xFF55;
+    constexpr word WRamBank = 0xFF70;
 
     // Interrupt handler addresses (ISR)
     constexpr word VBlankHandlerAddress = 0x40;
@@ -6,7 +6,8 @@
 
 BootRom::BootRom(const std::vector<byte>& romBytes): _rom(romBytes)
 {
-    if (!IsValid())
+    // No boot ROM at all means the device skips it
+    if (!_rom.empty() && !IsValid())
     {
         DEBUGBREAKLOG("Invalid boot ROM, check path and file size. Only " << GbConstants::BootRomSize <<"-byte ROMs are accepted.");
         return;
@@ -13,6 +13,7 @@ public:
 
     [[nodiscard]] bool IsValid() const { return !_rom.empty() && _rom.size() == GbConstants::BootRomSize; }
     [[nodiscard]] byte Read(word address) const;
+    [[nodiscard]] const std::vector<byte>& GetBytes() const { return _rom; }
 
 private:
     std::vector<byte> _rom;
@@ -1,26 +1,42 @@
 #include "Bus.h"
 
+#include <cstring>
 #include <format>
 
-#include "EchoRam.h"
 #include "WRamCgb.h"
 #include "Core/Logger.h"
 
+#include "Emulator/GbConstants.h"
+#include "Emulator/Joypad.h"
+#include "Emulator/Serial.h"
+#include "Emulator/Timer.h"
+#include "Emulator/Audio/Apu.h"
 #include "Emulator/Memory/AddressConstants.h"
 #include "Emulator/Memory/BootRom.h"
 #include "Emulator/Memory/Cartridge.h"
+#include "Emulator/Memory/Hdma.h"
 #include "Emulator/Memory/HRam.h"
 #include "Emulator/Memory/IoRegisters.h"
 #include "Emulator/Memory/Oam.h"
 #include "Emulator/Memory/VRam.h"
 #include "Emulator/Memory/WRam.h"
 
-Bus::Bus(BootRom* bootRom, Cartridge* cartridge, VRam* vRam, WRam* wRam, WRamCgb* wRamCgb, EchoRam* echoRam, Oam* oam,
-         IoRegisters* ioRegisters, HRam* hRam) : _bootRom(bootRom),
-                                                 _cartridge(cartridge), _vRam(vRam), _wRam(wRam), _wRamCgb(wRamCgb), _echoRam(echoRam),
+namespace
+{
+    // Bits that always read back as 1
+    constexpr byte Key1ReadMask = 0x7E;
+    constexpr byte VRamBankReadMask = 0xFE;
+    constexpr byte WRamBankReadMask = 0xF8;
+
+    constexpr word EchoRamOffset = AddressConstants::StartEchoRamAddress - AddressConstants::StartWRamAddress;
+}
+
+Bus::Bus(BootRom* bootRom, Cartridge* cartridge, VRam* vRam, WRam* wRam, WRamCgb* wRamCgb, Oam* oam,
+         IoRegisters* ioRegisters, HRam* hRam, Joypad* joypad, Serial* serial, Timer* timer, Apu* apu, Hdma* hdma) : _bootRom(bootRom),
+                                                 _cartridge(cartridge), _vRam(vRam), _wRam(wRam), _wRamCgb(wRamCgb),
                                                  _oam(oam),
                                                  _ioRegisters(ioRegisters),
-                                                 _hRam(hRam), _ie(0)
+                                                 _hRam(hRam), _joypad(joypad), _serial(serial), _timer(timer), _apu(apu), _hdma(hdma), _ie(0)
 {
 }
 
@@ -83,6 +99,23 @@ void Bus::Write(const word address, const byte data)
         return WriteIe(address, data);
 
     DEBUGBREAKLOG("Trying to write unmapped area, address " << std::format("{:x}", address));
+    RecordFault(FaultType::UnmappedWrite, address, data);
+}
+
+const byte* Bus::GetReadPointer(const word address) const
+{
+    if (address <= AddressConstants::EndRomBankNAddress)
+        return address <= AddressConstants::EndBootRomAddress && IsBootRomEnabled() ? nullptr : _cartridge->GetReadPointer(address);
+    if (address >= AddressConstants::StartVRamAddress && address <= AddressConstants::EndVRamAddress)
+        return _vRam->GetReadPointer(address);
+    if (address >= AddressConstants::StartExternalRamAddress && address <= AddressConstants::EndExternalRamAddress)
+        return _cartridge->GetReadPointer(address);
+    if (address >= AddressConstants::StartWRamAddress && address <= AddressConstants::EndWRamAddress)
+        return _wRam->GetReadPointer(address);
+    if (address >= AddressConstants::StartWRamCgbAddress && address <= AddressConstants::EndWRamCgbAddress)
+        return _wRamCgb->GetReadPointer(address);
+
+    return nullptr;
 }
 
 bool Bus::IsBootRomEnabled() const
@@ -135,7 +168,9 @@ byte Bus::ReadCgbWRam(const word address) const
 
 byte Bus::ReadEchoRam(const word address) const
 {
-    return _echoRam->Read(address);
+    // Mirrors the work RAM through the bus, so it follows the switched bank
+    DEBUGBREAKLOG("Invalid read EchoRam " << std::format("{:x}", address));
+    return Read(address - EchoRamOffset);
 }
 
 byte Bus::ReadOam(const word address) const
@@ -151,6 +186,17 @@ byte Bus::ReadNotUsed(const word address)
 
 byte Bus::ReadIoRegisters(const word address) const
 {
+    if (address == AddressConstants::Joypad)
+        return _joypad->Read(address);
+    if (address == AddressConstants::SerialData || address == AddressConstants::SerialControl)
+        return _serial->Read(address);
+    if (address >= AddressConstants::Div && address <= AddressConstants::Tac)
+        return _timer->Read(address);
+    if (address >= AddressConstants::StartApuAddress && address <= AddressConstants::EndApuAddress)
+        return _apu->Read(address);
+    if (address >= AddressConstants::Hdma1 && address <= AddressConstants::Hdma5 && _isCgbMode)
+        return _hdma->Read(address);
+
     return _ioRegisters->Read(address);
 }
 
@@ -200,25 +246,17 @@ void Bus::WriteExternalRam(const word address, const byte data) const
 void Bus::WriteWRam(const word address, const byte data) const
 {
     _wRam->Write(address, data);
-    
-    const word echoRamAddress = address + (AddressConstants::StartEchoRamAddress - AddressConstants::StartWRamAddress);
-    if (echoRamAddress <= AddressConstants::EndEchoRamAddress)
-        _echoRam->Write(echoRamAddress, data);
 }
 
 void Bus::WriteCgbWRam(const word address, const byte data) const
 {
     _wRamCgb->Write(address, data);
-
-    const word echoRamAddress = address + (AddressConstants::StartEchoRamAddress - AddressConstants::StartWRamAddress);
-    if (echoRamAddress <= AddressConstants::EndEchoRamAddress)
-        _echoRam->Write(echoRamAddress, data);
 }
 
 void Bus::WriteEchoRam(const word address, const byte data)
 {
     DEBUGBREAKLOG("Invalid write EchoRam " << std::format("{:x}", address));
-    Write(address - (AddressConstants::StartEchoRamAddress - AddressConstants::StartWRamAddress), data);
+    Write(address - EchoRamOffset, data);
 }
 
 void Bus::WriteOam(const word address, const byte data) const
@@ -229,16 +267,52 @@ void Bus::WriteOam(const word address, const byte data) const
 void Bus::WriteNotUsed(const word address, const byte data)
 {
     DEBUGBREAKLOG("Invalid write NotUsed " << std::format("{:x}", address));
+    RecordFault(FaultType::NotUsedWrite, address, data);
 }
 
 void Bus::WriteIoRegisters(const word address, const byte data)
 {
+    if (address == AddressConstants::Joypad)
+        return _joypad->Write(address, data);
+    if (address == AddressConstants::SerialData || address == AddressConstants::SerialControl)
+        return _serial->Write(address, data);
+    if (address >= AddressConstants::Div && address <= AddressConstants::Tac)
+        return _timer->Write(address, data);
+    if (address >= AddressConstants::StartApuAddress && address <= AddressConstants::EndApuAddress)
+        return _apu->Write(address, data);
+    if (address == AddressConstants::Key1 || address == AddressConstants::VRamBank || address == AddressConstants::WRamBank)
+        return WriteCgbRegister(address, data);
+    if (address >= AddressConstants::Hdma1 && address <= AddressConstants::Hdma5 && _isCgbMode)
+        return _hdma->Write(address, data);
+
     _ioRegisters->Write(address, data);
 
     if (address == AddressConstants::DmaStart)
         DoDma(data);
 }
 
+void Bus::WriteCgbRegister(const word address, const byte data)
+{
+    if (!_isCgbMode)
+        return;
+
+    // Only the switch request is writable, the current speed changes on STOP
+    if (address == AddressConstants::Key1)
+    {
+        const byte currentSpeed = _ioRegisters->Read(address) & GbConstants::Key1DoubleSpeed;
+        return _ioRegisters->Write(address, Key1ReadMask | currentSpeed | data & GbConstants::Key1SwitchRequest);
+    }
+
+    if (address == AddressConstants::VRamBank)
+    {
+        _vRam->SetBank(data);
+        return _ioRegisters->Write(address, VRamBankReadMask | data);
+    }
+
+    _wRamCgb->SetBank(data);
+    _ioRegisters->Write(address, WRamBankReadMask | data);
+}
+
 void Bus::WriteHRam(const word address, const byte data) const
 {
     _hRam->Write(address, data);
@@ -253,9 +327,23 @@ void Bus::DoDma(const byte data)
 {
     const word startAddress = static_cast<word>(data << 8);
     constexpr word oamRange = AddressConstants::EndOamAddress - AddressConstants::StartOamAddress + 1;
+    byte* oam = _oam->GetWritePointer(AddressConstants::StartOamAddress);
+
+    // The source starts a page and is shorter than one, so it never crosses a page boundary
+    if (const byte* source = GetReadPointer(startAddress))
+    {
+        std::memcpy(oam, source, oamRange);
+        return;
+    }
 
     for (word i = 0; i < oamRange; i++)
     {
-        Write(AddressConstants::StartOamAddress + 0, Read(startAddress + i));
+        oam[i] = Read(static_cast<word>(startAddress + i));
     }
 }
+
+void Bus::RecordFault(const FaultType type, const word address, const byte data)
+{
+    if (!_fault.IsSet())
+        _fault = {type, address, data};
+}
@@ -2,24 +2,46 @@
 
 #include "Core/Definitions.h"
 
+#include "Emulator/Fault.h"
+
+class Apu;
+class Joypad;
+class Serial;
+class Timer;
 class WRamCgb;
 class HRam;
 class Oam;
-class EchoRam;
 class VRam;
 class IoRegisters;
 class BootRom;
 class Cartridge;
 class WRam;
+class Hdma;
 
 class Bus
 {
 public:
-    Bus(BootRom* bootRom, Cartridge* cartridge, VRam* vRam, WRam* wRam, WRamCgb* wRamCgb, EchoRam* echoRam, Oam* oam,
-        IoRegisters* ioRegisters, HRam* hRam);
+    Bus(BootRom* bootRom, Cartridge* cartridge, VRam* vRam, WRam* wRam, WRamCgb* wRamCgb, Oam* oam,
+        IoRegisters* ioRegisters, HRam* hRam, Joypad* joypad, Serial* serial, Timer* timer, Apu* apu, Hdma* hdma);
     
     [[nodiscard]] byte Read(word address) const;
     void Write(word address, byte data);
+    // Host memory behind the address, contiguous up to the next 256 byte boundary, or null when reads there aren't
+    // plain memory. Only for bulk transfers, which fall back to Read otherwise.
+    [[nodiscard]] const byte* GetReadPointer(word address) const;
+
+    // The CGB registers only exist in CGB mode, the DMG ignores writes to them
+    void SetCgbMode(const bool isCgbMode) { _isCgbMode = isCgbMode; }
+    // Only the bus' own registers, the components behind it are copied on their own
+    void CopyStateFrom(const Bus& other)
+    {
+        _ie = other._ie;
+        _isCgbMode = other._isCgbMode;
+        _fault = other._fault;
+    }
+    // The first write to an unused or unmapped address since the fault was last cleared
+    [[nodiscard]] const Fault& GetFault() const { return _fault; }
+    void ClearFault() { _fault = {}; }
 
 private:
     [[nodiscard]] bool IsBootRomEnabled() const;
@@ -47,21 +69,29 @@ private:
     void WriteCgbWRam(word address, byte data) const;
     void WriteEchoRam(word address, byte data);
     void WriteOam(word address, byte data) const;
-    static void WriteNotUsed(word address, byte data);
+    void WriteNotUsed(word address, byte data);
     void WriteIoRegisters(word address, byte data);
+    void WriteCgbRegister(word address, byte data);
     void WriteHRam(word address, byte data) const;
     void WriteIe(word address, byte data);
 
     void DoDma(byte data);
+    void RecordFault(FaultType type, word address, byte data);
     
     BootRom* _bootRom;
     Cartridge* _cartridge;
     VRam* _vRam;
     WRam* _wRam;
     WRamCgb* _wRamCgb;
-    EchoRam* _echoRam;
     Oam* _oam;
     IoRegisters* _ioRegisters;
     HRam* _hRam;
+    Joypad* _joypad;
+    Serial* _serial;
+    Timer* _timer;
+    Apu* _apu;
+    Hdma* _hdma;
     byte _ie;
+    bool _isCgbMode = false;
+    Fault _fault;
 };
@@ -9,7 +9,11 @@
 #include "Emulator/Memory/MBC/Mbc1.h"
 #include "Emulator/Memory/MBC/NoMbc.h"
 
-Cartridge::Cartridge(const std::vector<byte>& romBytes) : _rom(romBytes)
+Cartridge::Cartridge(const std::vector<byte>& romBytes) : Cartridge(std::make_shared<const std::vector<byte>>(romBytes))
+{
+}
+
+Cartridge::Cartridge(std::shared_ptr<const std::vector<byte>> romBytes) : _romBytes(std::move(romBytes)), _rom(*_romBytes)
 {
     if (!IsValid())
     {
@@ -97,11 +101,33 @@ byte Cartridge::Read(const word address) const
     return _mbc->Read(address);
 }
 
+const byte* Cartridge::GetReadPointer(const word address) const
+{
+    return _mbc->GetReadPointer(address);
+}
+
 void Cartridge::Write(const word address, const byte data) const
 {
     _mbc->Write(address, data);
 }
 
+void Cartridge::CopyStateFrom(const Cartridge& other)
+{
+    if (_mbc && other._mbc)
+        _mbc->CopyStateFrom(*other._mbc);
+}
+
+void Cartridge::ShareStateFrom(Cartridge& other)
+{
+    if (_mbc && other._mbc)
+        _mbc->ShareStateFrom(*other._mbc);
+}
+
+word Cartridge::GetGlobalChecksum() const
+{
+    return static_cast<word>(_rom[AddressConstants::CartridgeGlobalChecksumAddressStart] << 8 | _rom[AddressConstants::CartridgeGlobalChecksumAddressEnd]);
+}
+
 std::string Cartridge::GetStringFromHeader(const word startAddress, const word endAddress) const
 {
     std::stringstream stringStream;
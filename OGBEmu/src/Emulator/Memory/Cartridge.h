@@ -1,11 +1,13 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "Core/Definitions.h"
 
 #include "Emulator/GbConstants.h"
+#include "Emulator/Memory/AddressConstants.h"
 
 class BaseMbc;
 
@@ -45,16 +47,33 @@ class Cartridge
 {
 public:
     explicit Cartridge(const std::vector<byte>& romBytes);
+    // Cartridges of the same ROM can share it
+    explicit Cartridge(std::shared_ptr<const std::vector<byte>> romBytes);
     ~Cartridge();
 
     [[nodiscard]] bool IsValid() const;
     [[nodiscard]] byte Read(word address) const;
     void Write(word address, byte data) const;
+    // See BaseMbc::GetReadPointer
+    [[nodiscard]] const byte* GetReadPointer(word address) const;
+    // Takes the banking state and RAM of a cartridge of the same ROM
+    void CopyStateFrom(const Cartridge& other);
+    // Same, sharing the RAM until either cartridge writes to it
+    void ShareStateFrom(Cartridge& other);
+
+    [[nodiscard]] const std::shared_ptr<const std::vector<byte>>& GetRomBytes() const { return _romBytes; }
+    [[nodiscard]] const byte* GetRomData() const { return _rom.data(); }
+    [[nodiscard]] size_t GetRomSize() const { return _rom.size(); }
+    [[nodiscard]] word GetGlobalChecksum() const;
+    [[nodiscard]] byte GetHeaderChecksum() const { return _rom[AddressConstants::CartridgeHeaderChecksumAddress]; }
+    // Cartridges that also run on a DMG only set the CGB flag's upper bit
+    [[nodiscard]] bool IsCgbOnly() const { return _rom[AddressConstants::CartridgeCgbFlagAddress] == GbConstants::CgbFlag; }
 
 private:
     [[nodiscard]] std::string GetStringFromHeader(word startAddress, word endAddress) const;
     
-    std::vector<byte> _rom;
+    std::shared_ptr<const std::vector<byte>> _romBytes;
+    const std::vector<byte>& _rom;
     BaseMbc* _mbc = nullptr;
     
     CartridgeType _cartridgeType;
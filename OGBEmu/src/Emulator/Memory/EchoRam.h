@@ -1,19 +0,0 @@
-#pragma once
-
-#include <vector>
-
-#include "Core/Definitions.h"
-
-class EchoRam
-{
-public:
-    EchoRam();
-    
-    [[nodiscard]] byte Read(word busAddress) const;
-    void Write(word busAddress, byte data);
-
-private:
-    static word TranslateAddress(word busAddress);
-
-    std::vector<byte> _bytes;
-};
\ No newline at end of file
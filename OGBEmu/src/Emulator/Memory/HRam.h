@@ -1,9 +1,9 @@
 #pragma once
 
-#include <vector>
-
 #include "Core/Definitions.h"
 
+#include "Emulator/Memory/PagedMemory.h"
+
 class HRam
 {
 public:
@@ -11,9 +11,11 @@ public:
     
     [[nodiscard]] byte Read(word busAddress) const;
     void Write(word busAddress, byte data);
+    // Both end up sharing the page until one of them writes to it
+    void ShareStateFrom(HRam& other) { _bytes.ShareFrom(other._bytes); }
 
 private:
     static word TranslateAddress(word busAddress);
 
-    std::vector<byte> _bytes;
+    PagedMemory _bytes;
 };
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "Hdma.h"
+
+#include <cstring>
+#include <utility>
+
+#include "Emulator/Scheduler.h"
+#include "Emulator/Memory/AddressConstants.h"
+#include "Emulator/Memory/Bus.h"
+#include "Emulator/Memory/IoRegisters.h"
+#include "Emulator/Memory/VRam.h"
+
+namespace
+{
+    constexpr word BlockSize = 0x10;
+    constexpr word SourceMask = 0xFFF0;
+    constexpr word DestinationMask = 0x1FF0;
+
+    constexpr byte HBlankModeFlag = 0b10000000;
+    constexpr byte BlockCountMask = 0b01111111;
+    constexpr byte LcdEnableFlag = 0b10000000;
+
+    // 8 M-cycles per block, which is twice as many CPU cycles in double speed
+    constexpr unsigned int BlockStallCycles = 32;
+
+    // In normal speed cycles
+    constexpr unsigned int CyclesPerLine = 456;
+    constexpr unsigned int HBlankStartCycle = 252;
+    constexpr unsigned int VisibleLineCount = 144;
+    constexpr unsigned int LineCount = 154;
+}
+
+Hdma::Hdma(Scheduler* scheduler, Bus* bus, VRam* vRam, IoRegisters* ioRegisters) : _scheduler(scheduler), _bus(bus),
+                                                                                   _vRam(vRam),
+                                                                                   _ioRegisters(ioRegisters)
+{
+}
+
+byte Hdma::Read(const word busAddress) const
+{
+    // The addresses are write only
+    if (busAddress != AddressConstants::Hdma5)
+        return 0xFF;
+
+    const byte remaining = static_cast<byte>(_remainingBlocks - 1 & BlockCountMask);
+    if (_isHBlankTransferActive)
+        return remaining;
+
+    // Finished transfers read 0xFF, stopped ones keep their remaining length with the upper bit set
+    return _remainingBlocks == 0 ? 0xFF : HBlankModeFlag | remaining;
+}
+
+void Hdma::Write(const word busAddress, const byte data)
+{
+    switch (busAddress)
+    {
+    case AddressConstants::Hdma1:
+        _source = static_cast<word>(data << 8 | _source & 0x00FF);
+        break;
+    case AddressConstants::Hdma2:
+        _source = static_cast<word>(_source & 0xFF00 | data) & SourceMask;
+        break;
+    case AddressConstants::Hdma3:
+        _destination = static_cast<word>(data << 8 | _destination & 0x00FF) & DestinationMask;
+        break;
+    case AddressConstants::Hdma4:
+        _destination = static_cast<word>(_destination & 0xFF00 | data) & DestinationMask;
+        break;
+    default:
+        if (_isHBlankTransferActive && !(data & HBlankModeFlag))
+            StopHBlankTransfer();
+        else if (data & HBlankModeFlag)
+            StartHBlankTransfer(data & BlockCountMask);
+        else
+            StartGeneralPurposeTransfer(data & BlockCountMask);
+        break;
+    }
+}
+
+void Hdma::OnHBlankEvent()
+{
+    // Nothing is copied while the LCD is off, the HBlanks still go on in the background
+    if (_ioRegisters->Read(AddressConstants::Lcdc) & LcdEnableFlag)
+    {
+        TransferBlock();
+
+        if (_remainingBlocks == 0)
+        {
+            _isHBlankTransferActive = false;
+            return;
+        }
+    }
+
+    ScheduleNextHBlank();
+}
+
+void Hdma::SetDoubleSpeed(const bool isDoubleSpeed)
+{
+    _clock.SetDoubleSpeed(_scheduler->GetCurrentCycle(), isDoubleSpeed);
+    _isDoubleSpeed = isDoubleSpeed;
+
+    // The pending HBlank was scheduled in CPU cycles at the previous speed
+    if (_isHBlankTransferActive)
+        ScheduleNextHBlank();
+}
+
+unsigned int Hdma::TakeStallCycles()
+{
+    return std::exchange(_stallCycles, 0);
+}
+
+void Hdma::CopyStateFrom(const Hdma& other)
+{
+    _clock = other._clock;
+    _isDoubleSpeed = other._isDoubleSpeed;
+    _source = other._source;
+    _destination = other._destination;
+    _remainingBlocks = other._remainingBlocks;
+    _isHBlankTransferActive = other._isHBlankTransferActive;
+    _stallCycles = other._stallCycles;
+}
+
+void Hdma::StartGeneralPurposeTransfer(const byte blockCount)
+{
+    _remainingBlocks = blockCount + 1;
+    while (_remainingBlocks != 0)
+        TransferBlock();
+}
+
+void Hdma::StartHBlankTransfer(const byte blockCount)
+{
+    _remainingBlocks = blockCount + 1;
+    _isHBlankTransferActive = true;
+    ScheduleNextHBlank();
+}
+
+void Hdma::StopHBlankTransfer()
+{
+    _isHBlankTransferActive = false;
+    _scheduler->Cancel(SchedulerEvent::HBlankDma);
+}
+
+void Hdma::TransferBlock()
+{
+    byte* destination = _vRam->GetWritePointer(AddressConstants::StartVRamAddress + _destination);
+
+    // Blocks are aligned, so they never straddle two memory regions or banks
+    if (const byte* source = _bus->GetReadPointer(_source))
+    {
+        std::memcpy(destination, source, BlockSize);
+    }
+    else
+    {
+        for (word i = 0; i < BlockSize; i++)
+            destination[i] = _bus->Read(static_cast<word>(_source + i));
+    }
+
+    _source = static_cast<word>(_source + BlockSize);
+    _destination = static_cast<word>(_destination + BlockSize) & DestinationMask;
+    _remainingBlocks--;
+    _stallCycles += BlockStallCycles << (_isDoubleSpeed ? 1 : 0);
+}
+
+void Hdma::ScheduleNextHBlank() const
+{
+    const unsigned long long cycle = _clock.FromCpuCycle(_scheduler->GetCurrentCycle());
+    const unsigned long long lineStart = cycle - cycle % CyclesPerLine;
+
+    unsigned long long nextHBlank = lineStart + HBlankStartCycle;
+    if (nextHBlank <= cycle)
+        nextHBlank += CyclesPerLine;
+
+    // Skip the VBlank lines
+    const unsigned long long line = nextHBlank / CyclesPerLine % LineCount;
+    if (line >= VisibleLineCount)
+        nextHBlank += (LineCount - line) * CyclesPerLine;
+
+    _scheduler->Schedule(SchedulerEvent::HBlankDma, _clock.ToCpuCycle(nextHBlank));
+}
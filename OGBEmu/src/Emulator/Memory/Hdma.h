@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Core/Definitions.h"
+
+#include "Emulator/NormalSpeedClock.h"
+
+class Bus;
+class IoRegisters;
+class Scheduler;
+class VRam;
+
+// CGB VRAM DMA. General purpose transfers copy everything at once when HDMA5 is written, HBlank transfers copy one
+// 16 byte block at the start of each visible line's HBlank. Blocks are copied straight between host memory whenever
+// the source resolves to it. The CPU is stalled while blocks are copied, the device takes the stalled cycles after
+// each instruction.
+//
+// There's no PPU yet, so HBlanks follow a free running LCD started at power on.
+class Hdma
+{
+public:
+    Hdma(Scheduler* scheduler, Bus* bus, VRam* vRam, IoRegisters* ioRegisters);
+
+    [[nodiscard]] byte Read(word busAddress) const;
+    void Write(word busAddress, byte data);
+
+    void OnHBlankEvent();
+    // The LCD, and so the HBlanks, keep running at normal speed
+    void SetDoubleSpeed(bool isDoubleSpeed);
+
+    [[nodiscard]] bool HasStallCycles() const { return _stallCycles != 0; }
+    [[nodiscard]] unsigned int TakeStallCycles();
+    void CopyStateFrom(const Hdma& other);
+
+private:
+    void StartGeneralPurposeTransfer(byte blockCount);
+    void StartHBlankTransfer(byte blockCount);
+    void StopHBlankTransfer();
+    void TransferBlock();
+    void ScheduleNextHBlank() const;
+
+    Scheduler* _scheduler;
+    Bus* _bus;
+    VRam* _vRam;
+    IoRegisters* _ioRegisters;
+
+    NormalSpeedClock _clock;
+    bool _isDoubleSpeed = false;
+
+    word _source = 0;
+    // Offset into the VRAM
+    word _destination = 0;
+    // Blocks left, HDMA5 shows it minus one
+    unsigned int _remainingBlocks = 0;
+    bool _isHBlankTransferActive = false;
+    unsigned int _stallCycles = 0;
+};
@@ -36,6 +36,11 @@ void IoRegisters::Write(const word busAddress, const byte data)
     _registers[internalAddress] = data;
 }
 
+void IoRegisters::RequestInterrupt(const byte interrupt)
+{
+    _registers[TranslateAddress(AddressConstants::InterruptFlag)] |= interrupt;
+}
+
 word IoRegisters::TranslateAddress(const word busAddress)
 {
     return busAddress - AddressConstants::StartIoRegistersAddress;
@@ -11,6 +11,7 @@ public:
     
     [[nodiscard]] byte Read(word busAddress) const;
     void Write(word busAddress, byte data);
+    void RequestInterrupt(byte interrupt);
 
 private:
     static word TranslateAddress(word busAddress);
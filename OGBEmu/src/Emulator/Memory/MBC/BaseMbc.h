@@ -9,4 +9,11 @@ public:
     
     virtual byte Read(word address) = 0;
     virtual void Write(word address, byte data) = 0;
+    // Memory a read of address comes from, contiguous until the next RAM page boundary (see PagedMemory). Null when
+    // reads aren't plain memory, such as disabled RAM.
+    [[nodiscard]] virtual const byte* GetReadPointer(word address) = 0;
+    // Takes the registers and RAM of a controller of the same kind, for the same ROM
+    virtual void CopyStateFrom(const BaseMbc& other) = 0;
+    // Same, but the RAM stays shared with the other controller until either one writes to it
+    virtual void ShareStateFrom(BaseMbc& other) = 0;
 };
@@ -3,19 +3,152 @@
 #include <format>
 
 #include "Core/Logger.h"
+#include "Emulator/GbConstants.h"
 
-Mbc1::Mbc1(std::vector<byte>* rom) : _rom(rom)
+#include "Emulator/Memory/AddressConstants.h"
+
+namespace
+{
+    constexpr unsigned int SwitchableRomBankSize = 16 * 1024;
+
+    constexpr word RamEnableEndAddress = 0x1FFF;
+    constexpr word RomBankEndAddress = 0x3FFF;
+    constexpr word UpperBankEndAddress = 0x5FFF;
+    constexpr word BankingModeEndAddress = 0x7FFF;
+
+    constexpr byte RamEnableValue = 0x0A;
+    constexpr byte RomBankMask = 0x1F;
+    constexpr byte UpperBankMask = 0x03;
+    constexpr byte RomBankUpperShift = 5;
+
+    unsigned int GetRamSize(const std::vector<byte>& rom)
+    {
+        const byte ramSizeFlag = rom[AddressConstants::CartridgeRamSizeAddress];
+
+        if (ramSizeFlag == GbConstants::RamSizeFlag1Bank)
+            return GbConstants::RamBankSize;
+        if (ramSizeFlag == GbConstants::RamSizeFlag4Bank)
+            return GbConstants::RamBankSize * 4;
+        if (ramSizeFlag != GbConstants::RamSizeFlagNoRam)
+            DEBUGBREAKLOG("Invalid Mbc1 RAM size: " << static_cast<int>(ramSizeFlag) << ", defaulting to no ram");
+
+        return 0;
+    }
+}
+
+Mbc1::Mbc1(const std::vector<byte>* rom) : _rom(rom), _ram(GetRamSize(*rom))
 {
+    _romBankCount = static_cast<unsigned int>(_rom->size()) / SwitchableRomBankSize;
+
+    UpdateOffsets();
 }
 
-byte Mbc1::Read(word address)
+byte Mbc1::Read(const word address)
 {
-    DEBUGBREAKLOG("Mbc1 ROM read not implemented, address: " << std::format("{:x}", address));
+    if (address <= AddressConstants::EndRomBank0Address)
+        return (*_rom)[_romBank0Offset + address];
 
+    if (address <= AddressConstants::EndRomBankNAddress)
+        return (*_rom)[_romBankNOffset + address - AddressConstants::StartRomBankNAddress];
+
+    if (address >= AddressConstants::StartExternalRamAddress && address <= AddressConstants::EndExternalRamAddress)
+    {
+        // Disabled or missing RAM reads as an open bus
+        if (!_isRamEnabled || _ram.IsEmpty())
+            return 0xFF;
+
+        return _ram.Read(_ramOffset + address - AddressConstants::StartExternalRamAddress);
+    }
+
+    DEBUGBREAKLOG("Invalid Mbc1 read, address: " << std::format("{:x}", address));
     return 0;
 }
 
-void Mbc1::Write(word address, byte data)
+const byte* Mbc1::GetReadPointer(const word address)
+{
+    if (address <= AddressConstants::EndRomBank0Address)
+        return &(*_rom)[_romBank0Offset + address];
+
+    if (address <= AddressConstants::EndRomBankNAddress)
+        return &(*_rom)[_romBankNOffset + address - AddressConstants::StartRomBankNAddress];
+
+    if (address >= AddressConstants::StartExternalRamAddress && address <= AddressConstants::EndExternalRamAddress && _isRamEnabled && !_ram.IsEmpty())
+        return _ram.GetReadPointer(_ramOffset + address - AddressConstants::StartExternalRamAddress);
+
+    return nullptr;
+}
+
+void Mbc1::Write(const word address, const byte data)
 {
-    DEBUGBREAKLOG("Mbc1 ROM write not implemented, address: " << std::format("{:x}", address));
+    if (address <= RamEnableEndAddress)
+    {
+        _isRamEnabled = (data & 0x0F) == RamEnableValue;
+        return;
+    }
+
+    if (address <= RomBankEndAddress)
+    {
+        _romBank = data & RomBankMask;
+        if (_romBank == 0)
+            _romBank = 1;
+
+        UpdateOffsets();
+        return;
+    }
+
+    if (address <= UpperBankEndAddress)
+    {
+        _upperBank = data & UpperBankMask;
+        UpdateOffsets();
+        return;
+    }
+
+    if (address <= BankingModeEndAddress)
+    {
+        _isAdvancedBankingMode = data & 1;
+        UpdateOffsets();
+        return;
+    }
+
+    if (address >= AddressConstants::StartExternalRamAddress && address <= AddressConstants::EndExternalRamAddress)
+    {
+        if (_isRamEnabled && !_ram.IsEmpty())
+            _ram.Write(_ramOffset + address - AddressConstants::StartExternalRamAddress, data);
+
+        return;
+    }
+
+    DEBUGBREAKLOG("Invalid Mbc1 write, address: " << std::format("{:x}", address));
+}
+
+void Mbc1::CopyStateFrom(const BaseMbc& other)
+{
+    const std::vector<byte>* rom = _rom;
+    *this = static_cast<const Mbc1&>(other);
+    _rom = rom;
+}
+
+void Mbc1::ShareStateFrom(BaseMbc& other)
+{
+    auto& otherMbc1 = static_cast<Mbc1&>(other);
+    _isRamEnabled = otherMbc1._isRamEnabled;
+    _romBank = otherMbc1._romBank;
+    _upperBank = otherMbc1._upperBank;
+    _isAdvancedBankingMode = otherMbc1._isAdvancedBankingMode;
+    _ram.ShareFrom(otherMbc1._ram);
+    UpdateOffsets();
+}
+
+void Mbc1::UpdateOffsets()
+{
+    // Bank numbers past the ROM size wrap around, as only the connected address lines are decoded
+    const unsigned int upperBankBits = static_cast<unsigned int>(_upperBank) << RomBankUpperShift;
+    const unsigned int bank0 = _isAdvancedBankingMode ? upperBankBits : 0;
+    const unsigned int bankN = upperBankBits | _romBank;
+
+    _romBank0Offset = bank0 % _romBankCount * SwitchableRomBankSize;
+    _romBankNOffset = bankN % _romBankCount * SwitchableRomBankSize;
+
+    const unsigned int ramBank = _isAdvancedBankingMode ? _upperBank : 0;
+    _ramOffset = _ram.IsEmpty() ? 0 : ramBank * GbConstants::RamBankSize % _ram.GetSize();
 }
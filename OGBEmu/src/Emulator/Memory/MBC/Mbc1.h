@@ -4,14 +4,35 @@
 
 #include "BaseMbc.h"
 
-class Mbc1 : public BaseMbc
+#include "Emulator/Memory/PagedMemory.h"
+
+class Mbc1 final : public BaseMbc
 {
 public:
-    explicit Mbc1(std::vector<byte>* rom);
+    explicit Mbc1(const std::vector<byte>* rom);
     
     byte Read(word address) override;
     void Write(word address, byte data) override;
+    [[nodiscard]] const byte* GetReadPointer(word address) override;
+    void CopyStateFrom(const BaseMbc& other) override;
+    void ShareStateFrom(BaseMbc& other) override;
 
 private:
-    std::vector<byte>* _rom;
+    // Offsets are recomputed when a banking register changes, reads only add the address to them
+    void UpdateOffsets();
+
+    const std::vector<byte>* _rom;
+    PagedMemory _ram;
+
+    bool _isRamEnabled = false;
+    // Lower 5 bits of the ROM bank, 0 selects 1
+    byte _romBank = 1;
+    // Upper ROM bank bits, or the RAM bank in advanced banking mode
+    byte _upperBank = 0;
+    bool _isAdvancedBankingMode = false;
+
+    unsigned int _romBankCount;
+    unsigned int _romBank0Offset = 0;
+    unsigned int _romBankNOffset = 0;
+    unsigned int _ramOffset = 0;
 };
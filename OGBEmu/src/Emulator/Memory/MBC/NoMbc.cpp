@@ -7,18 +7,23 @@
 
 #include "Emulator/Memory/AddressConstants.h"
 
-NoMbc::NoMbc(std::vector<byte>* rom) : _rom(rom)
+namespace
 {
-    const byte ramSizeFlag = (*_rom)[AddressConstants::CartridgeRamSizeAddress];
-    
-    if (ramSizeFlag == GbConstants::RamSizeFlag1Bank)
+    unsigned int GetRamSize(const std::vector<byte>& rom)
     {
-        _ram = std::vector<byte>(GbConstants::RamBankSize);
-        return;
+        const byte ramSizeFlag = rom[AddressConstants::CartridgeRamSizeAddress];
+
+        if (ramSizeFlag == GbConstants::RamSizeFlag1Bank)
+            return GbConstants::RamBankSize;
+        if (ramSizeFlag != GbConstants::RamSizeFlagNoRam)
+            DEBUGBREAKLOG("Invalid Cartridge RAM size: " << static_cast<int>(ramSizeFlag) << ", defaulting to no ram");
+
+        return 0;
     }
-    
-    if (ramSizeFlag != GbConstants::RamSizeFlagNoRam)
-        DEBUGBREAKLOG("Invalid Cartridge RAM size: " << static_cast<int>((*_rom)[AddressConstants::CartridgeRamSizeAddress]) << ", defaulting to no ram");
+}
+
+NoMbc::NoMbc(const std::vector<byte>* rom) : _rom(rom), _ram(GetRamSize(*rom))
+{
 }
 
 NoMbc::~NoMbc()
@@ -37,16 +42,34 @@ byte NoMbc::Read(word address)
     return (*_rom)[address];
 }
 
+const byte* NoMbc::GetReadPointer(const word address)
+{
+    if (address >= _rom->size())
+        return nullptr;
+
+    return &(*_rom)[address];
+}
+
 void NoMbc::Write(const word address, const byte data)
 {
     const word translatedAddress = TranslateAddress(address);
-    if (translatedAddress >= _ram.size())
+    if (translatedAddress >= _ram.GetSize())
     {
         DEBUGBREAKLOG("Invalid NoMbc RAM write, address: " << std::format("{:x}", address));
         return;
     }
 
-    _ram[translatedAddress] = data;
+    _ram.Write(translatedAddress, data);
+}
+
+void NoMbc::CopyStateFrom(const BaseMbc& other)
+{
+    _ram = static_cast<const NoMbc&>(other)._ram;
+}
+
+void NoMbc::ShareStateFrom(BaseMbc& other)
+{
+    _ram.ShareFrom(static_cast<NoMbc&>(other)._ram);
 }
 
 word NoMbc::TranslateAddress(const word address)
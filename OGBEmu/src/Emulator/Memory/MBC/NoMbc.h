@@ -4,18 +4,23 @@
 
 #include "BaseMbc.h"
 
+#include "Emulator/Memory/PagedMemory.h"
+
 class NoMbc final : public BaseMbc
 {
 public:
-    explicit NoMbc(std::vector<byte>* rom);
+    explicit NoMbc(const std::vector<byte>* rom);
     ~NoMbc() override;
     
     byte Read(word address) override;
     void Write(word address, byte data) override;
+    [[nodiscard]] const byte* GetReadPointer(word address) override;
+    void CopyStateFrom(const BaseMbc& other) override;
+    void ShareStateFrom(BaseMbc& other) override;
 
 private:
     static word TranslateAddress(word address);
 
-    std::vector<byte>* _rom = nullptr;
-    std::vector<byte> _ram;
+    const std::vector<byte>* _rom = nullptr;
+    PagedMemory _ram;
 };
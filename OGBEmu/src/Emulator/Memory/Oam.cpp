@@ -14,26 +14,26 @@ byte Oam::Read(const word busAddress) const
 {
     const word internalAddress = TranslateAddress(busAddress);
 
-    if (internalAddress < 0 || internalAddress >=_bytes.size())
+    if (internalAddress < 0 || internalAddress >=_bytes.GetSize())
     {
         DEBUGBREAKLOG("Invalid Oam read, address " << std::format("{:x}", busAddress));
         return 0;
     }
 
-    return _bytes[internalAddress];
+    return _bytes.Read(internalAddress);
 }
 
 void Oam::Write(const word busAddress, const byte data)
 {
     const word internalAddress = TranslateAddress(busAddress);
 
-    if (internalAddress < 0 || internalAddress >=_bytes.size())
+    if (internalAddress < 0 || internalAddress >=_bytes.GetSize())
     {
         DEBUGBREAKLOG("Invalid Oam write, address " << std::format("{:x}", busAddress));
         return;
     }
 
-    _bytes[internalAddress] = data;
+    _bytes.Write(internalAddress, data);
 }
 
 word Oam::TranslateAddress(const word busAddress)
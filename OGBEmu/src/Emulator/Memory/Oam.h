@@ -1,9 +1,9 @@
 #pragma once
 
-#include <vector>
-
 #include "Core/Definitions.h"
 
+#include "Emulator/Memory/PagedMemory.h"
+
 class Oam
 {
 public:
@@ -11,9 +11,13 @@ public:
     
     [[nodiscard]] byte Read(word busAddress) const;
     void Write(word busAddress, byte data);
+    // Direct access for bulk transfers, the caller keeps within the page
+    [[nodiscard]] byte* GetWritePointer(const word busAddress) { return _bytes.GetWritePointer(TranslateAddress(busAddress)); }
+    // Shared with the other OAM until either one is written, a DMA is enough to unshare it
+    void ShareStateFrom(Oam& other) { _bytes.ShareFrom(other._bytes); }
 
 private:
     static word TranslateAddress(word busAddress);
 
-    std::vector<byte> _bytes;
+    PagedMemory _bytes;
 };
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "PagedMemory.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    constexpr std::array<byte, PagedMemory::PageSize> ZeroPage{};
+
+    unsigned int GetPageCount(const unsigned int size)
+    {
+        return (size + PagedMemory::PageSize - 1) / PagedMemory::PageSize;
+    }
+}
+
+PagedMemory::PagedMemory(const unsigned int size) : _size(size),
+                                                    _pages(GetPageCount(size)),
+                                                    _readPages(_pages.size(), ZeroPage.data()),
+                                                    _writablePages(_pages.size())
+{
+}
+
+PagedMemory::PagedMemory(const PagedMemory& other) : PagedMemory(other._size)
+{
+    *this = other;
+}
+
+PagedMemory& PagedMemory::operator=(const PagedMemory& other)
+{
+    if (this == &other)
+        return *this;
+
+    if (other._pages.size() != _pages.size())
+    {
+        _pages.resize(other._pages.size());
+        _readPages.resize(other._pages.size(), ZeroPage.data());
+        _writablePages.resize(other._pages.size(), nullptr);
+    }
+    _size = other._size;
+
+    for (size_t page = 0; page < _pages.size(); page++)
+    {
+        if (_writablePages[page])
+        {
+            std::memcpy(_writablePages[page], other._readPages[page], PageSize);
+        }
+        else if (!other._pages[page])
+        {
+            _pages[page] = nullptr;
+            _readPages[page] = ZeroPage.data();
+        }
+        else
+        {
+            _readPages[page] = other._readPages[page];
+            UnsharePage(static_cast<unsigned int>(page));
+        }
+    }
+
+    return *this;
+}
+
+void PagedMemory::ShareFrom(PagedMemory& other)
+{
+    std::ranges::fill(other._writablePages, nullptr);
+    _size = other._size;
+    _pages = other._pages;
+    _readPages = other._readPages;
+    _writablePages.assign(_pages.size(), nullptr);
+}
+
+byte* PagedMemory::UnsharePage(const unsigned int page)
+{
+    // Always copied, even when no one else holds the page anymore, as reference counts are only a hint while other
+    // devices run on their own threads
+    auto copy = std::make_shared<Page>();
+    std::memcpy(copy->data(), _readPages[page], PageSize);
+    _pages[page] = std::move(copy);
+    _readPages[page] = _pages[page]->data();
+    _writablePages[page] = _pages[page]->data();
+    return _writablePages[page];
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "Core/Definitions.h"
+
+// Memory split into pages that forked devices share until one of them writes. A shared page is copied on its first
+// write, so a fork only pays for what it touches. Pages start out reading from a common zeroed page.
+class PagedMemory
+{
+public:
+    static constexpr unsigned int PageSize = 256;
+
+    explicit PagedMemory(unsigned int size);
+    // Copies the contents into pages of its own, reusing the ones already written to, so copying a state over and over
+    // only allocates the first time
+    PagedMemory(const PagedMemory& other);
+    PagedMemory& operator=(const PagedMemory& other);
+
+    [[nodiscard]] unsigned int GetSize() const { return _size; }
+    [[nodiscard]] bool IsEmpty() const { return _size == 0; }
+
+    [[nodiscard]] byte Read(const unsigned int offset) const { return _readPages[offset / PageSize][offset % PageSize]; }
+    void Write(const unsigned int offset, const byte data) { GetWritablePage(offset / PageSize)[offset % PageSize] = data; }
+    // Direct access for bulk transfers, contiguous up to the end of the page. Writing through the pointer is only
+    // allowed from GetWritePointer, which unshares the page.
+    [[nodiscard]] const byte* GetReadPointer(const unsigned int offset) const { return &_readPages[offset / PageSize][offset % PageSize]; }
+    [[nodiscard]] byte* GetWritePointer(const unsigned int offset) { return &GetWritablePage(offset / PageSize)[offset % PageSize]; }
+
+    // Takes the contents of the other memory by sharing all its pages, after which neither writes to them in place
+    void ShareFrom(PagedMemory& other);
+
+private:
+    using Page = std::array<byte, PageSize>;
+
+    [[nodiscard]] byte* GetWritablePage(const unsigned int page)
+    {
+        byte* writablePage = _writablePages[page];
+        return writablePage ? writablePage : UnsharePage(page);
+    }
+    byte* UnsharePage(unsigned int page);
+
+    unsigned int _size;
+    // Null for pages never written to, which read from the common zeroed page without holding it
+    std::vector<std::shared_ptr<Page>> _pages;
+    std::vector<const byte*> _readPages;
+    // Null while the page may be shared
+    std::vector<byte*> _writablePages;
+};
@@ -4,39 +4,50 @@
 
 #include "Core/Logger.h"
 
+#include "Emulator/GbConstants.h"
 #include "Emulator/Memory/AddressConstants.h"
 
-VRam::VRam() : _bytes(AddressConstants::EndVRamAddress - AddressConstants::StartVRamAddress + 1)
+namespace
+{
+    constexpr byte BankMask = 0x01;
+}
+
+VRam::VRam() : _bytes(GbConstants::CgbVRamBankCount * GbConstants::VRamBankSize)
 {
 }
 
 byte VRam::Read(const word busAddress) const
 {
-    const word internalAddress = TranslateAddress(busAddress);
+    const unsigned int internalAddress = TranslateAddress(busAddress);
 
-    if (internalAddress < 0 || internalAddress >=_bytes.size())
+    if (internalAddress >= _bytes.GetSize())
     {
         DEBUGBREAKLOG("Invalid VRam read, address " << std::format("{:x}", busAddress));
         return 0;
     }
 
-    return _bytes[internalAddress];
+    return _bytes.Read(internalAddress);
 }
 
 void VRam::Write(const word busAddress, const byte data)
 {
-    const word internalAddress = TranslateAddress(busAddress);
+    const unsigned int internalAddress = TranslateAddress(busAddress);
 
-    if (internalAddress < 0 || internalAddress >=_bytes.size())
+    if (internalAddress >= _bytes.GetSize())
     {
         DEBUGBREAKLOG("Invalid VRam write, address " << std::format("{:x}", busAddress));
         return;
     }
 
-    _bytes[internalAddress] = data;
+    _bytes.Write(internalAddress, data);
+}
+
+void VRam::SetBank(const byte bank)
+{
+    _bankOffset = (bank & BankMask) * GbConstants::VRamBankSize;
 }
 
-word VRam::TranslateAddress(const word busAddress)
+unsigned int VRam::TranslateAddress(const word busAddress) const
 {
-    return busAddress - AddressConstants::StartVRamAddress;
+    return _bankOffset + busAddress - AddressConstants::StartVRamAddress;
 }
\ No newline at end of file
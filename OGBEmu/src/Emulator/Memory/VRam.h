@@ -1,19 +1,40 @@
 #pragma once
 
-#include <vector>
-
 #include "Core/Definitions.h"
 
+#include "Emulator/GbConstants.h"
+#include "Emulator/Memory/AddressConstants.h"
+#include "Emulator/Memory/PagedMemory.h"
+
+// The CGB has a second bank, switched through VBK
 class VRam
 {
 public:
     VRam();
     
     [[nodiscard]] byte Read(word busAddress) const;
+    // Whichever bank VBK selects, for looking at tiles outside of the CPU's view
+    [[nodiscard]] byte ReadBank(const unsigned int bank, const word busAddress) const
+    {
+        return _bytes.Read(bank * GbConstants::VRamBankSize + busAddress - AddressConstants::StartVRamAddress);
+    }
     void Write(word busAddress, byte data);
+    // Direct access for bulk transfers, the caller keeps within the page
+    [[nodiscard]] const byte* GetReadPointer(const word busAddress) const { return _bytes.GetReadPointer(TranslateAddress(busAddress)); }
+    [[nodiscard]] byte* GetWritePointer(const word busAddress) { return _bytes.GetWritePointer(TranslateAddress(busAddress)); }
+
+    // The offset is recomputed here, accesses only add the address to it
+    void SetBank(byte bank);
+    // Takes the selected bank, the banks' memory is shared copy-on-write, see PagedMemory
+    void ShareStateFrom(VRam& other)
+    {
+        _bytes.ShareFrom(other._bytes);
+        _bankOffset = other._bankOffset;
+    }
 
 private:
-    static word TranslateAddress(word busAddress);
+    [[nodiscard]] unsigned int TranslateAddress(word busAddress) const;
 
-    std::vector<byte> _bytes;
+    PagedMemory _bytes;
+    unsigned int _bankOffset = 0;
 };
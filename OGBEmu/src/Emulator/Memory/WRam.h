@@ -1,9 +1,9 @@
 #pragma once
 
-#include <vector>
-
 #include "Core/Definitions.h"
 
+#include "Emulator/Memory/PagedMemory.h"
+
 class WRam
 {
 public:
@@ -11,9 +11,14 @@ public:
     
     [[nodiscard]] byte Read(word busAddress) const;
     void Write(word busAddress, byte data);
+    // Direct access for bulk transfers, the caller keeps within the page
+    [[nodiscard]] const byte* GetReadPointer(const word busAddress) const { return _bytes.GetReadPointer(TranslateAddress(busAddress)); }
+    [[nodiscard]] byte* GetWritePointer(const word busAddress) { return _bytes.GetWritePointer(TranslateAddress(busAddress)); }
+    // Copy-on-write, see PagedMemory
+    void ShareStateFrom(WRam& other) { _bytes.ShareFrom(other._bytes); }
 
 private:
     static word TranslateAddress(word busAddress);
 
-    std::vector<byte> _bytes;
+    PagedMemory _bytes;
 };
@@ -4,39 +4,52 @@
 
 #include "Core/Logger.h"
 
+#include "Emulator/GbConstants.h"
 #include "Emulator/Memory/AddressConstants.h"
 
-WRamCgb::WRamCgb() : _bytes(AddressConstants::EndWRamCgbAddress - AddressConstants::StartWRamCgbAddress + 1)
+namespace
+{
+    constexpr byte BankMask = 0x07;
+}
+
+WRamCgb::WRamCgb() : _bytes(GbConstants::CgbSwitchableWRamBankCount * GbConstants::WRamBankSize)
 {
 }
 
 byte WRamCgb::Read(const word busAddress) const
 {
-    const word internalAddress = TranslateAddress(busAddress);
+    const unsigned int internalAddress = TranslateAddress(busAddress);
 
-    if (internalAddress < 0 || internalAddress >=_bytes.size())
+    if (internalAddress >= _bytes.GetSize())
     {
         DEBUGBREAKLOG("Invalid WRamCgb read, address " << std::format("{:x}", busAddress));
         return 0;
     }
 
-    return _bytes[internalAddress];
+    return _bytes.Read(internalAddress);
 }
 
 void WRamCgb::Write(const word busAddress, const byte data)
 {
-    const word internalAddress = TranslateAddress(busAddress);
+    const unsigned int internalAddress = TranslateAddress(busAddress);
 
-    if (internalAddress < 0 || internalAddress >=_bytes.size())
+    if (internalAddress >= _bytes.GetSize())
     {
         DEBUGBREAKLOG("Invalid WRamCgb write, address " << std::format("{:x}", busAddress));
         return;
     }
 
-    _bytes[internalAddress] = data;
+    _bytes.Write(internalAddress, data);
+}
+
+void WRamCgb::SetBank(const byte bank)
+{
+    const byte maskedBank = bank & BankMask;
+    const unsigned int bankIndex = maskedBank == 0 ? 0 : maskedBank - 1;
+    _bankOffset = bankIndex * GbConstants::WRamBankSize;
 }
 
-word WRamCgb::TranslateAddress(const word busAddress)
+unsigned int WRamCgb::TranslateAddress(const word busAddress) const
 {
-    return busAddress - AddressConstants::StartWRamCgbAddress;
+    return _bankOffset + busAddress - AddressConstants::StartWRamCgbAddress;
 }
@@ -1,9 +1,11 @@
 #pragma once
 
-#include <vector>
-
 #include "Core/Definitions.h"
 
+#include "Emulator/Memory/PagedMemory.h"
+
+// The switchable half of the work RAM, at 0xD000. The DMG only has bank 1, the CGB switches banks 1 to 7 through
+// SVBK.
 class WRamCgb
 {
 public:
@@ -11,9 +13,22 @@ public:
     
     [[nodiscard]] byte Read(word busAddress) const;
     void Write(word busAddress, byte data);
+    // Direct access for bulk transfers, the caller keeps within the page
+    [[nodiscard]] const byte* GetReadPointer(const word busAddress) const { return _bytes.GetReadPointer(TranslateAddress(busAddress)); }
+    [[nodiscard]] byte* GetWritePointer(const word busAddress) { return _bytes.GetWritePointer(TranslateAddress(busAddress)); }
+
+    // Bank 0 selects bank 1. The offset is recomputed here, accesses only add the address to it.
+    void SetBank(byte bank);
+    // The bank selection is copied, the banks themselves are shared until written
+    void ShareStateFrom(WRamCgb& other)
+    {
+        _bytes.ShareFrom(other._bytes);
+        _bankOffset = other._bankOffset;
+    }
 
 private:
-    static word TranslateAddress(word busAddress);
+    [[nodiscard]] unsigned int TranslateAddress(word busAddress) const;
 
-    std::vector<byte> _bytes;
+    PagedMemory _bytes;
+    unsigned int _bankOffset = 0;
 };
@@ -0,0 +1,30 @@
+#pragma once
+
+// Converts between CPU cycles and cycles of the normal speed clock, which the APU and LCD keep running on in CGB
+// double speed. Both clocks are counted from the last speed switch, where they were in sync.
+class NormalSpeedClock
+{
+public:
+    [[nodiscard]] unsigned long long FromCpuCycle(const unsigned long long cpuCycle) const
+    {
+        return _switchCycle + (cpuCycle - _switchCpuCycle >> _speedShift);
+    }
+
+    // Only for cycles after the last switch
+    [[nodiscard]] unsigned long long ToCpuCycle(const unsigned long long cycle) const
+    {
+        return _switchCpuCycle + (cycle - _switchCycle << _speedShift);
+    }
+
+    void SetDoubleSpeed(const unsigned long long cpuCycle, const bool isDoubleSpeed)
+    {
+        _switchCycle = FromCpuCycle(cpuCycle);
+        _switchCpuCycle = cpuCycle;
+        _speedShift = isDoubleSpeed ? 1 : 0;
+    }
+
+private:
+    unsigned long long _switchCpuCycle = 0;
+    unsigned long long _switchCycle = 0;
+    unsigned int _speedShift = 0;
+};
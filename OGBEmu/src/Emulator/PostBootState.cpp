@@ -0,0 +1,157 @@
+#include "PostBootState.h"
+
+#include <array>
+
+#include "Emulator/Memory/AddressConstants.h"
+#include "Emulator/Memory/Bus.h"
+
+namespace
+{
+    constexpr word StackPointer = 0xFFFE;
+    constexpr word EntryPoint = 0x100;
+
+    constexpr word DmgSystemCounter = 0xABCC;
+    // How long the CGB boot ROM runs depends on the logo animation, DIV is left undefined
+    constexpr word CgbSystemCounter = 0x0000;
+
+    constexpr word LogoTilesAddress = 0x8010;
+    constexpr word RegisteredTileAddress = 0x8190;
+    constexpr byte RegisteredTileIndex = 0x19;
+    constexpr word LogoTopMapAddress = 0x9904;
+    constexpr word LogoBottomMapAddress = 0x9924;
+    constexpr word RegisteredMapAddress = 0x9910;
+    constexpr byte LogoTilesPerRow = 12;
+
+    // Stored in the boot ROM rather than the cartridge
+    constexpr std::array<byte, 8> RegisteredTile = {0x3C, 0x42, 0xB9, 0xA5, 0xB9, 0xA5, 0x42, 0x3C};
+
+    constexpr PostBootState::IoRegisterValue DmgIoRegisters[] =
+    {
+        {AddressConstants::ApuControl, 0xF1},
+        {0xFF10, 0x80}, {0xFF11, 0xBF}, {0xFF12, 0xF3}, {0xFF13, 0xFF}, {0xFF14, 0xBF},
+        {0xFF16, 0x3F}, {0xFF17, 0x00}, {0xFF18, 0xFF}, {0xFF19, 0xBF},
+        {0xFF1A, 0x7F}, {0xFF1B, 0xFF}, {0xFF1C, 0x9F}, {0xFF1D, 0xFF}, {0xFF1E, 0xBF},
+        {0xFF20, 0xFF}, {0xFF21, 0x00}, {0xFF22, 0x00}, {0xFF23, 0xBF},
+        {0xFF24, 0x77}, {0xFF25, 0xF3},
+        {AddressConstants::Joypad, 0xCF},
+        {AddressConstants::SerialData, 0x00},
+        {AddressConstants::SerialControl, 0x7E},
+        {AddressConstants::Tima, 0x00},
+        {AddressConstants::Tma, 0x00},
+        {AddressConstants::Tac, 0xF8},
+        {AddressConstants::Lcdc, 0x91},
+        {AddressConstants::LcdStatus, 0x85},
+        {AddressConstants::Scy, 0x00},
+        {AddressConstants::Scx, 0x00},
+        {AddressConstants::Lyc, 0x00},
+        {AddressConstants::Bgp, 0xFC},
+        {AddressConstants::Obp0, 0xFF},
+        {AddressConstants::Obp1, 0xFF},
+        {AddressConstants::Wy, 0x00},
+        {AddressConstants::Wx, 0x00},
+        {AddressConstants::InterruptFlag, 0xE1},
+        {AddressConstants::StartIeAddress, 0x00},
+        {AddressConstants::BootRomBank, 0x01},
+    };
+
+    // The palettes and HDMA registers are left at their reset value
+    constexpr PostBootState::IoRegisterValue CgbIoRegisters[] =
+    {
+        {AddressConstants::ApuControl, 0xF1},
+        {0xFF10, 0x80}, {0xFF11, 0xBF}, {0xFF12, 0xF3}, {0xFF13, 0xFF}, {0xFF14, 0xBF},
+        {0xFF16, 0x3F}, {0xFF17, 0x00}, {0xFF18, 0xFF}, {0xFF19, 0xBF},
+        {0xFF1A, 0x7F}, {0xFF1B, 0xFF}, {0xFF1C, 0x9F}, {0xFF1D, 0xFF}, {0xFF1E, 0xBF},
+        {0xFF20, 0xFF}, {0xFF21, 0x00}, {0xFF22, 0x00}, {0xFF23, 0xBF},
+        {0xFF24, 0x77}, {0xFF25, 0xF3},
+        {AddressConstants::Joypad, 0xCF},
+        {AddressConstants::SerialData, 0x00},
+        {AddressConstants::SerialControl, 0x7F},
+        {AddressConstants::Tima, 0x00},
+        {AddressConstants::Tma, 0x00},
+        {AddressConstants::Tac, 0xF8},
+        {AddressConstants::Lcdc, 0x91},
+        {AddressConstants::LcdStatus, 0x85},
+        {AddressConstants::Scy, 0x00},
+        {AddressConstants::Scx, 0x00},
+        {AddressConstants::Lyc, 0x00},
+        {AddressConstants::Bgp, 0xFC},
+        {AddressConstants::Wy, 0x00},
+        {AddressConstants::Wx, 0x00},
+        {AddressConstants::Key1, 0x7E},
+        {AddressConstants::VRamBank, 0xFE},
+        {AddressConstants::WRamBank, 0xF8},
+        {AddressConstants::InterruptFlag, 0xE1},
+        {AddressConstants::StartIeAddress, 0x00},
+        {AddressConstants::BootRomBank, 0x01},
+    };
+
+    // Each logo bit becomes two pixels
+    [[nodiscard]] byte ScaleNibble(const byte nibble)
+    {
+        byte scaled = 0;
+        for (int bit = 0; bit < 4; bit++)
+        {
+            if (nibble >> bit & 1)
+                scaled |= 0b11 << bit * 2;
+        }
+
+        return scaled;
+    }
+}
+
+CpuState PostBootState::GetCpuState(const HardwareModel model, const byte headerChecksum)
+{
+    if (model == HardwareModel::Cgb)
+        return {0x1180, 0x0000, 0xFF56, 0x000D, StackPointer, EntryPoint, 0};
+
+    const word flags = headerChecksum == 0 ? 0x80 : 0xB0;
+    return {static_cast<word>(0x0100 | flags), 0x0013, 0x00D8, 0x014D, StackPointer, EntryPoint, 0};
+}
+
+std::span<const PostBootState::IoRegisterValue> PostBootState::GetIoRegisters(const HardwareModel model)
+{
+    if (model == HardwareModel::Cgb)
+        return CgbIoRegisters;
+
+    return DmgIoRegisters;
+}
+
+word PostBootState::GetSystemCounter(const HardwareModel model)
+{
+    return model == HardwareModel::Cgb ? CgbSystemCounter : DmgSystemCounter;
+}
+
+void PostBootState::WriteLogo(Bus* bus)
+{
+    // Every logo byte gives 4 tile rows, its upper then lower nibble scaled up and each drawn twice. Only the low
+    // bit plane is written, so the logo uses color 1.
+    word tileAddress = LogoTilesAddress;
+    for (word address = AddressConstants::CartridgeLogoStartAddress; address <= AddressConstants::CartridgeLogoEndAddress; address++)
+    {
+        const byte logoByte = bus->Read(address);
+
+        for (const byte nibble : {static_cast<byte>(logoByte >> 4), static_cast<byte>(logoByte & 0xF)})
+        {
+            const byte scaled = ScaleNibble(nibble);
+            for (int row = 0; row < 2; row++)
+            {
+                bus->Write(tileAddress, scaled);
+                tileAddress += 2;
+            }
+        }
+    }
+
+    word registeredAddress = RegisteredTileAddress;
+    for (const byte row : RegisteredTile)
+    {
+        bus->Write(registeredAddress, row);
+        registeredAddress += 2;
+    }
+
+    for (byte i = 0; i < LogoTilesPerRow; i++)
+    {
+        bus->Write(LogoTopMapAddress + i, i + 1);
+        bus->Write(LogoBottomMapAddress + i, i + 1 + LogoTilesPerRow);
+    }
+    bus->Write(RegisteredMapAddress, RegisteredTileIndex);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <span>
+
+#include "Core/Definitions.h"
+
+#include "Emulator/Cpu.h"
+
+class Bus;
+
+enum class HardwareModel : byte
+{
+    Dmg,
+    Cgb
+};
+
+// What the boot ROM leaves behind when it jumps to the cartridge, so it can be skipped. Values are the documented
+// ones from the Pan Docs power up sequence.
+namespace PostBootState
+{
+    struct IoRegisterValue
+    {
+        word address;
+        byte value;
+    };
+
+    // The DMG boot ROM leaves H and C set unless the header checksum is 0
+    [[nodiscard]] CpuState GetCpuState(HardwareModel model, byte headerChecksum);
+    // In write order, the APU is powered on before its channels are written
+    [[nodiscard]] std::span<const IoRegisterValue> GetIoRegisters(HardwareModel model);
+    [[nodiscard]] word GetSystemCounter(HardwareModel model);
+
+    // Decodes the cartridge logo into VRAM tiles with the tile map showing it, as the DMG boot ROM does
+    void WriteLogo(Bus* bus);
+}
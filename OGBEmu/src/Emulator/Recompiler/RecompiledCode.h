@@ -0,0 +1,242 @@
+#pragma once
+
+#include "Core/Definitions.h"
+
+// Interface between the CPU and the code OGBRecompiler translates ahead of time, which modules are compiled against.
+// Only plain data and function pointers cross it, so modules don't link against the emulator.
+//
+// Translated instructions keep the flags materialized in F. The helpers compute them the same way the interpreter
+// does when it materializes its lazy flags.
+namespace RecompiledCode
+{
+    constexpr unsigned int AbiVersion = 1;
+    // Exported by every module, returns its Module
+    constexpr const char* ModuleSymbol = "OgbGetRecompiledModule";
+
+    constexpr byte FlagZ = 0b10000000;
+    constexpr byte FlagN = 0b01000000;
+    constexpr byte FlagH = 0b00100000;
+    constexpr byte FlagC = 0b00010000;
+
+    struct State
+    {
+        byte a;
+        byte f;
+        byte b;
+        byte c;
+        byte d;
+        byte e;
+        byte h;
+        byte l;
+        word sp;
+        word pc;
+        // Cycles of the instruction in progress
+        unsigned int cycles;
+        bool backwardBranchTaken;
+        word backwardBranchEnd;
+    };
+
+    struct Context
+    {
+        State state;
+        void* host;
+        unsigned int runCycles;
+        unsigned int cycleBudget;
+        // Set by writes to the cartridge, which may switch the bank the rest of the block was translated for
+        bool romWritten;
+
+        byte (*read)(Context* context, word address);
+        void (*write)(Context* context, word address, byte data);
+        // Ends the instruction in the state and returns whether the next one can run right away, which is when the
+        // interpreter would have gone straight to it. The block returns otherwise, with pc at the next instruction.
+        bool (*endInstruction)(Context* context);
+    };
+
+    // Runs the block from its entry-th instruction, every instruction is an entry point
+    using BlockFunction = void (*)(Context* context, unsigned int entry);
+
+    struct Entry
+    {
+        // Where the instruction is in the ROM file, and the address it was translated to run at
+        unsigned int romOffset;
+        word address;
+        unsigned int index;
+        BlockFunction block;
+    };
+
+    struct Module
+    {
+        unsigned int abiVersion;
+        word romGlobalChecksum;
+        unsigned int romSize;
+        unsigned int entryCount;
+        // Sorted by ROM offset
+        const Entry* entries;
+    };
+
+    using GetModuleFunction = const Module* (*)();
+
+    [[nodiscard]] inline word GetPair(const byte high, const byte low) { return static_cast<word>(high << 8 | low); }
+
+    inline void SetPair(byte& high, byte& low, const word value)
+    {
+        high = static_cast<byte>(value >> 8);
+        low = static_cast<byte>(value);
+    }
+
+    [[nodiscard]] inline byte GetZeroFlag(const int result) { return result & 0xFF ? 0 : FlagZ; }
+    [[nodiscard]] inline byte GetCarry(const State& state) { return state.f >> 4 & 1; }
+
+    inline void Add(State& state, const byte value, const int carry)
+    {
+        const int result = state.a + value + carry;
+        state.f = GetZeroFlag(result) | ((state.a ^ value ^ result) & 0x10 ? FlagH : 0) | (result & 0x100 ? FlagC : 0);
+        state.a = static_cast<byte>(result);
+    }
+
+    [[nodiscard]] inline int Compare(State& state, const byte value, const int carry)
+    {
+        const int result = state.a - value - carry;
+        state.f = FlagN | GetZeroFlag(result) | ((state.a ^ value ^ result) & 0x10 ? FlagH : 0) | (result & 0x100 ? FlagC : 0);
+        return result;
+    }
+
+    inline void Sub(State& state, const byte value, const int carry)
+    {
+        state.a = static_cast<byte>(Compare(state, value, carry));
+    }
+
+    inline void And(State& state, const byte value)
+    {
+        state.a &= value;
+        state.f = GetZeroFlag(state.a) | FlagH;
+    }
+
+    inline void Xor(State& state, const byte value)
+    {
+        state.a ^= value;
+        state.f = GetZeroFlag(state.a);
+    }
+
+    inline void Or(State& state, const byte value)
+    {
+        state.a |= value;
+        state.f = GetZeroFlag(state.a);
+    }
+
+    inline void Inc(State& state, byte& target)
+    {
+        target++;
+        state.f = (state.f & FlagC) | GetZeroFlag(target) | ((target & 0xF) == 0x0 ? FlagH : 0);
+    }
+
+    inline void Dec(State& state, byte& target)
+    {
+        target--;
+        state.f = (state.f & FlagC) | FlagN | GetZeroFlag(target) | ((target & 0xF) == 0xF ? FlagH : 0);
+    }
+
+    inline void Rlca(State& state)
+    {
+        state.a = static_cast<byte>(state.a << 1 | state.a >> 7);
+        state.f = state.a & 1 ? FlagC : 0;
+    }
+
+    inline void Rla(State& state)
+    {
+        const int wide = state.a << 1 | GetCarry(state);
+        state.a = static_cast<byte>(wide);
+        state.f = wide & 0x100 ? FlagC : 0;
+    }
+
+    inline void Rrca(State& state)
+    {
+        const int low = state.a & 1;
+        state.a = static_cast<byte>(state.a >> 1 | low << 7);
+        state.f = low ? FlagC : 0;
+    }
+
+    inline void Rra(State& state)
+    {
+        const int low = state.a & 1;
+        state.a = static_cast<byte>(state.a >> 1 | GetCarry(state) << 7);
+        state.f = low ? FlagC : 0;
+    }
+
+    // CB prefixed rotates, which unlike the accumulator ones set Z
+    inline void SetRotateFlags(State& state, const byte result, const int carry)
+    {
+        state.f = GetZeroFlag(result) | (carry ? FlagC : 0);
+    }
+
+    inline void Rlc(State& state, byte& target)
+    {
+        target = static_cast<byte>(target << 1 | target >> 7);
+        SetRotateFlags(state, target, target & 1);
+    }
+
+    inline void Rrc(State& state, byte& target)
+    {
+        const int low = target & 1;
+        target = static_cast<byte>(target >> 1 | low << 7);
+        SetRotateFlags(state, target, low);
+    }
+
+    inline void Rl(State& state, byte& target)
+    {
+        const int wide = target << 1 | GetCarry(state);
+        target = static_cast<byte>(wide);
+        SetRotateFlags(state, target, wide & 0x100);
+    }
+
+    inline void Rr(State& state, byte& target)
+    {
+        const int low = target & 1;
+        target = static_cast<byte>(target >> 1 | GetCarry(state) << 7);
+        SetRotateFlags(state, target, low);
+    }
+
+    inline void Swap(State& state, byte& target)
+    {
+        target = static_cast<byte>(target << 4 | target >> 4);
+        SetRotateFlags(state, target, 0);
+    }
+
+    inline void Bit(State& state, const int bit, const byte value)
+    {
+        state.f = (state.f & FlagC) | GetZeroFlag(value & 1 << bit) | FlagH;
+    }
+
+    inline void Push(Context* context, const word value)
+    {
+        State& state = context->state;
+        state.sp--;
+        context->write(context, state.sp, static_cast<byte>(value >> 8));
+        state.sp--;
+        context->write(context, state.sp, static_cast<byte>(value));
+    }
+
+    [[nodiscard]] inline word Pop(Context* context)
+    {
+        State& state = context->state;
+        const byte low = context->read(context, state.sp++);
+        const byte high = context->read(context, state.sp++);
+        return GetPair(high, low);
+    }
+
+    // Jumps and calls to a lower address are how loops close, which idle loop detection looks for. PC is already past
+    // the branch.
+    inline void Jump(State& state, const word address)
+    {
+        state.backwardBranchTaken = address < state.pc;
+        state.backwardBranchEnd = state.pc;
+        state.pc = address;
+    }
+
+    inline void RelativeJump(State& state, const signed_byte offset)
+    {
+        state.backwardBranchTaken = offset < 0;
+        state.backwardBranchEnd = state.pc;
+        state.pc = static_cast<word>(state.pc + offset);
+    }
+}
@@ -0,0 +1,82 @@
+#include "RecompiledModule.h"
+
+#include "Core/Logger.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace
+{
+    void* OpenLibrary(const std::string& path)
+    {
+#ifdef _WIN32
+        return LoadLibraryA(path.c_str());
+#else
+        return dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+#endif
+    }
+
+    void* GetSymbol(void* library, const char* name)
+    {
+#ifdef _WIN32
+        return reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(library), name));
+#else
+        return dlsym(library, name);
+#endif
+    }
+
+    void CloseLibrary(void* library)
+    {
+#ifdef _WIN32
+        FreeLibrary(static_cast<HMODULE>(library));
+#else
+        dlclose(library);
+#endif
+    }
+}
+
+RecompiledModule::RecompiledModule(void* library, const RecompiledCode::Module* module) : _library(library), _module(module),
+                                                                                          _entryIndices(module->romSize)
+{
+    for (unsigned int i = 0; i < _module->entryCount; i++)
+    {
+        const RecompiledCode::Entry& entry = _module->entries[i];
+        if (entry.romOffset < _entryIndices.size())
+            _entryIndices[entry.romOffset] = i + 1;
+    }
+}
+
+RecompiledModule::~RecompiledModule()
+{
+    CloseLibrary(_library);
+}
+
+std::unique_ptr<RecompiledModule> RecompiledModule::Load(const std::string& path)
+{
+    void* library = OpenLibrary(path);
+    if (!library)
+    {
+        LOG("Couldn't load recompiled module " << path);
+        return nullptr;
+    }
+
+    const auto getModule = reinterpret_cast<RecompiledCode::GetModuleFunction>(GetSymbol(library, RecompiledCode::ModuleSymbol));
+    const RecompiledCode::Module* module = getModule ? getModule() : nullptr;
+    if (!module || module->abiVersion != RecompiledCode::AbiVersion)
+    {
+        LOG("Recompiled module " << path << " wasn't generated by this version of OGBRecompiler");
+        CloseLibrary(library);
+        return nullptr;
+    }
+
+    return std::unique_ptr<RecompiledModule>(new RecompiledModule(library, module));
+}
+
+bool RecompiledModule::IsFor(const word romGlobalChecksum, const size_t romSize) const
+{
+    return _module->romGlobalChecksum == romGlobalChecksum && _module->romSize == romSize;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Core/Definitions.h"
+
+#include "Emulator/Recompiler/RecompiledCode.h"
+
+// Shared object built from the C++ OGBRecompiler generates for a ROM, the CPU runs its blocks instead of interpreting
+// the instructions they cover
+class RecompiledModule
+{
+public:
+    ~RecompiledModule();
+
+    // Null when the library can't be loaded or wasn't built against this version of RecompiledCode.h
+    static std::unique_ptr<RecompiledModule> Load(const std::string& path);
+
+    [[nodiscard]] bool IsFor(word romGlobalChecksum, size_t romSize) const;
+    // Null when the instruction at the ROM offset wasn't translated to run at the address
+    [[nodiscard]] const RecompiledCode::Entry* Find(unsigned int romOffset, word address) const
+    {
+        if (romOffset >= _entryIndices.size() || _entryIndices[romOffset] == 0)
+            return nullptr;
+
+        const RecompiledCode::Entry* entry = &_module->entries[_entryIndices[romOffset] - 1];
+        return entry->address == address ? entry : nullptr;
+    }
+
+private:
+    RecompiledModule(void* library, const RecompiledCode::Module* module);
+
+    void* _library;
+    const RecompiledCode::Module* _module;
+    // Entry index + 1 by ROM offset, 0 where no instruction starts
+    std::vector<unsigned int> _entryIndices;
+};
@@ -0,0 +1,43 @@
+#include "Scheduler.h"
+
+Scheduler::Scheduler()
+{
+    _eventCycles.fill(NoEvent);
+}
+
+void Scheduler::Schedule(const SchedulerEvent event, const unsigned long long cycle)
+{
+    _eventCycles[static_cast<int>(event)] = cycle;
+    UpdateNextEvent();
+}
+
+void Scheduler::Cancel(const SchedulerEvent event)
+{
+    _eventCycles[static_cast<int>(event)] = NoEvent;
+    UpdateNextEvent();
+}
+
+SchedulerEvent Scheduler::PopPendingEvent()
+{
+    int earliestEvent = 0;
+    for (int i = 1; i < static_cast<int>(SchedulerEvent::Count); i++)
+    {
+        if (_eventCycles[i] < _eventCycles[earliestEvent])
+            earliestEvent = i;
+    }
+
+    _eventCycles[earliestEvent] = NoEvent;
+    UpdateNextEvent();
+
+    return static_cast<SchedulerEvent>(earliestEvent);
+}
+
+void Scheduler::UpdateNextEvent()
+{
+    _nextEventCycle = NoEvent;
+    for (const unsigned long long eventCycle : _eventCycles)
+    {
+        if (eventCycle < _nextEventCycle)
+            _nextEventCycle = eventCycle;
+    }
+}
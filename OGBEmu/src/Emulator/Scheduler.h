@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+
+#include "Core/Definitions.h"
+
+enum class SchedulerEvent : byte
+{
+    TimerOverflow,
+    SerialTransfer,
+    LinkSync,
+    LinkTransfer,
+    HBlankDma,
+    Count
+};
+
+// Keeps the emulated time, in CPU cycles, and the next cycle at which each peripheral needs attention. Peripherals
+// are otherwise evaluated lazily, so only one pending instance of each event exists at a time.
+class Scheduler
+{
+public:
+    Scheduler();
+
+    [[nodiscard]] unsigned long long GetCurrentCycle() const { return _currentCycle; }
+    void Advance(const unsigned int cycles) { _currentCycle += cycles; }
+
+    void Schedule(SchedulerEvent event, unsigned long long cycle);
+    void Cancel(SchedulerEvent event);
+
+    [[nodiscard]] unsigned long long GetNextEventCycle() const { return _nextEventCycle; }
+    [[nodiscard]] bool HasPendingEvent() const { return _currentCycle >= _nextEventCycle; }
+    SchedulerEvent PopPendingEvent();
+
+    static constexpr unsigned long long NoEvent = ~0ull;
+
+private:
+    void UpdateNextEvent();
+
+    unsigned long long _currentCycle = 0;
+    unsigned long long _nextEventCycle = NoEvent;
+    std::array<unsigned long long, static_cast<int>(SchedulerEvent::Count)> _eventCycles;
+};
@@ -0,0 +1,220 @@
+#include "ScreenSampler.h"
+
+#include <algorithm>
+
+#include "Core/Logger.h"
+
+#include "Emulator/Memory/AddressConstants.h"
+#include "Emulator/Memory/IoRegisters.h"
+#include "Emulator/Memory/Oam.h"
+#include "Emulator/Memory/VRam.h"
+
+namespace
+{
+    constexpr unsigned int DefaultScale = 2;
+
+    constexpr byte LcdEnable = 0b10000000;
+    constexpr byte WindowTileMap = 0b01000000;
+    constexpr byte WindowEnable = 0b00100000;
+    constexpr byte UnsignedTileData = 0b00010000;
+    constexpr byte BackgroundTileMap = 0b00001000;
+    constexpr byte TallSprites = 0b00000100;
+    constexpr byte SpriteEnable = 0b00000010;
+    // Only disables the background on the DMG, the CGB uses it as a master priority
+    constexpr byte BackgroundEnable = 0b00000001;
+
+    // Background attributes (CGB, in VRAM bank 1) and sprite flags share these
+    constexpr byte BehindBackground = 0b10000000;
+    constexpr byte VerticalFlip = 0b01000000;
+    constexpr byte HorizontalFlip = 0b00100000;
+    constexpr byte DmgSpritePalette = 0b00010000;
+    constexpr byte TileBank = 0b00001000;
+
+    constexpr word LowTileMapAddress = 0x9800;
+    constexpr word HighTileMapAddress = 0x9C00;
+    constexpr word SignedTileDataAddress = 0x9000;
+    constexpr unsigned int TileMapWidth = 32;
+    constexpr unsigned int TileSize = 8;
+    constexpr unsigned int TileBytes = 16;
+    constexpr unsigned int SpriteCount = 40;
+    constexpr unsigned int SpriteYOffset = 16;
+    constexpr unsigned int SpriteXOffset = 8;
+    constexpr unsigned int WindowXOffset = 7;
+
+    constexpr byte GrayLevels[] = {0xFF, 0xAA, 0x55, 0x00};
+
+    // The two bit planes of a tile row, flipped so that column 0 is the lowest bit
+    struct TileRow
+    {
+        byte low = 0;
+        byte high = 0;
+
+        [[nodiscard]] byte GetColorIndex(const unsigned int column) const
+        {
+            return static_cast<byte>(((high >> column) & 1) << 1 | ((low >> column) & 1));
+        }
+    };
+
+    [[nodiscard]] byte Reverse(byte bits)
+    {
+        bits = static_cast<byte>((bits & 0xF0) >> 4 | (bits & 0x0F) << 4);
+        bits = static_cast<byte>((bits & 0xCC) >> 2 | (bits & 0x33) << 2);
+        return static_cast<byte>((bits & 0xAA) >> 1 | (bits & 0x55) << 1);
+    }
+
+    [[nodiscard]] TileRow FetchTileRow(const VRam& vRam, const unsigned int bank, const word tileAddress, const unsigned int row, const byte flags)
+    {
+        const auto rowAddress = static_cast<word>(tileAddress + (flags & VerticalFlip ? TileSize - 1 - row : row) * 2);
+        TileRow tileRow{vRam.ReadBank(bank, rowAddress), vRam.ReadBank(bank, static_cast<word>(rowAddress + 1))};
+        if (!(flags & HorizontalFlip))
+        {
+            tileRow.low = Reverse(tileRow.low);
+            tileRow.high = Reverse(tileRow.high);
+        }
+        return tileRow;
+    }
+
+    [[nodiscard]] byte GetGray(const byte palette, const byte colorIndex, const bool isCgbMode)
+    {
+        return GrayLevels[isCgbMode ? colorIndex : (palette >> (colorIndex * 2)) & 0b11];
+    }
+}
+
+ScreenSampler::ScreenSampler(const unsigned int scale) : _scale(scale)
+{
+    if (_scale == 0 || ScreenWidth % _scale != 0 || ScreenHeight % _scale != 0)
+    {
+        LOG("Screen sampling scale must divide the screen size, got " << _scale << ", defaulting to " << DefaultScale);
+        _scale = DefaultScale;
+    }
+
+    _width = ScreenWidth / _scale;
+    _height = ScreenHeight / _scale;
+    _pixels.resize(static_cast<size_t>(_width) * _height);
+    _backgroundIndices.resize(_pixels.size());
+}
+
+void ScreenSampler::Sample(const VRam& vRam, const Oam& oam, const IoRegisters& ioRegisters, const bool isCgbMode)
+{
+    const byte lcdc = ioRegisters.Read(AddressConstants::Lcdc);
+    if (!(lcdc & LcdEnable))
+    {
+        std::ranges::fill(_pixels, GrayLevels[0]);
+        return;
+    }
+
+    SampleBackground(vRam, ioRegisters, isCgbMode);
+    if (lcdc & SpriteEnable)
+        SampleSprites(vRam, oam, ioRegisters, isCgbMode);
+}
+
+void ScreenSampler::SampleBackground(const VRam& vRam, const IoRegisters& ioRegisters, const bool isCgbMode)
+{
+    const byte lcdc = ioRegisters.Read(AddressConstants::Lcdc);
+    const byte palette = ioRegisters.Read(AddressConstants::Bgp);
+
+    if (!isCgbMode && !(lcdc & BackgroundEnable))
+    {
+        std::ranges::fill(_pixels, GetGray(palette, 0, isCgbMode));
+        std::ranges::fill(_backgroundIndices, 0);
+        return;
+    }
+
+    const unsigned int scrollY = ioRegisters.Read(AddressConstants::Scy);
+    const unsigned int scrollX = ioRegisters.Read(AddressConstants::Scx);
+    const unsigned int windowY = ioRegisters.Read(AddressConstants::Wy);
+    const unsigned int windowX = ioRegisters.Read(AddressConstants::Wx);
+    const bool isWindowEnabled = lcdc & WindowEnable;
+    const word backgroundMap = lcdc & BackgroundTileMap ? HighTileMapAddress : LowTileMapAddress;
+    const word windowMap = lcdc & WindowTileMap ? HighTileMapAddress : LowTileMapAddress;
+    const byte grays[] = {GetGray(palette, 0, isCgbMode), GetGray(palette, 1, isCgbMode), GetGray(palette, 2, isCgbMode), GetGray(palette, 3, isCgbMode)};
+    const unsigned int scale = _scale;
+    const unsigned int width = _width;
+
+    for (unsigned int y = 0; y < _height; y++)
+    {
+        const unsigned int screenY = y * scale;
+        byte* pixels = &_pixels[y * width];
+        byte* backgroundIndices = &_backgroundIndices[y * width];
+        const bool isWindowLine = isWindowEnabled && screenY >= windowY;
+
+        // Sampled pixels in the same tile share its row
+        unsigned int cachedTile = ~0u;
+        TileRow tileRow;
+
+        for (unsigned int x = 0; x < width; x++)
+        {
+            const unsigned int screenX = x * scale;
+            const bool isWindow = isWindowLine && screenX + WindowXOffset >= windowX;
+
+            const word map = isWindow ? windowMap : backgroundMap;
+            const unsigned int mapY = isWindow ? screenY - windowY : (screenY + scrollY) & 0xFF;
+            const unsigned int mapX = isWindow ? screenX + WindowXOffset - windowX : (screenX + scrollX) & 0xFF;
+            const auto mapAddress = static_cast<word>(map + mapY / TileSize * TileMapWidth + mapX / TileSize);
+
+            // The window's rows are offset from the background's, so switching to it always fetches again
+            const unsigned int cacheKey = mapAddress | (isWindow ? 0x10000 : 0);
+            if (cacheKey != cachedTile)
+            {
+                cachedTile = cacheKey;
+                const byte tile = vRam.ReadBank(0, mapAddress);
+                const byte attributes = isCgbMode ? vRam.ReadBank(1, mapAddress) : 0;
+                const word tileAddress = lcdc & UnsignedTileData
+                                             ? static_cast<word>(AddressConstants::StartVRamAddress + tile * TileBytes)
+                                             : static_cast<word>(SignedTileDataAddress + static_cast<signed_byte>(tile) * static_cast<int>(TileBytes));
+                tileRow = FetchTileRow(vRam, attributes & TileBank ? 1 : 0, tileAddress, mapY % TileSize, attributes);
+            }
+
+            const byte colorIndex = tileRow.GetColorIndex(mapX % TileSize);
+            backgroundIndices[x] = colorIndex;
+            pixels[x] = grays[colorIndex];
+        }
+    }
+}
+
+void ScreenSampler::SampleSprites(const VRam& vRam, const Oam& oam, const IoRegisters& ioRegisters, const bool isCgbMode)
+{
+    const byte lcdc = ioRegisters.Read(AddressConstants::Lcdc);
+    const unsigned int spriteHeight = lcdc & TallSprites ? TileSize * 2 : TileSize;
+
+    // Drawn from the last one so that sprites earlier in OAM end up on top
+    for (unsigned int sprite = SpriteCount; sprite-- > 0;)
+    {
+        const auto spriteAddress = static_cast<word>(AddressConstants::StartOamAddress + sprite * 4);
+        const int top = oam.Read(spriteAddress) - static_cast<int>(SpriteYOffset);
+        const int left = oam.Read(spriteAddress + 1) - static_cast<int>(SpriteXOffset);
+        const byte tile = spriteHeight > TileSize ? oam.Read(spriteAddress + 2) & 0xFE : oam.Read(spriteAddress + 2);
+        const byte flags = oam.Read(spriteAddress + 3);
+        const byte palette = ioRegisters.Read(flags & DmgSpritePalette ? AddressConstants::Obp1 : AddressConstants::Obp0);
+        const unsigned int bank = isCgbMode && flags & TileBank ? 1 : 0;
+
+        const int scale = static_cast<int>(_scale);
+        const int bottom = std::min(top + static_cast<int>(spriteHeight), static_cast<int>(ScreenHeight));
+        const int right = std::min(left + static_cast<int>(TileSize), static_cast<int>(ScreenWidth));
+
+        // The first sampled line and column at or after the corner
+        const int firstY = (std::max(top, 0) + scale - 1) / scale;
+        const int firstX = (std::max(left, 0) + scale - 1) / scale;
+
+        for (int y = firstY; y * scale < bottom; y++)
+        {
+            const int screenY = y * scale;
+            unsigned int row = screenY - top;
+            if (flags & VerticalFlip)
+                row = spriteHeight - 1 - row;
+            const auto tileAddress = static_cast<word>(AddressConstants::StartVRamAddress + (tile + row / TileSize) * TileBytes);
+            // The row is already flipped, the tile's half included
+            const TileRow tileRow = FetchTileRow(vRam, bank, tileAddress, row % TileSize, static_cast<byte>(flags & ~VerticalFlip));
+
+            for (int x = firstX; x * scale < right; x++)
+            {
+                const unsigned int pixel = y * _width + x;
+                const byte colorIndex = tileRow.GetColorIndex(x * scale - left);
+                if (colorIndex == 0 || (flags & BehindBackground && _backgroundIndices[pixel] != 0))
+                    continue;
+
+                _pixels[pixel] = GetGray(palette, colorIndex, isCgbMode);
+            }
+        }
+    }
+}
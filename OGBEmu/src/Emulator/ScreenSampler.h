@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+
+#include "Core/Definitions.h"
+
+class IoRegisters;
+class Oam;
+class VRam;
+
+// Grayscale picture of the screen straight from VRAM, OAM and the LCD registers, for programs looking at the game
+// rather than players. There is no PPU: the picture is composed from the state at the time of sampling, as if every
+// line was drawn then, so mid-frame raster effects and the 10 sprites per line limit don't show. Only every scale-th
+// pixel of every scale-th line is sampled, colors are DMG palette shades (the color index in CGB mode), white to black.
+class ScreenSampler
+{
+public:
+    static constexpr unsigned int ScreenWidth = 160;
+    static constexpr unsigned int ScreenHeight = 144;
+
+    // The scale must divide both screen dimensions
+    explicit ScreenSampler(unsigned int scale);
+
+    void Sample(const VRam& vRam, const Oam& oam, const IoRegisters& ioRegisters, bool isCgbMode);
+
+    [[nodiscard]] unsigned int GetWidth() const { return _width; }
+    [[nodiscard]] unsigned int GetHeight() const { return _height; }
+    // One byte per pixel, row by row
+    [[nodiscard]] const std::vector<byte>& GetPixels() const { return _pixels; }
+
+private:
+    void SampleBackground(const VRam& vRam, const IoRegisters& ioRegisters, bool isCgbMode);
+    void SampleSprites(const VRam& vRam, const Oam& oam, const IoRegisters& ioRegisters, bool isCgbMode);
+
+    unsigned int _scale;
+    unsigned int _width;
+    unsigned int _height;
+    std::vector<byte> _pixels;
+    // Color index of the background under each pixel, sprites behind the background only show over index 0
+    std::vector<byte> _backgroundIndices;
+};
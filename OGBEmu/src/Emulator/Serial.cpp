@@ -0,0 +1,236 @@
+#include "Serial.h"
+
+#include <algorithm>
+
+#include "Emulator/GbConstants.h"
+#include "Emulator/Scheduler.h"
+#include "Emulator/Link/BaseLinkCable.h"
+#include "Emulator/Memory/AddressConstants.h"
+#include "Emulator/Memory/IoRegisters.h"
+
+namespace
+{
+    // 8 bits at 8192 Hz, or 262144 Hz with the CGB fast clock
+    constexpr unsigned int TransferCycles = 8 * 512;
+    constexpr unsigned int FastTransferCycles = 8 * 16;
+
+    // How far a device may run past the other's published time in deterministic mode. A transfer is never exchanged
+    // sooner than this after it starts, so the other side always hears about it before reaching the exchange cycle.
+    constexpr unsigned int Lookahead = TransferCycles;
+    constexpr unsigned int LinkSyncCycles = 1024;
+    // Events only run between instructions, so a device can be a few cycles past a sync point when it handles it
+    constexpr unsigned int LinkSyncSlack = 64;
+
+    constexpr byte TransferStartFlag = 0b10000000;
+    constexpr byte FastClockFlag = 0b00000010;
+    constexpr byte InternalClockFlag = 0b00000001;
+}
+
+Serial::Serial(Scheduler* scheduler, IoRegisters* ioRegisters) : _scheduler(scheduler), _ioRegisters(ioRegisters)
+{
+}
+
+byte Serial::Read(const word busAddress) const
+{
+    if (busAddress == AddressConstants::SerialData)
+        return _sb;
+
+    return _sc | 0b01111110;
+}
+
+void Serial::Write(const word busAddress, const byte data)
+{
+    if (busAddress == AddressConstants::SerialData)
+    {
+        _sb = data;
+        return;
+    }
+
+    _sc = data;
+
+    // Transfers clocked by the other side are started by its messages
+    if ((_sc & TransferStartFlag) && (_sc & InternalClockFlag))
+        StartTransfer();
+    else
+        _scheduler->Cancel(SchedulerEvent::SerialTransfer);
+}
+
+void Serial::OnTransferEvent()
+{
+    const byte incomingData = _linkCable ? WaitForLinkReply() : 0xFF;
+    CompleteTransfer(incomingData);
+}
+
+void Serial::OnLinkSyncEvent()
+{
+    const unsigned long long currentCycle = _scheduler->GetCurrentCycle();
+
+    _linkCable->Send({LinkMessageType::Time, 0, currentCycle});
+    ReceiveLinkMessages(false);
+
+    if (_deterministic)
+    {
+        // Don't reach the next sync point past the other device's lookahead window
+        while (!_peerDisconnected && currentCycle + LinkSyncCycles + LinkSyncSlack > _peerCycle + Lookahead)
+            ReceiveLinkMessages(true);
+    }
+
+    _scheduler->Schedule(SchedulerEvent::LinkSync, currentCycle + LinkSyncCycles);
+}
+
+void Serial::OnLinkTransferEvent()
+{
+    _hasIncomingTransfer = false;
+
+    const byte outgoingData = _sb;
+    _linkCable->Send({LinkMessageType::Reply, outgoingData, _scheduler->GetCurrentCycle()});
+
+    // Only a device waiting on the external clock takes part in the exchange
+    if ((_sc & TransferStartFlag) && !(_sc & InternalClockFlag))
+        CompleteTransfer(_incomingTransferData);
+}
+
+void Serial::ConnectLink(BaseLinkCable* linkCable, const bool deterministic)
+{
+    _linkCable = linkCable;
+    _deterministic = deterministic;
+    _peerDisconnected = false;
+    _scheduler->Schedule(SchedulerEvent::LinkSync, _scheduler->GetCurrentCycle());
+}
+
+void Serial::DisconnectLink()
+{
+    if (!_linkCable)
+        return;
+
+    _linkCable->Send({LinkMessageType::Disconnect, 0, _scheduler->GetCurrentCycle()});
+    _linkCable = nullptr;
+    _scheduler->Cancel(SchedulerEvent::LinkSync);
+    _scheduler->Cancel(SchedulerEvent::LinkTransfer);
+}
+
+void Serial::CopyStateFrom(const Serial& other)
+{
+    Scheduler* scheduler = _scheduler;
+    IoRegisters* ioRegisters = _ioRegisters;
+    BaseLinkCable* linkCable = _linkCable;
+    const bool deterministic = _deterministic;
+    std::vector<std::string> stopPatterns = std::move(_stopPatterns);
+
+    *this = other;
+
+    _scheduler = scheduler;
+    _ioRegisters = ioRegisters;
+    _linkCable = linkCable;
+    _deterministic = deterministic;
+    _stopPatterns = std::move(stopPatterns);
+
+    // A copy without a cable of its own, like a device running ahead, leaves the other device's exchanges alone
+    if (!_linkCable)
+    {
+        _scheduler->Cancel(SchedulerEvent::LinkSync);
+        _scheduler->Cancel(SchedulerEvent::LinkTransfer);
+    }
+}
+
+void Serial::StartTransfer()
+{
+    const unsigned long long currentCycle = _scheduler->GetCurrentCycle();
+    const unsigned int transferCycles = _sc & FastClockFlag ? FastTransferCycles : TransferCycles;
+
+    if (!_linkCable)
+    {
+        _scheduler->Schedule(SchedulerEvent::SerialTransfer, currentCycle + transferCycles);
+        return;
+    }
+
+    // Fast clock transfers are stretched to the lookahead in deterministic mode
+    const unsigned long long exchangeCycle = currentCycle + (_deterministic ? std::max(transferCycles, Lookahead) : transferCycles);
+
+    _hasReply = false;
+    _linkCable->Send({LinkMessageType::Transfer, _sb, exchangeCycle});
+    _scheduler->Schedule(SchedulerEvent::SerialTransfer, exchangeCycle);
+}
+
+void Serial::CompleteTransfer(const byte incomingData)
+{
+    _output.push_back(static_cast<char>(_sb));
+
+    _sb = incomingData;
+    _sc &= ~TransferStartFlag;
+    _ioRegisters->RequestInterrupt(GbConstants::SerialInterrupt);
+
+    MatchStopPatterns();
+}
+
+void Serial::ReceiveLinkMessages(bool wait)
+{
+    LinkMessage message{};
+    while (!_peerDisconnected && _linkCable->Receive(message, wait))
+    {
+        HandleLinkMessage(message);
+        wait = false;
+    }
+}
+
+void Serial::HandleLinkMessage(const LinkMessage& message)
+{
+    switch (message.type)
+    {
+    case LinkMessageType::Time:
+        _peerCycle = std::max(_peerCycle, message.cycle);
+        break;
+    case LinkMessageType::Transfer:
+        {
+            _hasIncomingTransfer = true;
+            _incomingTransferData = message.data;
+            _incomingTransferCycle = std::max(message.cycle, _scheduler->GetCurrentCycle());
+            _scheduler->Schedule(SchedulerEvent::LinkTransfer, _incomingTransferCycle);
+            break;
+        }
+    case LinkMessageType::Reply:
+        _hasReply = true;
+        _replyData = message.data;
+        _peerCycle = std::max(_peerCycle, message.cycle);
+        break;
+    case LinkMessageType::Disconnect:
+        _peerDisconnected = true;
+        break;
+    }
+}
+
+byte Serial::WaitForLinkReply()
+{
+    // Let the other side run up to the exchange cycle
+    _linkCable->Send({LinkMessageType::Time, 0, _scheduler->GetCurrentCycle()});
+
+    while (!_hasReply && !_peerDisconnected)
+    {
+        ReceiveLinkMessages(true);
+
+        // Both sides may start a transfer at the same time, answer the other one while waiting
+        if (_hasIncomingTransfer && _incomingTransferCycle <= _scheduler->GetCurrentCycle())
+        {
+            _scheduler->Cancel(SchedulerEvent::LinkTransfer);
+            OnLinkTransferEvent();
+        }
+    }
+
+    return _hasReply ? _replyData : 0xFF;
+}
+
+void Serial::MatchStopPatterns()
+{
+    if (_matchedStopPattern >= 0)
+        return;
+
+    // Only the end of the output can contain a new match, since one byte arrives at a time
+    for (int i = 0; i < static_cast<int>(_stopPatterns.size()); i++)
+    {
+        if (!_stopPatterns[i].empty() && _output.ends_with(_stopPatterns[i]))
+        {
+            _matchedStopPattern = i;
+            return;
+        }
+    }
+}
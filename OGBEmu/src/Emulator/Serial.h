@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Core/Definitions.h"
+
+class BaseLinkCable;
+class IoRegisters;
+class Scheduler;
+struct LinkMessage;
+
+// Serial port. With no cable connected, transfers clocked by this device complete after 8 bit times and shift in
+// 0xFF. Every transmitted byte is kept, which is how test ROMs report their results.
+//
+// With a cable, both devices run freely and only synchronize at transfer boundaries: the clocking side sends its
+// byte along with the cycle at which the exchange happens, and waits for the other side's byte when it gets there.
+// In deterministic mode each side also publishes its emulated time and never runs further than Lookahead cycles
+// past the other, so transfers are always seen at the exact same cycle regardless of host timing.
+class Serial
+{
+public:
+    Serial(Scheduler* scheduler, IoRegisters* ioRegisters);
+
+    [[nodiscard]] byte Read(word busAddress) const;
+    void Write(word busAddress, byte data);
+
+    void OnTransferEvent();
+    void OnLinkSyncEvent();
+    void OnLinkTransferEvent();
+
+    void ConnectLink(BaseLinkCable* linkCable, bool deterministic);
+    void DisconnectLink();
+    // The link cable and stop patterns aren't part of the state, they stay this port's own
+    void CopyStateFrom(const Serial& other);
+
+    [[nodiscard]] const std::string& GetOutput() const { return _output; }
+    void SetStopPatterns(const std::vector<std::string>& stopPatterns) { _stopPatterns = stopPatterns; }
+    [[nodiscard]] int GetMatchedStopPattern() const { return _matchedStopPattern; }
+
+private:
+    void StartTransfer();
+    void CompleteTransfer(byte incomingData);
+    void ReceiveLinkMessages(bool wait);
+    void HandleLinkMessage(const LinkMessage& message);
+    [[nodiscard]] byte WaitForLinkReply();
+    void MatchStopPatterns();
+
+    Scheduler* _scheduler;
+    IoRegisters* _ioRegisters;
+
+    byte _sb = 0;
+    byte _sc = 0;
+
+    BaseLinkCable* _linkCable = nullptr;
+    bool _deterministic = false;
+    bool _peerDisconnected = false;
+    unsigned long long _peerCycle = 0;
+    bool _hasIncomingTransfer = false;
+    byte _incomingTransferData = 0;
+    unsigned long long _incomingTransferCycle = 0;
+    bool _hasReply = false;
+    byte _replyData = 0;
+
+    std::string _output;
+    std::vector<std::string> _stopPatterns;
+    int _matchedStopPattern = -1;
+};
@@ -0,0 +1,147 @@
+#include "Timer.h"
+
+#include "Emulator/GbConstants.h"
+#include "Emulator/Scheduler.h"
+#include "Emulator/Memory/AddressConstants.h"
+#include "Emulator/Memory/IoRegisters.h"
+
+namespace
+{
+    // System counter bit whose falling edge increments TIMA, for each TAC clock select value
+    constexpr byte CounterBits[] = {9, 3, 5, 7};
+}
+
+Timer::Timer(Scheduler* scheduler, IoRegisters* ioRegisters) : _scheduler(scheduler), _ioRegisters(ioRegisters)
+{
+}
+
+byte Timer::Read(const word busAddress)
+{
+    switch (busAddress)
+    {
+    case AddressConstants::Div:
+        return static_cast<byte>(GetSystemCounter() >> 8);
+    case AddressConstants::Tima:
+        Sync();
+        return _tima;
+    case AddressConstants::Tma:
+        return _tma;
+    default:
+        return _tac | 0b11111000;
+    }
+}
+
+void Timer::SetSystemCounter(const word systemCounter)
+{
+    Sync();
+
+    // Cycles are unsigned, the start cycle wraps around when the counter is ahead of them and the difference still
+    // gives the counter
+    _systemCounterStartCycle = _scheduler->GetCurrentCycle() - systemCounter;
+    ScheduleOverflow();
+}
+
+void Timer::CopyStateFrom(const Timer& other)
+{
+    _systemCounterStartCycle = other._systemCounterStartCycle;
+    _lastSyncCycle = other._lastSyncCycle;
+    _tima = other._tima;
+    _tma = other._tma;
+    _tac = other._tac;
+}
+
+void Timer::Write(const word busAddress, const byte data)
+{
+    Sync();
+
+    switch (busAddress)
+    {
+    case AddressConstants::Div:
+        // Resetting the counter is a falling edge if the selected bit was set
+        if (GetTimerSignal())
+            IncrementTima(1);
+        _systemCounterStartCycle = _scheduler->GetCurrentCycle();
+        break;
+    case AddressConstants::Tima:
+        _tima = data;
+        break;
+    case AddressConstants::Tma:
+        _tma = data;
+        return;
+    default:
+        {
+            // Disabling the timer or selecting another bit is also seen as a falling edge by TIMA
+            const bool previousSignal = GetTimerSignal();
+            _tac = data & 0b111;
+            if (previousSignal && !GetTimerSignal())
+                IncrementTima(1);
+            break;
+        }
+    }
+
+    ScheduleOverflow();
+}
+
+void Timer::OnOverflowEvent()
+{
+    Sync();
+    ScheduleOverflow();
+}
+
+void Timer::Sync()
+{
+    const unsigned long long currentCycle = _scheduler->GetCurrentCycle();
+
+    if (IsEnabled())
+    {
+        const byte edgeShift = GetCounterBit() + 1;
+        const unsigned long long previousCounter = _lastSyncCycle - _systemCounterStartCycle;
+        const unsigned long long currentCounter = currentCycle - _systemCounterStartCycle;
+
+        IncrementTima((currentCounter >> edgeShift) - (previousCounter >> edgeShift));
+    }
+
+    _lastSyncCycle = currentCycle;
+}
+
+void Timer::IncrementTima(unsigned long long increments)
+{
+    while (increments >= 256u - _tima)
+    {
+        increments -= 256u - _tima;
+        _tima = _tma;
+        _ioRegisters->RequestInterrupt(GbConstants::TimerInterrupt);
+    }
+
+    _tima += static_cast<byte>(increments);
+}
+
+void Timer::ScheduleOverflow() const
+{
+    if (!IsEnabled())
+    {
+        _scheduler->Cancel(SchedulerEvent::TimerOverflow);
+        return;
+    }
+
+    const byte edgeShift = GetCounterBit() + 1;
+    const unsigned long long edgesToOverflow = 256u - _tima;
+    const unsigned long long overflowCounter = ((GetSystemCounter() >> edgeShift) + edgesToOverflow) << edgeShift;
+
+    _scheduler->Schedule(SchedulerEvent::TimerOverflow, _systemCounterStartCycle + overflowCounter);
+}
+
+unsigned long long Timer::GetSystemCounter() const
+{
+    return _scheduler->GetCurrentCycle() - _systemCounterStartCycle;
+}
+
+byte Timer::GetCounterBit() const
+{
+    return CounterBits[_tac & 0b11];
+}
+
+bool Timer::GetTimerSignal() const
+{
+    return IsEnabled() && GetSystemCounter() >> GetCounterBit() & 1;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Core/Definitions.h"
+
+class IoRegisters;
+class Scheduler;
+
+// DIV and TIMA are never ticked. Both are derived from the 16-bit system counter, which is itself derived from the
+// cycle count, when they're read or when a write changes how they count. The only scheduled work is the next TIMA
+// overflow, which requests the timer interrupt.
+class Timer
+{
+public:
+    Timer(Scheduler* scheduler, IoRegisters* ioRegisters);
+
+    [[nodiscard]] byte Read(word busAddress);
+    void Write(word busAddress, byte data);
+
+    void OnOverflowEvent();
+
+    // Sets the 16-bit counter DIV is the upper byte of, to start from the state the boot ROM leaves
+    void SetSystemCounter(word systemCounter);
+    void CopyStateFrom(const Timer& other);
+
+private:
+    void Sync();
+    void IncrementTima(unsigned long long increments);
+    void ScheduleOverflow() const;
+
+    [[nodiscard]] unsigned long long GetSystemCounter() const;
+    [[nodiscard]] bool IsEnabled() const { return _tac & 0b100; }
+    [[nodiscard]] byte GetCounterBit() const;
+    [[nodiscard]] bool GetTimerSignal() const;
+
+    Scheduler* _scheduler;
+    IoRegisters* _ioRegisters;
+
+    unsigned long long _systemCounterStartCycle = 0;
+    unsigned long long _lastSyncCycle = 0;
+
+    byte _tima = 0;
+    byte _tma = 0;
+    byte _tac = 0;
+};
@@ -0,0 +1,52 @@
+#include "GoldenLog.h"
+
+namespace
+{
+    constexpr char HexDigits[] = "0123456789ABCDEF";
+
+    // Faster than a formatting library, this runs for every instruction
+    void AppendByte(std::string& line, const byte value)
+    {
+        line += HexDigits[value >> 4];
+        line += HexDigits[value & 0xF];
+    }
+
+    void AppendWord(std::string& line, const word value)
+    {
+        AppendByte(line, static_cast<byte>(value >> 8));
+        AppendByte(line, static_cast<byte>(value));
+    }
+}
+
+void GoldenLog::FormatLine(const CpuState& state, const std::array<byte, PcMemorySize>& pcMemory, std::string& line)
+{
+    line.clear();
+    line += "A:";
+    AppendByte(line, static_cast<byte>(state.af >> 8));
+    line += " F:";
+    AppendByte(line, static_cast<byte>(state.af));
+    line += " B:";
+    AppendByte(line, static_cast<byte>(state.bc >> 8));
+    line += " C:";
+    AppendByte(line, static_cast<byte>(state.bc));
+    line += " D:";
+    AppendByte(line, static_cast<byte>(state.de >> 8));
+    line += " E:";
+    AppendByte(line, static_cast<byte>(state.de));
+    line += " H:";
+    AppendByte(line, static_cast<byte>(state.hl >> 8));
+    line += " L:";
+    AppendByte(line, static_cast<byte>(state.hl));
+    line += " SP:";
+    AppendWord(line, state.sp);
+    line += " PC:";
+    AppendWord(line, state.pc);
+    line += " PCMEM:";
+
+    for (unsigned int i = 0; i < PcMemorySize; i++)
+    {
+        if (i > 0)
+            line += ',';
+        AppendByte(line, pcMemory[i]);
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <array>
+#include <string>
+
+#include "Core/Definitions.h"
+
+#include "Emulator/Cpu.h"
+
+// Per-instruction log format shared by several emulators and test ROM tools, one line before each instruction runs:
+//   A:01 F:B0 B:00 C:13 D:00 E:D8 H:01 L:4D SP:FFFE PC:0100 PCMEM:00,C3,13,02
+// Halted cycles don't run an instruction and aren't logged.
+namespace GoldenLog
+{
+    constexpr unsigned int PcMemorySize = 4;
+    constexpr unsigned int LineLength = 73;
+
+    void FormatLine(const CpuState& state, const std::array<byte, PcMemorySize>& pcMemory, std::string& line);
+}
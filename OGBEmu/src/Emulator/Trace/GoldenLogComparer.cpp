@@ -0,0 +1,69 @@
+#include "GoldenLogComparer.h"
+
+#include <algorithm>
+#include <cctype>
+
+#include "Core/Logger.h"
+
+namespace
+{
+    constexpr unsigned int ReadBufferSize = 1 << 20;
+}
+
+GoldenLogComparer::GoldenLogComparer(const std::string& filePath) : _readBuffer(ReadBufferSize)
+{
+    // The buffer must be set before opening to be used
+    _file.rdbuf()->pubsetbuf(_readBuffer.data(), static_cast<std::streamsize>(_readBuffer.size()));
+    _file.open(filePath, std::ifstream::binary);
+
+    if (!_file.good())
+    {
+        LOG("Error opening golden log " << filePath);
+        return;
+    }
+
+    _expectedLine.reserve(GoldenLog::LineLength + 2);
+    _actualLine.reserve(GoldenLog::LineLength);
+    _previousLine.reserve(GoldenLog::LineLength + 2);
+    _isValid = true;
+}
+
+bool GoldenLogComparer::Compare(const CpuState& state, const std::array<byte, GoldenLog::PcMemorySize>& pcMemory)
+{
+    if (!_isValid || _hasMismatch || _hasReachedEnd)
+        return false;
+
+    _previousLine.swap(_expectedLine);
+    if (!ReadExpectedLine())
+    {
+        _hasReachedEnd = true;
+        return false;
+    }
+
+    GoldenLog::FormatLine(state, pcMemory, _actualLine);
+    if (_actualLine != _expectedLine)
+    {
+        _hasMismatch = true;
+        return false;
+    }
+
+    _matchedLineCount++;
+    return true;
+}
+
+bool GoldenLogComparer::ReadExpectedLine()
+{
+    // Blank lines are skipped, Windows line endings and lowercase hex are accepted
+    do
+    {
+        if (!std::getline(_file, _expectedLine))
+            return false;
+
+        if (!_expectedLine.empty() && _expectedLine.back() == '\r')
+            _expectedLine.pop_back();
+    }
+    while (_expectedLine.empty());
+
+    std::transform(_expectedLine.begin(), _expectedLine.end(), _expectedLine.begin(), [](const char c) { return static_cast<char>(std::toupper(static_cast<unsigned char>(c))); });
+    return true;
+}
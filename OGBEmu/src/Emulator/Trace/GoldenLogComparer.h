@@ -0,0 +1,42 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "GoldenLog.h"
+
+// Compares each executed instruction with the next line of a reference log, stopping at the first difference. The
+// reference is streamed through a large read buffer, only the current and previous lines are resident, so logs of
+// any size work.
+class GoldenLogComparer
+{
+public:
+    explicit GoldenLogComparer(const std::string& filePath);
+
+    [[nodiscard]] bool IsValid() const { return _isValid; }
+
+    // Returns false once a line differs or the reference ends, nothing is compared after that
+    bool Compare(const CpuState& state, const std::array<byte, GoldenLog::PcMemorySize>& pcMemory);
+
+    [[nodiscard]] unsigned long long GetMatchedLineCount() const { return _matchedLineCount; }
+    [[nodiscard]] bool HasMismatch() const { return _hasMismatch; }
+    [[nodiscard]] bool HasReachedEnd() const { return _hasReachedEnd; }
+    // The last matching line, then both sides of the first mismatch
+    [[nodiscard]] const std::string& GetPreviousLine() const { return _previousLine; }
+    [[nodiscard]] const std::string& GetExpectedLine() const { return _expectedLine; }
+    [[nodiscard]] const std::string& GetActualLine() const { return _actualLine; }
+
+private:
+    bool ReadExpectedLine();
+
+    std::vector<char> _readBuffer;
+    std::ifstream _file;
+    std::string _expectedLine;
+    std::string _actualLine;
+    std::string _previousLine;
+    unsigned long long _matchedLineCount = 0;
+    bool _isValid = false;
+    bool _hasMismatch = false;
+    bool _hasReachedEnd = false;
+};
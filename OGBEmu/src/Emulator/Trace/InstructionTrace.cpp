@@ -0,0 +1,129 @@
+#include "InstructionTrace.h"
+
+#include "Emulator/Disassembly/Disassembler.h"
+
+namespace
+{
+    constexpr unsigned int RegisterCount = 5;
+    // No 3 byte instruction starts with 0xFF
+    constexpr unsigned int EmptyCacheEntry = ~0u;
+
+    // Only the first size bytes count
+    [[nodiscard]] unsigned long long ReadValue(const byte* input, const unsigned int size)
+    {
+        unsigned long long value = 0;
+        for (unsigned int i = 0; i < size; i++)
+            value |= static_cast<unsigned long long>(input[i]) << i * 8;
+        return value;
+    }
+}
+
+InstructionTrace::InstructionSizes InstructionTrace::MakeInstructionSizes()
+{
+    InstructionSizes sizes{};
+    for (unsigned int opcode = 0; opcode < sizes.size(); opcode++)
+        sizes[opcode] = Disassembler::GetSize(static_cast<byte>(opcode));
+    return sizes;
+}
+
+InstructionTrace::BlockEncoder::BlockEncoder() : _instructionSizes(MakeInstructionSizes())
+{
+    _instructionCache.fill(EmptyCacheEntry);
+}
+
+void InstructionTrace::BlockEncoder::Reset()
+{
+    _instructionCache.fill(EmptyCacheEntry);
+    _previousCycle = 0;
+    _predictedPc = 0;
+    _previousStatus = 0;
+    _previousRegisters = 0;
+    _previousSp = 0;
+}
+
+bool InstructionTrace::DecodeBlock(const std::vector<byte>& encoded, const unsigned int recordCount, std::vector<Record>& records)
+{
+    records.clear();
+    records.reserve(recordCount);
+
+    const InstructionSizes sizes = MakeInstructionSizes();
+    std::vector<unsigned int> instructionCache(InstructionCacheSize, EmptyCacheEntry);
+    unsigned long long cycle = 0;
+    byte status = 0;
+    word pc = 0;
+    std::array<word, RegisterCount> registers{};
+    size_t position = 0;
+
+    const auto read = [&](const unsigned int size, unsigned long long& value)
+    {
+        if (position + size > encoded.size())
+            return false;
+
+        value = ReadValue(&encoded[position], size);
+        position += size;
+        return true;
+    };
+
+    for (unsigned int i = 0; i < recordCount; i++)
+    {
+        unsigned long long header = 0;
+        unsigned long long value = 0;
+        if (!read(1, header) || !read(1, value))
+            return false;
+        if (value == LongCycleDelta && !read(8, value))
+            return false;
+        cycle += value;
+
+        if (header & StatusBit)
+        {
+            if (!read(1, value) || value >> 2 != 0)
+                return false;
+            status = static_cast<byte>(value);
+        }
+
+        if (header & PcBit)
+        {
+            if (!read(2, value))
+                return false;
+            pc = static_cast<word>(value);
+        }
+
+        Record& record = records.emplace_back();
+        record.isHalted = status & HaltedStatusBit;
+        if (header & InstructionBit)
+        {
+            if (record.isHalted || position >= encoded.size())
+                return false;
+
+            const unsigned int size = sizes[encoded[position]];
+            if (!read(size, value))
+                return false;
+            instructionCache[pc % InstructionCacheSize] = static_cast<unsigned int>(pc / InstructionCacheSize << 24 | value);
+        }
+
+        if (!record.isHalted)
+        {
+            // Not written, so the last bytes seen at this PC, which must be in the cache
+            const unsigned int cached = instructionCache[pc % InstructionCacheSize];
+            if (cached >> 24 != pc / InstructionCacheSize)
+                return false;
+            record.instruction = {static_cast<byte>(cached), static_cast<byte>(cached >> 8), static_cast<byte>(cached >> 16)};
+        }
+
+        for (unsigned int j = 0; j < RegisterCount; j++)
+        {
+            if (header >> (RegisterShift + j) & 1)
+            {
+                if (!read(2, value))
+                    return false;
+                registers[j] = static_cast<word>(value);
+            }
+        }
+
+        record.cycle = cycle;
+        record.state = {registers[0], registers[1], registers[2], registers[3], registers[4], pc, static_cast<byte>(status & ImeStatusBit)};
+        pc = static_cast<word>(pc + (record.isHalted ? 0 : sizes[record.instruction[0]]));
+    }
+
+    return position == encoded.size();
+}
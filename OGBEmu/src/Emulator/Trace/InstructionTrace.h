@@ -0,0 +1,166 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "Core/Definitions.h"
+
+#include "Emulator/Cpu.h"
+
+// Instruction trace file layout, all values little endian:
+//   0  magic "OGBT"
+//   4  version
+//   5  cartridge global checksum
+//   7  reserved
+//  16  blocks, each a record count (4 bytes), an encoded size (4 bytes) and the encoded records
+//
+// A record holds the cycle, PC, AF, BC, DE, HL, SP, the instruction bytes, IME and whether the CPU is halted. Blocks
+// are encoded on their own, each record as a header byte, the cycle delta from the previous record and the fields the
+// header flags, in this order:
+//   bit 7     IME in bit 0 and halted in bit 1 of a status byte, when they changed
+//   bit 0     PC, when it isn't the previous PC plus the previous instruction's size
+//   bit 1     the instruction's bytes, when they aren't the last ones seen at that PC, which a 256 entry cache mapped
+//             on the low byte of PC remembers. Halted records have none.
+//   bits 2-6  AF, BC, DE, HL and SP, when they changed
+// The cycle delta is 1 byte, or 0xFF followed by 8 bytes. Most records are the header, the cycle delta and AF, 4 bytes.
+namespace InstructionTrace
+{
+    constexpr char Magic[4] = {'O', 'G', 'B', 'T'};
+    constexpr byte Version = 2;
+    constexpr unsigned int HeaderSize = 16;
+    constexpr unsigned int BlockHeaderSize = 8;
+
+    struct Record
+    {
+        unsigned long long cycle = 0;
+        CpuState state{};
+        // The bytes past the instruction, and all of them for a halted CPU, aren't encoded and decode as 0
+        std::array<byte, 3> instruction{};
+        bool isHalted = false;
+    };
+
+    static_assert(std::endian::native == std::endian::little);
+
+    // Record header bits
+    constexpr byte PcBit = 1 << 0;
+    constexpr byte InstructionBit = 1 << 1;
+    constexpr unsigned int RegisterShift = 2;
+    constexpr byte SpBit = 1 << 6;
+    constexpr byte StatusBit = 1 << 7;
+    constexpr byte ImeStatusBit = 1 << 0;
+    constexpr byte HaltedStatusBit = 1 << 1;
+    constexpr byte LongCycleDelta = 0xFF;
+    // Small enough to stay out of the way of the emulator's own data in the CPU cache
+    constexpr unsigned int InstructionCacheSize = 256;
+    // Every field is written whole, the instruction as 4 bytes, and the output only advances past the ones a record
+    // keeps, which stays within this
+    constexpr unsigned int MaxEncodedRecordSize = 1 + 1 + 8 + 1 + 2 + 3 + 5 * 2;
+
+    using InstructionSizes = std::array<byte, 256>;
+
+    // Looked up for every record, the disassembler's own table is too large for that
+    [[nodiscard]] InstructionSizes MakeInstructionSizes();
+
+    // Encodes a block one record at a time, as they're recorded
+    class BlockEncoder
+    {
+    public:
+        BlockEncoder();
+
+        // output must hold MaxEncodedRecordSize bytes, returns the end of the encoded record
+        [[nodiscard]] FORCE_INLINE byte* Encode(const Record& record, byte* output);
+        // For the next block, which is decoded on its own
+        void Reset();
+
+    private:
+        // A single store, the trace being little endian like the host
+        FORCE_INLINE static void WriteWord(byte* output, const word value) { std::memcpy(output, &value, sizeof(value)); }
+
+        InstructionSizes _instructionSizes;
+        // Direct mapped on the low byte of PC, each entry holding the high byte above the instruction bytes
+        std::array<unsigned int, InstructionCacheSize> _instructionCache;
+        unsigned long long _previousCycle = 0;
+        word _predictedPc = 0;
+        byte _previousStatus = 0;
+        // AF in the low bits, then BC, DE and HL
+        unsigned long long _previousRegisters = 0;
+        word _previousSp = 0;
+    };
+
+    // Returns false when the encoded bytes don't hold exactly recordCount records
+    [[nodiscard]] bool DecodeBlock(const std::vector<byte>& encoded, unsigned int recordCount, std::vector<Record>& records);
+}
+
+FORCE_INLINE byte* InstructionTrace::BlockEncoder::Encode(const Record& record, byte* output)
+{
+    byte* headerOutput = output++;
+    byte header = 0;
+
+    // Only halts and interrupts take longer than a byte
+    const unsigned long long cycleDelta = record.cycle - _previousCycle;
+    if (cycleDelta < LongCycleDelta) [[likely]]
+        *output++ = static_cast<byte>(cycleDelta);
+    else
+    {
+        *output++ = LongCycleDelta;
+        std::memcpy(output, &cycleDelta, sizeof(cycleDelta));
+        output += sizeof(cycleDelta);
+    }
+
+    const byte status = (record.state.ime ? ImeStatusBit : 0) | (record.isHalted ? HaltedStatusBit : 0);
+    output[0] = status;
+    const bool isStatusChanged = status != _previousStatus;
+    output += isStatusChanged;
+    header |= isStatusChanged ? StatusBit : 0;
+
+    const word pc = record.state.pc;
+    WriteWord(output, pc);
+    const bool isPcChanged = pc != _predictedPc;
+    output += isPcChanged * 2;
+    header |= isPcChanged ? PcBit : 0;
+
+    // A halted CPU runs no instruction
+    const unsigned int instructionSize = record.isHalted ? 0 : _instructionSizes[record.instruction[0]];
+    const unsigned int instruction = (record.instruction[0] | record.instruction[1] << 8 | record.instruction[2] << 16) & ((1u << instructionSize * 8) - 1);
+    const unsigned int cacheEntry = static_cast<unsigned int>(pc / InstructionCacheSize) << 24 | instruction;
+    unsigned int& cached = _instructionCache[pc % InstructionCacheSize];
+    std::memcpy(output, &instruction, sizeof(instruction));
+    const bool isInstructionChanged = instructionSize != 0 && cached != cacheEntry;
+    output += isInstructionChanged * instructionSize;
+    header |= isInstructionChanged ? InstructionBit : 0;
+    cached = instructionSize != 0 ? cacheEntry : cached;
+
+    // AF, BC, DE and HL are compared at once, a 16 bit lane of their xor only having its top bit set by the carry of
+    // the add when the register changed. The multiply gathers the four top bits.
+    constexpr unsigned long long lowBits = 0x7FFF7FFF7FFF7FFF;
+    unsigned long long registers = 0;
+    std::memcpy(&registers, &record.state.af, sizeof(registers));
+    const unsigned long long changes = registers ^ _previousRegisters;
+    const unsigned long long changedLanes = ((changes & lowBits) + lowBits | changes) & ~lowBits;
+    const unsigned int changedRegisters = static_cast<unsigned int>((changedLanes >> 15) * 0x0000200040008001 >> 45) & 0xF;
+    WriteWord(output, static_cast<word>(registers));
+    output += (changedRegisters & 1) * 2;
+    WriteWord(output, static_cast<word>(registers >> 16));
+    output += (changedRegisters >> 1 & 1) * 2;
+    WriteWord(output, static_cast<word>(registers >> 32));
+    output += (changedRegisters >> 2 & 1) * 2;
+    WriteWord(output, static_cast<word>(registers >> 48));
+    output += (changedRegisters >> 3 & 1) * 2;
+
+    const word sp = record.state.sp;
+    WriteWord(output, sp);
+    const bool isSpChanged = sp != _previousSp;
+    output += isSpChanged * 2;
+    header |= static_cast<byte>(changedRegisters << RegisterShift | (isSpChanged ? SpBit : 0));
+    *headerOutput = header;
+
+    _previousCycle = record.cycle;
+    _predictedPc = static_cast<word>(pc + instructionSize);
+    _previousStatus = status;
+    _previousRegisters = registers;
+    _previousSp = sp;
+    return output;
+}
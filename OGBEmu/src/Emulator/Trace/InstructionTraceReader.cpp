@@ -0,0 +1,56 @@
+#include "InstructionTraceReader.h"
+
+#include <cstring>
+
+#include "Core/Logger.h"
+
+InstructionTraceReader::InstructionTraceReader(const std::string& filePath) : _file(filePath, std::ifstream::binary)
+{
+    if (!_file.good())
+    {
+        LOG("Error opening instruction trace " << filePath);
+        return;
+    }
+
+    _isValid = ReadHeader();
+    if (!_isValid)
+        LOG("Invalid instruction trace " << filePath);
+}
+
+bool InstructionTraceReader::ReadBlock(std::vector<InstructionTrace::Record>& records)
+{
+    records.clear();
+    if (!_isValid)
+        return false;
+
+    byte blockHeader[InstructionTrace::BlockHeaderSize];
+    if (!_file.read(reinterpret_cast<char*>(blockHeader), InstructionTrace::BlockHeaderSize))
+        return false;
+
+    const unsigned int recordCount = blockHeader[0] | blockHeader[1] << 8 | blockHeader[2] << 16 | static_cast<unsigned int>(blockHeader[3]) << 24;
+    const unsigned int encodedSize = blockHeader[4] | blockHeader[5] << 8 | blockHeader[6] << 16 | static_cast<unsigned int>(blockHeader[7]) << 24;
+
+    _encoded.resize(encodedSize);
+    if (!_file.read(reinterpret_cast<char*>(_encoded.data()), encodedSize) || !InstructionTrace::DecodeBlock(_encoded, recordCount, records))
+    {
+        LOG("Instruction trace is truncated or corrupted");
+        records.clear();
+        _isValid = false;
+        return false;
+    }
+
+    return true;
+}
+
+bool InstructionTraceReader::ReadHeader()
+{
+    byte header[InstructionTrace::HeaderSize];
+    if (!_file.read(reinterpret_cast<char*>(header), InstructionTrace::HeaderSize))
+        return false;
+
+    if (std::memcmp(header, InstructionTrace::Magic, sizeof(InstructionTrace::Magic)) != 0 || header[4] != InstructionTrace::Version)
+        return false;
+
+    _romChecksum = static_cast<word>(header[5] | header[6] << 8);
+    return true;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "InstructionTrace.h"
+
+// Streams a trace file one block at a time
+class InstructionTraceReader
+{
+public:
+    explicit InstructionTraceReader(const std::string& filePath);
+
+    [[nodiscard]] bool IsValid() const { return _isValid; }
+    [[nodiscard]] word GetRomChecksum() const { return _romChecksum; }
+
+    // Replaces records with the next block, returns false once the file ends or is truncated
+    bool ReadBlock(std::vector<InstructionTrace::Record>& records);
+
+private:
+    bool ReadHeader();
+
+    std::ifstream _file;
+    std::vector<byte> _encoded;
+    word _romChecksum = 0;
+    bool _isValid = false;
+};
@@ -0,0 +1,85 @@
+#include "InstructionTraceRecorder.h"
+
+#include "Core/Logger.h"
+
+namespace
+{
+    [[nodiscard]] std::unique_ptr<byte[]> MakeBlock(const unsigned int bufferRecords)
+    {
+        return std::make_unique_for_overwrite<byte[]>(InstructionTrace::BlockHeaderSize + static_cast<size_t>(bufferRecords) * InstructionTrace::MaxEncodedRecordSize);
+    }
+}
+
+InstructionTraceRecorder::InstructionTraceRecorder(const std::string& filePath, const word romChecksum, const unsigned int bufferRecords) :
+    _file(filePath, std::ofstream::binary),
+    _bufferRecords(bufferRecords > 0 ? bufferRecords : DefaultBufferRecords),
+    _block(MakeBlock(_bufferRecords)),
+    _output(_block.get() + InstructionTrace::BlockHeaderSize),
+    _writeBlock(MakeBlock(_bufferRecords))
+{
+    if (!_file.good())
+    {
+        LOG("Error opening instruction trace " << filePath);
+        return;
+    }
+
+    WriteHeader(romChecksum);
+    _isValid = _file.good();
+}
+
+InstructionTraceRecorder::~InstructionTraceRecorder()
+{
+    Flush();
+
+    if (_writer.joinable())
+        _writer.join();
+}
+
+void InstructionTraceRecorder::Flush()
+{
+    if (_bufferedRecords == 0)
+        return;
+
+    // Only one block is written at a time, which also keeps them in order
+    if (_writer.joinable())
+        _writer.join();
+
+    if (_isValid)
+    {
+        const size_t blockSize = static_cast<size_t>(_output - _block.get());
+        _block.swap(_writeBlock);
+        _writer = std::thread(&InstructionTraceRecorder::WriteBlock, this, _bufferedRecords, blockSize);
+        _flushedRecords += _bufferedRecords;
+    }
+
+    _output = _block.get() + InstructionTrace::BlockHeaderSize;
+    _encoder.Reset();
+    _bufferedRecords = 0;
+}
+
+void InstructionTraceRecorder::WriteHeader(const word romChecksum)
+{
+    const byte header[InstructionTrace::HeaderSize] =
+    {
+        static_cast<byte>(InstructionTrace::Magic[0]), static_cast<byte>(InstructionTrace::Magic[1]),
+        static_cast<byte>(InstructionTrace::Magic[2]), static_cast<byte>(InstructionTrace::Magic[3]),
+        InstructionTrace::Version,
+        static_cast<byte>(romChecksum), static_cast<byte>(romChecksum >> 8),
+    };
+
+    _file.write(reinterpret_cast<const char*>(header), InstructionTrace::HeaderSize);
+}
+
+void InstructionTraceRecorder::WriteBlock(const unsigned int recordCount, const size_t blockSize)
+{
+    const auto encodedSize = static_cast<unsigned int>(blockSize - InstructionTrace::BlockHeaderSize);
+    for (int i = 0; i < 4; i++)
+    {
+        _writeBlock[i] = static_cast<byte>(recordCount >> i * 8);
+        _writeBlock[4 + i] = static_cast<byte>(encodedSize >> i * 8);
+    }
+
+    _file.write(reinterpret_cast<const char*>(_writeBlock.get()), static_cast<std::streamsize>(blockSize));
+    if (!_file.good())
+        LOG("Error writing instruction trace block of " << recordCount << " records");
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "InstructionTrace.h"
+
+// Encodes each record as it's appended into a block buffer. Each time the block holds the buffer's record count, and
+// when the recorder is destroyed, the buffer is swapped with a second one that a writer thread writes to disk, so the
+// emulation only pays for encoding the record.
+class InstructionTraceRecorder
+{
+public:
+    static constexpr unsigned int DefaultBufferRecords = 1 << 16;
+
+    InstructionTraceRecorder(const std::string& filePath, word romChecksum, unsigned int bufferRecords = DefaultBufferRecords);
+    ~InstructionTraceRecorder();
+
+    // Only meaningful before the first flush, the file belongs to the writer thread afterwards
+    [[nodiscard]] bool IsValid() const { return _isValid; }
+    [[nodiscard]] unsigned long long GetRecordCount() const { return _flushedRecords + _bufferedRecords; }
+
+    FORCE_INLINE void Append(const InstructionTrace::Record& record)
+    {
+        _output = _encoder.Encode(record, _output);
+        if (++_bufferedRecords == _bufferRecords) [[unlikely]]
+            Flush();
+    }
+
+    void Flush();
+
+private:
+    void WriteHeader(word romChecksum);
+    void WriteBlock(unsigned int recordCount, size_t blockSize);
+
+    std::ofstream _file;
+    bool _isValid = false;
+    unsigned int _bufferRecords;
+    // Sized for a full block and left uninitialized, the encoder writes every byte it keeps. The block header goes
+    // first, once the block is complete.
+    std::unique_ptr<byte[]> _block;
+    byte* _output;
+    InstructionTrace::BlockEncoder _encoder;
+    unsigned int _bufferedRecords = 0;
+    unsigned long long _flushedRecords = 0;
+
+    // Owned by the writer thread while it runs
+    std::thread _writer;
+    std::unique_ptr<byte[]> _writeBlock;
+};
@@ -1,11 +1,48 @@
+#include <memory>
+#include <thread>
+
 #include "Core/Logger.h"
 #include "Core/Utils.h"
 
 #include "Emulator/Device.h"
+#include "Emulator/Audio/NullAudioSink.h"
+#include "Emulator/Audio/WavAudioSink.h"
+#include "Emulator/Input/InputMoviePlayer.h"
+#include "Emulator/Input/InputMovieRecorder.h"
+#include "Emulator/Link/LocalLinkCable.h"
+#include "Emulator/Link/SocketLinkCable.h"
+#include "Emulator/Recompiler/RecompiledModule.h"
+#include "Emulator/Trace/GoldenLogComparer.h"
+#include "Emulator/Trace/InstructionTraceRecorder.h"
 
 namespace
 {
     constexpr int FramesPerSecond = 128;
+
+    struct Options
+    {
+        std::string bootRomPath;
+        std::string romPath;
+        std::string wavPath;
+        bool nullAudio = false;
+        bool headless = false;
+        bool skipBootRom = false;
+        bool idleLoopSkipping = true;
+        // Frames the screen is shown ahead of the emulation, to hide input latency
+        unsigned int runAheadFrames = 0;
+        unsigned int maxFrames = 0;
+        std::vector<std::string> serialStopPatterns;
+        std::string linkRomPath;
+        std::string linkListenPath;
+        std::string linkConnectPath;
+        bool linkDeterministic = false;
+        std::string moviePlayPath;
+        std::string movieRecordPath;
+        std::string tracePath;
+        unsigned int traceBufferRecords = InstructionTraceRecorder::DefaultBufferRecords;
+        std::string goldenLogPath;
+        std::string recompiledModulePath;
+    };
 }
 
 std::vector<byte> ReadCartridge(const std::string& romPath)
@@ -26,19 +63,109 @@ std::vector<byte> ReadBootRom(const std::string& bootRomPath)
     return bootRomBytes;
 }
 
+bool ParseArguments(const int argc, char* argv[], Options& options)
+{
+    std::vector<std::string> positionalArguments;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (argument == "--headless")
+            options.headless = true;
+        else if (argument == "--skip-boot")
+            options.skipBootRom = true;
+        else if (argument == "--no-idle-skip")
+            options.idleLoopSkipping = false;
+        else if (argument == "--run-ahead" && hasValue)
+        {
+            if (!Utils::ParseUnsigned(argv[++i], options.runAheadFrames))
+                return false;
+        }
+        else if (argument == "--null-audio")
+            options.nullAudio = true;
+        else if (argument == "--wav" && hasValue)
+            options.wavPath = argv[++i];
+        else if (argument == "--serial-stop" && hasValue)
+            options.serialStopPatterns.emplace_back(argv[++i]);
+        else if (argument == "--link-local" && hasValue)
+            options.linkRomPath = argv[++i];
+        else if (argument == "--link-listen" && hasValue)
+            options.linkListenPath = argv[++i];
+        else if (argument == "--link-connect" && hasValue)
+            options.linkConnectPath = argv[++i];
+        else if (argument == "--link-deterministic")
+            options.linkDeterministic = true;
+        else if (argument == "--movie-play" && hasValue)
+            options.moviePlayPath = argv[++i];
+        else if (argument == "--movie-record" && hasValue)
+            options.movieRecordPath = argv[++i];
+        else if (argument == "--trace" && hasValue)
+            options.tracePath = argv[++i];
+        else if (argument == "--trace-buffer" && hasValue)
+        {
+            if (!Utils::ParseUnsigned(argv[++i], options.traceBufferRecords))
+                return false;
+        }
+        else if (argument == "--golden-log" && hasValue)
+            options.goldenLogPath = argv[++i];
+        else if (argument == "--recompiled" && hasValue)
+            options.recompiledModulePath = argv[++i];
+        else if (argument == "--frames" && hasValue)
+        {
+            if (!Utils::ParseUnsigned(argv[++i], options.maxFrames))
+                return false;
+        }
+        else if (argument.starts_with("--"))
+            return false;
+        else
+            positionalArguments.push_back(argument);
+    }
+
+    // Without the boot ROM, only the cartridge is given
+    if (positionalArguments.size() != (options.skipBootRom ? 1u : 2u))
+        return false;
+
+    if (!options.skipBootRom)
+        options.bootRomPath = positionalArguments[0];
+    options.romPath = positionalArguments.back();
+
+    return true;
+}
+
+// The first serial stop pattern is the passing one: the run succeeds only when it matched. Any other pattern exits
+// with its index + 1, and 1 means none matched before the run ended
+int GetExitCode(const Options& options, const int matchedSerialStopPattern)
+{
+    if (options.serialStopPatterns.empty())
+        return 0;
+
+    return matchedSerialStopPattern < 0 ? 1 : matchedSerialStopPattern == 0 ? 0 : matchedSerialStopPattern + 1;
+}
+
 int main(const int argc, char* argv[])
 {
-    if (argc != 3)
+    Options options;
+
+    if (!ParseArguments(argc, argv, options))
     {
-        DEBUGBREAKLOG("Wrong number of program arguments, usage: OGBEmu bootRom.bin romPath.gb");
+        DEBUGBREAKLOG("Wrong program arguments, usage: OGBEmu [--headless] [--skip-boot] [--no-idle-skip] [--run-ahead frames] [--frames count] [--wav output.wav | --null-audio] [--serial-stop passText [--serial-stop failText]...] "
+            "[--link-local otherRom.gb | --link-listen socketPath | --link-connect socketPath] [--link-deterministic] "
+            "[--movie-play input.ogbm] [--movie-record output.ogbm] [--trace output.ogbt [--trace-buffer records]] [--golden-log reference.log] [--recompiled module] (bootRom.bin romPath.gb | --skip-boot romPath.gb)");
         return 0;
     }
 
-    const std::string bootRomPath(argv[1]);
-    const std::vector<byte> bootRomBytes = ReadBootRom(bootRomPath);
+    // Left empty, the device starts from the post-boot state
+    std::vector<byte> bootRomBytes;
+    if (!options.skipBootRom)
+    {
+        bootRomBytes = ReadBootRom(options.bootRomPath);
+        if (bootRomBytes.empty())
+            return 0;
+    }
 
-    const std::string romPath(argv[2]);
-    const std::vector<byte> cartridgeBytes = ReadCartridge(romPath);
+    const std::vector<byte> cartridgeBytes = ReadCartridge(options.romPath);
 
     LOG("");
     LOG("Starting up device");
@@ -50,9 +177,146 @@ int main(const int argc, char* argv[])
         return 0;
     }
 
+    std::unique_ptr<BaseAudioSink> audioSink;
+    if (!options.wavPath.empty())
+    {
+        LOG("Writing audio to " << options.wavPath);
+        audioSink = std::make_unique<WavAudioSink>(options.wavPath, Apu::SampleRate);
+    }
+    else if (options.nullAudio)
+        audioSink = std::make_unique<NullAudioSink>();
+
+    device.SetAudioSink(audioSink.get());
+    device.SetHeadless(options.headless);
+    device.SetIdleLoopSkipping(options.idleLoopSkipping);
+    device.SetRunAheadFrames(options.runAheadFrames);
+    device.SetSerialStopPatterns(options.serialStopPatterns);
+
+    std::unique_ptr<RecompiledModule> recompiledModule;
+    if (!options.recompiledModulePath.empty())
+    {
+        recompiledModule = RecompiledModule::Load(options.recompiledModulePath);
+        if (!recompiledModule || !device.SetRecompiledModule(recompiledModule.get()))
+            return 0;
+
+        LOG("Running recompiled code from " << options.recompiledModulePath);
+    }
+
+    std::unique_ptr<InputMoviePlayer> moviePlayer;
+    if (!options.moviePlayPath.empty())
+    {
+        moviePlayer = std::make_unique<InputMoviePlayer>(options.moviePlayPath);
+        if (!moviePlayer->IsValid())
+            return 0;
+
+        const InputMovie::Header& header = moviePlayer->GetHeader();
+        if (header.framesPerSecond != device.GetFramesPerSecond() || header.romChecksum != device.GetCartridgeChecksum())
+            LOG("Input movie was recorded with a different ROM or frame rate, playback will likely desync");
+
+        // Unless told otherwise, the run lasts exactly as long as the movie
+        if (options.maxFrames == 0)
+            options.maxFrames = header.frameCount;
+
+        device.SetInputMoviePlayer(moviePlayer.get());
+    }
+
+    std::unique_ptr<InputMovieRecorder> movieRecorder;
+    if (!options.movieRecordPath.empty())
+    {
+        movieRecorder = std::make_unique<InputMovieRecorder>(options.movieRecordPath, static_cast<unsigned short>(device.GetFramesPerSecond()),
+                                                             device.GetCartridgeChecksum());
+        if (!movieRecorder->IsValid())
+            return 0;
+
+        device.SetInputMovieRecorder(movieRecorder.get());
+    }
+
+    std::unique_ptr<InstructionTraceRecorder> traceRecorder;
+    if (!options.tracePath.empty())
+    {
+        traceRecorder = std::make_unique<InstructionTraceRecorder>(options.tracePath, device.GetCartridgeChecksum(), options.traceBufferRecords);
+        if (!traceRecorder->IsValid())
+            return 0;
+
+        device.SetInstructionTraceRecorder(traceRecorder.get());
+        // Skipped loop iterations would leave holes in the trace
+        device.SetIdleLoopSkipping(false);
+    }
+
+    std::unique_ptr<GoldenLogComparer> goldenLogComparer;
+    if (!options.goldenLogPath.empty())
+    {
+        goldenLogComparer = std::make_unique<GoldenLogComparer>(options.goldenLogPath);
+        if (!goldenLogComparer->IsValid())
+            return 0;
+
+        device.SetGoldenLogComparer(goldenLogComparer.get());
+        // Reference logs have a line for every instruction, skipped loop iterations would desync them
+        device.SetIdleLoopSkipping(false);
+    }
+
+    std::unique_ptr<BaseLinkCable> linkCable;
+    std::unique_ptr<BaseLinkCable> otherLinkCable;
+    std::unique_ptr<Device> otherDevice;
+    if (!options.linkRomPath.empty())
+    {
+        otherDevice = std::make_unique<Device>(bootRomBytes, ReadCartridge(options.linkRomPath), FramesPerSecond);
+        if (!otherDevice->IsValid())
+        {
+            LOG("Invalid linked device, quitting");
+            return 0;
+        }
+
+        otherDevice->SetHeadless(options.headless);
+        std::tie(linkCable, otherLinkCable) = LocalLinkCable::CreatePair();
+        otherDevice->ConnectLink(otherLinkCable.get(), options.linkDeterministic);
+    }
+    else if (!options.linkListenPath.empty())
+        linkCable = SocketLinkCable::Listen(options.linkListenPath);
+    else if (!options.linkConnectPath.empty())
+        linkCable = SocketLinkCable::Connect(options.linkConnectPath);
+
+    if (linkCable)
+        device.ConnectLink(linkCable.get(), options.linkDeterministic);
+
     LOG("Running");
-    device.Run();
+    std::thread otherDeviceThread;
+    if (otherDevice)
+        otherDeviceThread = std::thread([&otherDevice, &options] { otherDevice->Run(options.maxFrames); });
+
+    device.Run(options.maxFrames);
+
+    if (otherDeviceThread.joinable())
+        otherDeviceThread.join();
+
+    if (!device.GetSerialOutput().empty())
+        LOG("Serial output:\n" << device.GetSerialOutput());
+
+    if (otherDevice && !otherDevice->GetSerialOutput().empty())
+        LOG("Linked device serial output:\n" << otherDevice->GetSerialOutput());
+
+    if (traceRecorder)
+        LOG("Traced " << traceRecorder->GetRecordCount() << " instructions to " << options.tracePath);
+
+    if (goldenLogComparer)
+    {
+        if (goldenLogComparer->HasMismatch())
+        {
+            LOG("Golden log mismatch after " << goldenLogComparer->GetMatchedLineCount() << " matching lines\n"
+                << "Previous: " << goldenLogComparer->GetPreviousLine() << "\n"
+                << "Expected: " << goldenLogComparer->GetExpectedLine() << "\n"
+                << "Actual:   " << goldenLogComparer->GetActualLine());
+        }
+        else if (goldenLogComparer->HasReachedEnd())
+            LOG("Golden log fully matched, " << goldenLogComparer->GetMatchedLineCount() << " lines");
+        else
+            LOG("Golden log matched until the run ended, " << goldenLogComparer->GetMatchedLineCount() << " lines");
+    }
+
+    const int matchedPattern = device.GetMatchedSerialStopPattern();
+    if (matchedPattern >= 0)
+        LOG("Serial output matched \"" << options.serialStopPatterns[matchedPattern] << "\"");
 
     LOG("Finished");
-    return 0;
+    return GetExitCode(options, matchedPattern);
 }
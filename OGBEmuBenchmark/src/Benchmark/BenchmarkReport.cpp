@@ -0,0 +1,181 @@
+#include "BenchmarkReport.h"
+
+#include <ctime>
+#include <format>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "Core/Logger.h"
+
+namespace
+{
+    std::string EscapeJson(const std::string& text)
+    {
+        std::string escaped;
+        for (const char character : text)
+        {
+            if (character == '"' || character == '\\')
+                escaped.push_back('\\');
+            escaped.push_back(character);
+        }
+
+        return escaped;
+    }
+
+    // Finds "key": after position and returns where its value starts
+    size_t FindValue(const std::string& json, const std::string& key, const size_t position)
+    {
+        const size_t keyPosition = json.find('"' + key + "\":", position);
+        if (keyPosition == std::string::npos)
+            return std::string::npos;
+
+        return json.find_first_not_of(' ', keyPosition + key.size() + 3);
+    }
+
+    std::string ReadString(const std::string& json, const size_t position)
+    {
+        std::string text;
+        for (size_t i = position + 1; i < json.size() && json[i] != '"'; i++)
+        {
+            if (json[i] == '\\' && i + 1 < json.size())
+                i++;
+            text.push_back(json[i]);
+        }
+
+        return text;
+    }
+}
+
+bool BenchmarkReport::WriteJson(const std::string& filePath, const std::vector<BenchmarkResult>& results)
+{
+    std::ofstream file(filePath);
+    if (!file.good())
+    {
+        LOG("Error opening benchmark output " << filePath);
+        return false;
+    }
+
+    const std::time_t now = std::time(nullptr);
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    file << "{\n";
+    file << "  \"context\": {\n";
+    file << "    \"date\": \"" << date << "\",\n";
+    file << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef HZ_DEBUG
+    file << "    \"library_build_type\": \"debug\"\n";
+#else
+    file << "    \"library_build_type\": \"release\"\n";
+#endif
+    file << "  },\n";
+    file << "  \"benchmarks\": [\n";
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult& result = results[i];
+
+        file << "    {\n";
+        file << "      \"name\": \"" << EscapeJson(result.name) << "\",\n";
+        file << "      \"run_name\": \"" << EscapeJson(result.name) << "\",\n";
+        file << "      \"run_type\": \"iteration\",\n";
+        if (!result.error.empty())
+        {
+            file << "      \"error_occurred\": true,\n";
+            file << "      \"error_message\": \"" << EscapeJson(result.error) << "\"\n";
+        }
+        else
+        {
+            file << "      \"iterations\": " << result.iterations << ",\n";
+            file << "      \"real_time\": " << std::format("{:.6e}", result.realTime) << ",\n";
+            file << "      \"cpu_time\": " << std::format("{:.6e}", result.cpuTime) << ",\n";
+            file << "      \"time_unit\": \"ns\"";
+            if (result.itemsPerSecond > 0)
+                file << ",\n      \"items_per_second\": " << std::format("{:.6e}", result.itemsPerSecond);
+            if (result.bytesPerSecond > 0)
+                file << ",\n      \"bytes_per_second\": " << std::format("{:.6e}", result.bytesPerSecond);
+            if (!result.label.empty())
+                file << ",\n      \"label\": \"" << EscapeJson(result.label) << "\"";
+            file << "\n";
+        }
+        file << (i + 1 < results.size() ? "    },\n" : "    }\n");
+    }
+
+    file << "  ]\n";
+    file << "}\n";
+
+    return file.good();
+}
+
+bool BenchmarkReport::ReadJson(const std::string& filePath, std::vector<BenchmarkResult>& results)
+{
+    std::ifstream file(filePath);
+    if (!file.good())
+    {
+        LOG("Error opening benchmark baseline " << filePath);
+        return false;
+    }
+
+    std::stringstream stream;
+    stream << file.rdbuf();
+    const std::string json = stream.str();
+
+    size_t position = json.find("\"benchmarks\"");
+    while (position != std::string::npos)
+    {
+        const size_t namePosition = FindValue(json, "name", position);
+        if (namePosition == std::string::npos)
+            break;
+
+        BenchmarkResult result;
+        result.name = ReadString(json, namePosition);
+
+        // Errored runs have no timings, don't let the next benchmark's be picked up
+        const size_t nextNamePosition = FindValue(json, "name", namePosition);
+        const size_t realTimePosition = FindValue(json, "real_time", namePosition);
+        const size_t cpuTimePosition = FindValue(json, "cpu_time", namePosition);
+        if (realTimePosition != std::string::npos && realTimePosition < nextNamePosition)
+        {
+            result.realTime = std::stod(json.substr(realTimePosition, 32));
+            result.cpuTime = std::stod(json.substr(cpuTimePosition, 32));
+        }
+        else
+            result.error = "No timings";
+
+        results.push_back(result);
+        position = namePosition;
+    }
+
+    return true;
+}
+
+bool BenchmarkReport::CompareToBaseline(const std::vector<BenchmarkResult>& results, const std::vector<BenchmarkResult>& baseline,
+                                        const double maxRegressionPercent)
+{
+    bool passed = true;
+
+    for (const BenchmarkResult& result : results)
+    {
+        if (!result.error.empty())
+            continue;
+
+        for (const BenchmarkResult& baselineResult : baseline)
+        {
+            if (baselineResult.name != result.name || !baselineResult.error.empty() || baselineResult.cpuTime <= 0)
+                continue;
+
+            // CPU time is less sensitive to the machine being busy than wall time
+            const double changePercent = (result.cpuTime / baselineResult.cpuTime - 1.) * 100.;
+            if (changePercent > maxRegressionPercent)
+            {
+                LOG(std::format("Regression: {} went from {:.1f} ns to {:.1f} ns ({:+.1f}%)", result.name, baselineResult.cpuTime, result.cpuTime,
+                    changePercent));
+                passed = false;
+            }
+            break;
+        }
+    }
+
+    return passed;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "BenchmarkRunner.h"
+
+// Results are written in Google Benchmark's JSON layout so existing tooling, like its compare.py, can consume them
+namespace BenchmarkReport
+{
+    bool WriteJson(const std::string& filePath, const std::vector<BenchmarkResult>& results);
+    // Only reads back what WriteJson produces, the name and timings of each benchmark
+    bool ReadJson(const std::string& filePath, std::vector<BenchmarkResult>& results);
+
+    // Logs every benchmark slower than its baseline by more than the allowed percentage, returns false if any is
+    [[nodiscard]] bool CompareToBaseline(const std::vector<BenchmarkResult>& results, const std::vector<BenchmarkResult>& baseline,
+                                         double maxRegressionPercent);
+}
@@ -0,0 +1,87 @@
+#include "BenchmarkRunner.h"
+
+#include <algorithm>
+#include <format>
+
+#include "Core/Logger.h"
+
+namespace
+{
+    constexpr unsigned long long MaxIterations = 1000000000;
+    constexpr double NanosecondsPerSecond = 1e9;
+}
+
+void BenchmarkRunner::Register(const std::string& name, const BenchmarkFunction& function)
+{
+    _benchmarks.push_back({name, function});
+}
+
+std::vector<BenchmarkResult> BenchmarkRunner::Run() const
+{
+    std::vector<BenchmarkResult> results;
+
+    LOG(std::format("{:<48} {:>14} {:>14} {:>12} {:>16}", "Benchmark", "Time", "CPU", "Iterations", "Rate"));
+    LOG(std::string(108, '-'));
+
+    for (const Benchmark& benchmark : _benchmarks)
+    {
+        if (!_filter.empty() && benchmark.name.find(_filter) == std::string::npos)
+            continue;
+
+        const BenchmarkResult result = RunBenchmark(benchmark);
+
+        if (!result.error.empty())
+            LOG(std::format("{:<48} ERROR: {}", result.name, result.error));
+        else
+        {
+            std::string rate;
+            if (result.bytesPerSecond > 0)
+                rate = std::format("{:.4g} MiB/s", result.bytesPerSecond / (1024 * 1024));
+            else if (result.itemsPerSecond > 0)
+                rate = std::format("{:.4g} items/s", result.itemsPerSecond);
+            LOG(std::format("{:<48} {:>11.1f} ns {:>11.1f} ns {:>12} {:>16} {}", result.name, result.realTime, result.cpuTime,
+                result.iterations, rate, result.label));
+        }
+
+        results.push_back(result);
+    }
+
+    return results;
+}
+
+BenchmarkResult BenchmarkRunner::RunBenchmark(const Benchmark& benchmark) const
+{
+    unsigned long long iterations = 1;
+
+    while (true)
+    {
+        BenchmarkState state(iterations);
+
+        // Emulator logs would be measured along with the code under test
+        Logger::SetMuted(true);
+        benchmark.function(state);
+        Logger::SetMuted(false);
+
+        const double seconds = state.GetRealTimeSeconds();
+        const bool isLongEnough = seconds >= _minTimeSeconds || iterations >= MaxIterations;
+
+        if (isLongEnough || !state.GetError().empty())
+        {
+            BenchmarkResult result;
+            result.name = benchmark.name;
+            result.iterations = iterations;
+            result.realTime = seconds * NanosecondsPerSecond / static_cast<double>(iterations);
+            result.cpuTime = state.GetCpuTimeSeconds() * NanosecondsPerSecond / static_cast<double>(iterations);
+            result.itemsPerSecond = seconds > 0 ? static_cast<double>(state.GetItemsProcessed()) / seconds : 0;
+            result.bytesPerSecond = seconds > 0 ? static_cast<double>(state.GetBytesProcessed()) / seconds : 0;
+            result.label = state.GetLabel();
+            result.error = state.GetError();
+            return result;
+        }
+
+        // Aim a bit past the minimum time from the last run, growing at most tenfold when it was too short to tell
+        const double multiplier = seconds / _minTimeSeconds > 0.1 ? _minTimeSeconds * 1.4 / seconds : 10.;
+        const unsigned long long nextIterations = static_cast<unsigned long long>(static_cast<double>(iterations) * multiplier);
+        iterations = std::min(std::max(nextIterations, iterations + 1), MaxIterations);
+    }
+}
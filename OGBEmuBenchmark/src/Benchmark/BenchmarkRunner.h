@@ -0,0 +1,49 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "BenchmarkState.h"
+
+struct BenchmarkResult
+{
+    std::string name;
+    unsigned long long iterations = 0;
+    // Per iteration, in nanoseconds
+    double realTime = 0;
+    double cpuTime = 0;
+    double itemsPerSecond = 0;
+    double bytesPerSecond = 0;
+    std::string label;
+    std::string error;
+};
+
+// Runs registered benchmarks the way Google Benchmark does: the iteration count grows until a run lasts at least the
+// minimum time, and only that last run is reported.
+class BenchmarkRunner
+{
+public:
+    using BenchmarkFunction = std::function<void(BenchmarkState&)>;
+
+    void Register(const std::string& name, const BenchmarkFunction& function);
+
+    void SetMinTime(const double minTimeSeconds) { _minTimeSeconds = minTimeSeconds; }
+    // Only benchmarks whose name contains the filter run, an empty filter runs everything
+    void SetFilter(const std::string& filter) { _filter = filter; }
+
+    [[nodiscard]] std::vector<BenchmarkResult> Run() const;
+
+private:
+    struct Benchmark
+    {
+        std::string name;
+        BenchmarkFunction function;
+    };
+
+    [[nodiscard]] BenchmarkResult RunBenchmark(const Benchmark& benchmark) const;
+
+    std::vector<Benchmark> _benchmarks;
+    double _minTimeSeconds = 0.5;
+    std::string _filter;
+};
@@ -0,0 +1,31 @@
+#include "BenchmarkState.h"
+
+BenchmarkState::BenchmarkState(const unsigned long long iterations) : _iterations(iterations), _remainingIterations(iterations)
+{
+}
+
+void BenchmarkState::PauseTiming()
+{
+    if (!_isTiming)
+        return;
+
+    _realTimeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - _realStartTime).count();
+    _cpuTimeSeconds += static_cast<double>(std::clock() - _cpuStartTime) / CLOCKS_PER_SEC;
+    _isTiming = false;
+}
+
+void BenchmarkState::ResumeTiming()
+{
+    if (_isTiming)
+        return;
+
+    _realStartTime = std::chrono::steady_clock::now();
+    _cpuStartTime = std::clock();
+    _isTiming = true;
+}
+
+void BenchmarkState::SkipWithError(const std::string& error)
+{
+    _error = error;
+    _remainingIterations = 0;
+}
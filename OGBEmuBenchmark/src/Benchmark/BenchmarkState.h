@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+#include <ctime>
+#include <string>
+
+// Handed to every benchmark, which runs its measured code once per KeepRunning call:
+//
+//     while (state.KeepRunning())
+//         device.Step();
+//
+// Timing starts on the first call and stops when the iterations run out. Setup done before the loop isn't measured,
+// PauseTiming and ResumeTiming exclude work inside it.
+class BenchmarkState
+{
+public:
+    explicit BenchmarkState(unsigned long long iterations);
+
+    bool KeepRunning()
+    {
+        if (_remainingIterations > 0) [[likely]]
+        {
+            if (_remainingIterations-- == _iterations) [[unlikely]]
+                ResumeTiming();
+            return true;
+        }
+
+        PauseTiming();
+        return false;
+    }
+
+    void PauseTiming();
+    void ResumeTiming();
+
+    [[nodiscard]] unsigned long long GetIterations() const { return _iterations; }
+    [[nodiscard]] double GetRealTimeSeconds() const { return _realTimeSeconds; }
+    [[nodiscard]] double GetCpuTimeSeconds() const { return _cpuTimeSeconds; }
+
+    // Totals over all iterations, reported as rates
+    void SetItemsProcessed(const unsigned long long items) { _itemsProcessed = items; }
+    void SetBytesProcessed(const unsigned long long bytes) { _bytesProcessed = bytes; }
+    void SetLabel(const std::string& label) { _label = label; }
+    // Marks the run as unusable, the runner reports the message instead of timings
+    void SkipWithError(const std::string& error);
+
+    [[nodiscard]] unsigned long long GetItemsProcessed() const { return _itemsProcessed; }
+    [[nodiscard]] unsigned long long GetBytesProcessed() const { return _bytesProcessed; }
+    [[nodiscard]] const std::string& GetLabel() const { return _label; }
+    [[nodiscard]] const std::string& GetError() const { return _error; }
+
+private:
+    unsigned long long _iterations;
+    unsigned long long _remainingIterations;
+
+    bool _isTiming = false;
+    std::chrono::steady_clock::time_point _realStartTime;
+    std::clock_t _cpuStartTime = 0;
+    double _realTimeSeconds = 0;
+    double _cpuTimeSeconds = 0;
+
+    unsigned long long _itemsProcessed = 0;
+    unsigned long long _bytesProcessed = 0;
+    std::string _label;
+    std::string _error;
+};
+
+// Keeps a computed value alive so the compiler can't drop the work producing it
+template <typename T>
+void DoNotOptimize(const T& value)
+{
+    static volatile T sink;
+    sink = value;
+}
@@ -0,0 +1,60 @@
+#include "Benchmarks.h"
+
+#include "Benchmark/BenchmarkRunner.h"
+#include "Emulator/Disassembly/ControlFlowGraph.h"
+#include "Emulator/Disassembly/Disassembler.h"
+#include "Workloads/Workloads.h"
+
+namespace
+{
+    constexpr unsigned int BankSize = 0x4000;
+    // The largest ROM a cartridge header can describe
+    constexpr unsigned int MaxRomSize = 8 * 1024 * 1024;
+
+    void RegisterControlFlowGraph(BenchmarkRunner& runner, const std::string& name, const std::vector<byte>& rom)
+    {
+        runner.Register(name, [rom](BenchmarkState& state)
+        {
+            while (state.KeepRunning())
+            {
+                const ControlFlowGraph graph(rom);
+                DoNotOptimize(graph.GetBlocks().size());
+            }
+
+            state.SetBytesProcessed(state.GetIterations() * rom.size());
+        });
+    }
+}
+
+void Benchmarks::RegisterAnalysisBenchmarks(BenchmarkRunner& runner)
+{
+    const std::vector<byte> rom = Workloads::Build(Workload::BankSwitch);
+
+    // Linear sweep over the whole ROM, whether it's code or not
+    runner.Register("Analysis/Decode", [rom](BenchmarkState& state)
+    {
+        unsigned int sum = 0;
+        while (state.KeepRunning())
+        {
+            for (unsigned int romOffset = 0; romOffset + 3 <= rom.size();)
+            {
+                const Disassembler::Instruction instruction = Disassembler::Decode(&rom[romOffset], static_cast<word>(romOffset));
+                sum += instruction.target;
+                romOffset += instruction.info->size;
+            }
+        }
+
+        DoNotOptimize(sum);
+        state.SetBytesProcessed(state.GetIterations() * rom.size());
+    });
+
+    RegisterControlFlowGraph(runner, "Analysis/ControlFlowGraph/BankSwitch", rom);
+
+    // The switchable banks repeated up to the largest ROM, every one of them reached from bank 0
+    std::vector<byte> largestRom(rom);
+    largestRom.resize(MaxRomSize);
+    for (size_t romOffset = rom.size(); romOffset < largestRom.size(); romOffset++)
+        largestRom[romOffset] = rom[BankSize + (romOffset - BankSize) % (rom.size() - BankSize)];
+
+    RegisterControlFlowGraph(runner, "Analysis/ControlFlowGraph/8MiB", largestRom);
+}
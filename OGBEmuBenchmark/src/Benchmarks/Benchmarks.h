@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+class BenchmarkRunner;
+
+// Benchmarks are named "<Group>/<Subject>", the runner filter selects them by substring
+namespace Benchmarks
+{
+    // One benchmark per opcode, each reports the time of a single instruction
+    void RegisterCpuBenchmarks(BenchmarkRunner& runner);
+    void RegisterBusBenchmarks(BenchmarkRunner& runner);
+    void RegisterCartridgeBenchmarks(BenchmarkRunner& runner);
+    // Whole headless frames on every generated workload, plus every .gb file of romDirectory when not empty
+    void RegisterFrameBenchmarks(BenchmarkRunner& runner, const std::string& romDirectory);
+    // Disassembly and control flow graphs of generated ROMs, up to the largest size a cartridge can have
+    void RegisterAnalysisBenchmarks(BenchmarkRunner& runner);
+    // Lane frames of a LockstepRunner against as many separate devices, and forking a device
+    void RegisterLockstepBenchmarks(BenchmarkRunner& runner);
+    // Steps of several environments taking turns on one thread, with their screen observations
+    void RegisterEnvironmentBenchmarks(BenchmarkRunner& runner);
+    // Fuzzing runs of a few workloads, each restoring the post-boot snapshot and recording coverage
+    void RegisterFuzzBenchmarks(BenchmarkRunner& runner);
+    // Copying a device state, and frames shown ahead of the emulation at a few distances
+    void RegisterRunAheadBenchmarks(BenchmarkRunner& runner);
+}
@@ -0,0 +1,170 @@
+#include "Benchmarks.h"
+
+#include <memory>
+
+#include "Benchmark/BenchmarkRunner.h"
+#include "Emulator/Joypad.h"
+#include "Emulator/Scheduler.h"
+#include "Emulator/Serial.h"
+#include "Emulator/Timer.h"
+#include "Emulator/Audio/Apu.h"
+#include "Emulator/Memory/AddressConstants.h"
+#include "Emulator/Memory/BootRom.h"
+#include "Emulator/Memory/Bus.h"
+#include "Emulator/Memory/Cartridge.h"
+#include "Emulator/Memory/Hdma.h"
+#include "Emulator/Memory/HRam.h"
+#include "Emulator/Memory/IoRegisters.h"
+#include "Emulator/Memory/Oam.h"
+#include "Emulator/Memory/VRam.h"
+#include "Emulator/Memory/WRam.h"
+#include "Emulator/Memory/WRamCgb.h"
+#include "Workloads/RomBuilder.h"
+
+namespace
+{
+    constexpr unsigned int AccessesPerIteration = 256;
+    constexpr byte DmaSourcePage = 0xC0;
+
+    // The same components a Device wires, with the boot ROM unmapped so reads reach the cartridge
+    struct BusFixture
+    {
+        BusFixture() : bootRom(RomBuilder::CreateBootRom()),
+                       cartridge(RomBuilder("BUS").Build()),
+                       joypad(&ioRegisters),
+                       serial(&scheduler, &ioRegisters),
+                       timer(&scheduler, &ioRegisters),
+                       apu(&scheduler),
+                       hdma(&scheduler, &bus, &vRam, &ioRegisters),
+                       bus(&bootRom, &cartridge, &vRam, &wRam, &wRamCgb, &oam, &ioRegisters, &hRam, &joypad, &serial, &timer, &apu, &hdma)
+        {
+            bus.Write(AddressConstants::BootRomBank, 1);
+        }
+
+        Scheduler scheduler;
+        BootRom bootRom;
+        Cartridge cartridge;
+        VRam vRam;
+        WRam wRam;
+        WRamCgb wRamCgb;
+        Oam oam;
+        IoRegisters ioRegisters;
+        HRam hRam;
+        Joypad joypad;
+        Serial serial;
+        Timer timer;
+        Apu apu;
+        Hdma hdma;
+        Bus bus;
+    };
+
+    struct Region
+    {
+        const char* name;
+        word startAddress;
+        bool isWritable;
+    };
+
+    // Echo and external RAM, like unused addresses, log on every access and have no benchmark
+    constexpr Region Regions[] =
+    {
+        {"RomBank0", AddressConstants::StartRomBank0Address + 0x200, false},
+        {"RomBankN", AddressConstants::StartRomBankNAddress, false},
+        {"VRam", AddressConstants::StartVRamAddress, true},
+        {"WRam", AddressConstants::StartWRamAddress, true},
+        {"WRamCgb", AddressConstants::StartWRamCgbAddress, true},
+        {"Oam", AddressConstants::StartOamAddress, true},
+        {"HRam", AddressConstants::StartHRamAddress, true},
+    };
+
+    void RegisterRegion(BenchmarkRunner& runner, const Region& region)
+    {
+        // OAM and HRAM are smaller than a batch of accesses, the batch wraps around them
+        const word size = region.startAddress == AddressConstants::StartOamAddress ? 0xA0 :
+            region.startAddress == AddressConstants::StartHRamAddress ? 0x7F : AccessesPerIteration;
+
+        runner.Register(std::string("Bus/Read/") + region.name, [region, size](BenchmarkState& state)
+        {
+            const auto fixture = std::make_unique<BusFixture>();
+
+            unsigned int sum = 0;
+            while (state.KeepRunning())
+            {
+                for (unsigned int i = 0; i < AccessesPerIteration; i++)
+                    sum += fixture->bus.Read(static_cast<word>(region.startAddress + i % size));
+            }
+
+            state.SetBytesProcessed(state.GetIterations() * AccessesPerIteration);
+            DoNotOptimize(sum);
+        });
+
+        if (!region.isWritable)
+            return;
+
+        runner.Register(std::string("Bus/Write/") + region.name, [region, size](BenchmarkState& state)
+        {
+            const auto fixture = std::make_unique<BusFixture>();
+
+            while (state.KeepRunning())
+            {
+                for (unsigned int i = 0; i < AccessesPerIteration; i++)
+                    fixture->bus.Write(static_cast<word>(region.startAddress + i % size), static_cast<byte>(i));
+            }
+
+            state.SetBytesProcessed(state.GetIterations() * AccessesPerIteration);
+        });
+    }
+}
+
+void Benchmarks::RegisterBusBenchmarks(BenchmarkRunner& runner)
+{
+    for (const Region& region : Regions)
+        RegisterRegion(runner, region);
+
+    // Interrupt flags and enable are read before every instruction
+    runner.Register("Bus/Read/InterruptFlags", [](BenchmarkState& state)
+    {
+        const auto fixture = std::make_unique<BusFixture>();
+
+        unsigned int sum = 0;
+        while (state.KeepRunning())
+        {
+            for (unsigned int i = 0; i < AccessesPerIteration; i++)
+                sum += fixture->bus.Read(i & 1 ? AddressConstants::StartIeAddress : AddressConstants::InterruptFlag);
+        }
+
+        state.SetBytesProcessed(state.GetIterations() * AccessesPerIteration);
+        DoNotOptimize(sum);
+    });
+
+    runner.Register("Bus/Dma", [](BenchmarkState& state)
+    {
+        const auto fixture = std::make_unique<BusFixture>();
+
+        constexpr word oamSize = AddressConstants::EndOamAddress - AddressConstants::StartOamAddress + 1;
+        while (state.KeepRunning())
+            fixture->bus.Write(AddressConstants::DmaStart, DmaSourcePage);
+
+        state.SetBytesProcessed(state.GetIterations() * oamSize);
+    });
+
+    runner.Register("Bus/GeneralPurposeDma", [](BenchmarkState& state)
+    {
+        const auto fixture = std::make_unique<BusFixture>();
+        fixture->bus.SetCgbMode(true);
+
+        // The whole 2 KiB a single transfer can copy, from WRAM to the start of the VRAM
+        constexpr unsigned int transferSize = 0x80 * 0x10;
+        while (state.KeepRunning())
+        {
+            fixture->bus.Write(AddressConstants::Hdma1, DmaSourcePage);
+            fixture->bus.Write(AddressConstants::Hdma2, 0x00);
+            fixture->bus.Write(AddressConstants::Hdma3, 0x00);
+            fixture->bus.Write(AddressConstants::Hdma4, 0x00);
+            fixture->bus.Write(AddressConstants::Hdma5, 0x7F);
+            DoNotOptimize(fixture->hdma.TakeStallCycles());
+        }
+
+        state.SetBytesProcessed(state.GetIterations() * transferSize);
+    });
+}
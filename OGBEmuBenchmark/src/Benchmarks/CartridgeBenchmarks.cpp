@@ -0,0 +1,74 @@
+#include "Benchmarks.h"
+
+#include "Benchmark/BenchmarkRunner.h"
+#include "Emulator/Memory/AddressConstants.h"
+#include "Emulator/Memory/Cartridge.h"
+#include "Workloads/RomBuilder.h"
+#include "Workloads/Workloads.h"
+
+namespace
+{
+    constexpr unsigned int ReadsPerIteration = 256;
+    constexpr word RomBankSelectAddress = 0x2000;
+
+    void RegisterCartridgeReads(BenchmarkRunner& runner, const std::string& name, const std::vector<byte>& rom, const word startAddress)
+    {
+        runner.Register(name, [rom, startAddress](BenchmarkState& state)
+        {
+            const Cartridge cartridge(rom);
+
+            unsigned int sum = 0;
+            while (state.KeepRunning())
+            {
+                for (unsigned int i = 0; i < ReadsPerIteration; i++)
+                    sum += cartridge.Read(static_cast<word>(startAddress + i));
+            }
+
+            DoNotOptimize(sum);
+            state.SetBytesProcessed(state.GetIterations() * ReadsPerIteration);
+        });
+    }
+}
+
+void Benchmarks::RegisterCartridgeBenchmarks(BenchmarkRunner& runner)
+{
+    const std::vector<byte> noMbcRom = RomBuilder("NOMBC").Build();
+
+    runner.Register("Cartridge/Load/NoMbc", [noMbcRom](BenchmarkState& state)
+    {
+        while (state.KeepRunning())
+        {
+            const Cartridge cartridge(noMbcRom);
+            DoNotOptimize(cartridge.IsValid());
+        }
+
+        state.SetBytesProcessed(state.GetIterations() * noMbcRom.size());
+    });
+
+    RegisterCartridgeReads(runner, "Cartridge/Read/NoMbc/Bank0", noMbcRom, AddressConstants::StartRomBank0Address);
+    RegisterCartridgeReads(runner, "Cartridge/Read/NoMbc/BankN", noMbcRom, AddressConstants::StartRomBankNAddress);
+
+    const std::vector<byte> mbc1Rom = Workloads::Build(Workload::BankSwitch);
+    RegisterCartridgeReads(runner, "Cartridge/Read/Mbc1/Bank0", mbc1Rom, AddressConstants::StartRomBank0Address);
+    RegisterCartridgeReads(runner, "Cartridge/Read/Mbc1/BankN", mbc1Rom, AddressConstants::StartRomBankNAddress);
+
+    // A bank switch followed by a read from the new bank
+    runner.Register("Cartridge/BankSwitch/Mbc1", [mbc1Rom](BenchmarkState& state)
+    {
+        const Cartridge cartridge(mbc1Rom);
+
+        unsigned int sum = 0;
+        byte bank = 0;
+        while (state.KeepRunning())
+        {
+            for (unsigned int i = 0; i < ReadsPerIteration; i++)
+            {
+                cartridge.Write(RomBankSelectAddress, ++bank);
+                sum += cartridge.Read(AddressConstants::StartRomBankNAddress);
+            }
+        }
+
+        DoNotOptimize(sum);
+        state.SetItemsProcessed(state.GetIterations() * ReadsPerIteration);
+    });
+}
@@ -0,0 +1,207 @@
+#include "Benchmarks.h"
+
+#include <format>
+#include <optional>
+
+#include "Benchmark/BenchmarkRunner.h"
+#include "Emulator/Device.h"
+#include "Workloads/RomBuilder.h"
+
+namespace
+{
+    // Enough for every instruction of the loop to dominate the preamble resetting the registers, few enough that
+    // pointers walking memory stay within work RAM
+    constexpr unsigned int InstructionCopies = 128;
+    constexpr unsigned int WarmupSteps = 1024;
+
+    constexpr word DataAddress = 0xC880;
+    constexpr word StackAddress = 0xD800;
+    constexpr byte HRamOffset = 0x80;
+
+    constexpr byte Ret = 0xC9;
+    constexpr byte Call = 0xCD;
+
+    enum class Pairing : byte
+    {
+        None,
+        // Called from the loop, the stub returns right away
+        CalledStub,
+        // The vector holds a RET
+        RstVector,
+        // LD HL with the address following the jump
+        LoadHl
+    };
+
+    struct OpcodeBenchmark
+    {
+        std::string name;
+        Pairing pairing = Pairing::None;
+        // Flags are set with OR A unless the opcode needs others to keep to its safe path
+        byte flagsSetup = 0xB7;
+    };
+
+    // Operand sizes of the base opcodes, CB opcodes never have one
+    [[nodiscard]] unsigned int GetOperandSize(const byte opcode)
+    {
+        switch (opcode)
+        {
+        case 0x01: case 0x08: case 0x11: case 0x21: case 0x31: case 0xC2: case 0xC3: case 0xC4: case 0xCA: case 0xCC:
+        case 0xCD: case 0xD2: case 0xD4: case 0xDA: case 0xDC: case 0xEA: case 0xFA:
+            return 2;
+        case 0x06: case 0x0E: case 0x16: case 0x18: case 0x1E: case 0x20: case 0x26: case 0x28: case 0x2E: case 0x30:
+        case 0x36: case 0x38: case 0x3E: case 0xC6: case 0xCE: case 0xD6: case 0xDE: case 0xE0: case 0xE6: case 0xE8:
+        case 0xEE: case 0xF0: case 0xF6: case 0xF8: case 0xFE:
+            return 1;
+        default:
+            return 0;
+        }
+    }
+
+    [[nodiscard]] bool IsJumpToNext(const byte opcode)
+    {
+        return opcode == 0xC2 || opcode == 0xC3 || opcode == 0xCA || opcode == 0xD2 || opcode == 0xDA ||
+            opcode == 0xC4 || opcode == 0xCC || opcode == 0xCD || opcode == 0xD4 || opcode == 0xDC;
+    }
+
+    [[nodiscard]] std::optional<OpcodeBenchmark> GetOpcodeBenchmark(const byte opcode)
+    {
+        switch (opcode)
+        {
+        // STOP and HALT never return to the loop, 0xCB is the prefix
+        case 0x10: case 0x76: case 0xCB:
+        // Illegal opcodes
+        case 0xD3: case 0xDB: case 0xDD: case 0xE3: case 0xE4: case 0xEB: case 0xEC: case 0xED: case 0xF4: case 0xFC: case 0xFD:
+        // LD B,B logs, formatting it would be measured instead of the instruction
+        case 0x40:
+            return std::nullopt;
+        default:
+            break;
+        }
+
+        OpcodeBenchmark benchmark{std::format("Cpu/Opcode/{:02X}", opcode)};
+
+        // RET NZ and RET NC are kept from returning, as the other conditional returns are by OR A
+        if (opcode == 0xC0)
+            benchmark.flagsSetup = 0xAF; // XOR A
+        else if (opcode == 0xD0)
+            benchmark.flagsSetup = 0x37; // SCF
+        else if (opcode == Ret || opcode == 0xD9)
+            benchmark.pairing = Pairing::CalledStub;
+        else if ((opcode & 0xC7) == 0xC7)
+            benchmark.pairing = Pairing::RstVector;
+        else if (opcode == 0xE9)
+            benchmark.pairing = Pairing::LoadHl;
+
+        return benchmark;
+    }
+
+    [[nodiscard]] std::vector<byte> BuildOpcodeRom(const bool isCbOpcode, const byte opcode, const OpcodeBenchmark& benchmark)
+    {
+        RomBuilder builder("OPCODE");
+
+        // Every RST vector returns right away
+        for (unsigned int vector = 0; vector <= 0x38; vector += 8)
+        {
+            builder.SetOffset(vector);
+            builder.Emit(Ret);
+        }
+
+        // Stub called by the returns, past the interrupt vectors
+        constexpr word stubAddress = 0x0068;
+        builder.SetOffset(stubAddress);
+        builder.Emit(opcode);
+
+        builder.SetOffset(RomBuilder::EntryPoint);
+        builder.Emit(0xF3); // DI
+
+        const word loopAddress = builder.GetAddress();
+        builder.Emit(0x31); // LD SP,d16
+        builder.EmitWord(StackAddress);
+        builder.Emit({0x01, DataAddress & 0xFF, DataAddress >> 8}); // LD BC,d16
+        builder.Emit({0x11, DataAddress & 0xFF, DataAddress >> 8}); // LD DE,d16
+        builder.Emit({0x3E, 0x01}); // LD A,1
+        builder.Emit(benchmark.flagsSetup);
+        builder.Emit({0x21, DataAddress & 0xFF, DataAddress >> 8}); // LD HL,d16
+
+        for (unsigned int i = 0; i < InstructionCopies; i++)
+        {
+            if (isCbOpcode)
+            {
+                builder.Emit({0xCB, opcode});
+                continue;
+            }
+
+            switch (benchmark.pairing)
+            {
+            case Pairing::CalledStub:
+                builder.Emit(Call);
+                builder.EmitWord(stubAddress);
+                continue;
+            case Pairing::LoadHl:
+                builder.Emit(0x21); // LD HL,d16
+                builder.EmitWord(static_cast<word>(builder.GetAddress() + 3));
+                break;
+            case Pairing::RstVector:
+            case Pairing::None:
+                break;
+            }
+
+            builder.Emit(opcode);
+
+            // Jumps and calls go to the next instruction, relative jumps by 0, and memory operands point to work RAM
+            // or HRAM
+            const unsigned int operandSize = GetOperandSize(opcode);
+            if (IsJumpToNext(opcode))
+                builder.EmitWord(static_cast<word>(builder.GetAddress() + 2));
+            else if (operandSize == 2)
+                builder.EmitWord(DataAddress);
+            else if (opcode == 0x18 || (opcode & 0xE7) == 0x20)
+                builder.Emit(0x00);
+            else if (opcode == 0xE0 || opcode == 0xF0)
+                builder.Emit(HRamOffset);
+            else if (operandSize == 1)
+                builder.Emit(0x01);
+        }
+
+        builder.Emit(0xC3); // JP a16
+        builder.EmitWord(loopAddress);
+
+        return builder.Build();
+    }
+
+    void RegisterOpcode(BenchmarkRunner& runner, const bool isCbOpcode, const byte opcode)
+    {
+        OpcodeBenchmark benchmark;
+        if (isCbOpcode)
+            benchmark.name = std::format("Cpu/OpcodeCb/{:02X}", opcode);
+        else if (const std::optional<OpcodeBenchmark> baseBenchmark = GetOpcodeBenchmark(opcode))
+            benchmark = *baseBenchmark;
+        else
+            return;
+
+        runner.Register(benchmark.name, [isCbOpcode, opcode, benchmark](BenchmarkState& state)
+        {
+            Device device(RomBuilder::CreateBootRom(), BuildOpcodeRom(isCbOpcode, opcode, benchmark), 64);
+            device.SetHeadless(true);
+
+            for (unsigned int i = 0; i < WarmupSteps; i++)
+                device.Step();
+
+            unsigned long long cycles = 0;
+            while (state.KeepRunning())
+                cycles += device.Step();
+
+            state.SetItemsProcessed(state.GetIterations());
+            state.SetLabel(std::format("{:.1f} cycles", static_cast<double>(cycles) / static_cast<double>(state.GetIterations())));
+        });
+    }
+}
+
+void Benchmarks::RegisterCpuBenchmarks(BenchmarkRunner& runner)
+{
+    for (unsigned int opcode = 0; opcode <= 0xFF; opcode++)
+        RegisterOpcode(runner, false, static_cast<byte>(opcode));
+
+    for (unsigned int opcode = 0; opcode <= 0xFF; opcode++)
+        RegisterOpcode(runner, true, static_cast<byte>(opcode));
+}
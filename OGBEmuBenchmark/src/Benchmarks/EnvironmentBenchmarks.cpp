@@ -0,0 +1,75 @@
+#include "Benchmarks.h"
+
+#include <memory>
+
+#include "Benchmark/BenchmarkRunner.h"
+#include "Emulator/Device.h"
+#include "Emulator/ScreenSampler.h"
+#include "Emulator/Environment/Environment.h"
+#include "Workloads/Workloads.h"
+
+namespace
+{
+    constexpr int FramesPerSecond = 64;
+    constexpr unsigned int ScreenScale = 2;
+    // Several environments take turns on the thread, as a training loop batching them would
+    constexpr unsigned int EnvironmentCount = 16;
+    constexpr unsigned int FramesPerStep = 4;
+    constexpr unsigned int StepsPerEpisode = 64;
+    constexpr unsigned int SnapshotFrames = 16;
+
+    // Work RAM bytes, where a game would keep its score and lives
+    const std::vector<word> WatchedAddresses = {0xC000, 0xC001, 0xC002, 0xC003};
+}
+
+void Benchmarks::RegisterEnvironmentBenchmarks(BenchmarkRunner& runner)
+{
+    const auto rom = std::make_shared<const std::vector<byte>>(Workloads::Build(Workload::Poll));
+
+    runner.Register("Environment/Step", [rom](BenchmarkState& state)
+    {
+        Device snapshot(std::vector<byte>(), rom, FramesPerSecond);
+        snapshot.SetHeadless(true);
+        for (unsigned int frame = 0; frame < SnapshotFrames; frame++)
+            snapshot.RunFrame();
+
+        std::vector<std::unique_ptr<Environment>> environments;
+        for (unsigned int i = 0; i < EnvironmentCount; i++)
+            environments.push_back(std::make_unique<Environment>(rom, WatchedAddresses, ScreenScale, FramesPerSecond));
+
+        unsigned int step = 0;
+        while (state.KeepRunning())
+        {
+            if (step % StepsPerEpisode == 0)
+            {
+                for (const std::unique_ptr<Environment>& environment : environments)
+                    environment->Reset(snapshot);
+            }
+
+            for (unsigned int i = 0; i < EnvironmentCount; i++)
+            {
+                DoNotOptimize(environments[i]->Step(static_cast<byte>(step * 7 + i), FramesPerStep)[0]);
+                DoNotOptimize(environments[i]->GetScreen()[0]);
+            }
+            step++;
+        }
+
+        state.SetItemsProcessed(state.GetIterations() * EnvironmentCount);
+    });
+
+    // The observation part of a step alone
+    runner.Register("Environment/SampleScreen", [rom](BenchmarkState& state)
+    {
+        Device device(std::vector<byte>(), rom, FramesPerSecond);
+        device.SetHeadless(true);
+        ScreenSampler screenSampler(ScreenScale);
+
+        while (state.KeepRunning())
+        {
+            device.SampleScreen(screenSampler);
+            DoNotOptimize(screenSampler.GetPixels()[0]);
+        }
+
+        state.SetItemsProcessed(state.GetIterations());
+    });
+}
@@ -0,0 +1,68 @@
+#include "Benchmarks.h"
+
+#include <algorithm>
+#include <filesystem>
+
+#include "Benchmark/BenchmarkRunner.h"
+#include "Core/Logger.h"
+#include "Core/Utils.h"
+#include "Emulator/Device.h"
+#include "Workloads/RomBuilder.h"
+#include "Workloads/Workloads.h"
+
+namespace
+{
+    constexpr int FramesPerSecond = 64;
+
+    void RegisterFrames(BenchmarkRunner& runner, const std::string& name, const std::vector<byte>& rom)
+    {
+        runner.Register(name, [rom](BenchmarkState& state)
+        {
+            Device device(RomBuilder::CreateBootRom(), rom, FramesPerSecond);
+            if (!device.IsValid())
+            {
+                state.SkipWithError("Invalid cartridge");
+                return;
+            }
+
+            device.SetHeadless(true);
+
+            unsigned long long cycles = 0;
+            while (state.KeepRunning())
+                cycles += device.RunFrame();
+
+            // Emulated cycles, against the 4194304 per second of the hardware
+            state.SetItemsProcessed(cycles);
+        });
+    }
+}
+
+void Benchmarks::RegisterFrameBenchmarks(BenchmarkRunner& runner, const std::string& romDirectory)
+{
+    for (byte i = 0; i < static_cast<byte>(Workload::Count); i++)
+    {
+        const Workload workload = static_cast<Workload>(i);
+        RegisterFrames(runner, std::string("Frame/") + Workloads::GetName(workload), Workloads::Build(workload));
+    }
+
+    if (romDirectory.empty())
+        return;
+
+    std::error_code error;
+    std::vector<std::filesystem::path> romPaths;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(romDirectory, error))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == ".gb")
+            romPaths.push_back(entry.path());
+    }
+
+    if (error)
+    {
+        LOG("Couldn't list rom directory " << romDirectory << ": " << error.message());
+        return;
+    }
+
+    std::ranges::sort(romPaths);
+    for (const std::filesystem::path& romPath : romPaths)
+        RegisterFrames(runner, "Frame/Rom/" + romPath.filename().string(), Utils::ReadBinaryFile(romPath.string()));
+}
@@ -0,0 +1,51 @@
+#include "Benchmarks.h"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark/BenchmarkRunner.h"
+#include "Emulator/Fuzzing/FuzzHarness.h"
+#include "Workloads/Workloads.h"
+
+namespace
+{
+    constexpr int FramesPerSecond = 64;
+    constexpr unsigned int FramesPerInput = 4;
+    constexpr unsigned int MaxFrames = 600;
+    constexpr unsigned int InputSize = 16;
+    // Inputs are generated up front so the benchmark doesn't time a mutator
+    constexpr unsigned int InputCount = 64;
+}
+
+void Benchmarks::RegisterFuzzBenchmarks(BenchmarkRunner& runner)
+{
+    for (const Workload workload : {Workload::Poll, Workload::Halt, Workload::BankSwitch})
+    {
+        const auto rom = std::make_shared<const std::vector<byte>>(Workloads::Build(workload));
+
+        runner.Register(std::string("Fuzz/Run/") + Workloads::GetName(workload), [rom](BenchmarkState& state)
+        {
+            FuzzHarness harness(rom, FramesPerInput, MaxFrames, 0, FramesPerSecond);
+
+            std::mt19937 random(0);
+            std::vector<std::vector<byte>> inputs(InputCount, std::vector<byte>(InputSize));
+            for (std::vector<byte>& input : inputs)
+            {
+                for (byte& buttons : input)
+                    buttons = static_cast<byte>(random());
+            }
+
+            unsigned int run = 0;
+            while (state.KeepRunning())
+            {
+                const std::vector<byte>& input = inputs[run++ % InputCount];
+                DoNotOptimize(harness.Run(input.data(), input.size()).type);
+                DoNotOptimize(harness.GetCoverage().CountCovered());
+            }
+
+            state.SetItemsProcessed(state.GetIterations());
+        });
+    }
+}
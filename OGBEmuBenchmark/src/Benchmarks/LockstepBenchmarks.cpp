@@ -0,0 +1,91 @@
+#include "Benchmarks.h"
+
+#include <memory>
+
+#include "Benchmark/BenchmarkRunner.h"
+#include "Emulator/Device.h"
+#include "Emulator/Lockstep/LockstepRunner.h"
+#include "Workloads/Workloads.h"
+
+namespace
+{
+    constexpr int FramesPerSecond = 64;
+    constexpr unsigned int LaneCount = 64;
+    // Each iteration is an episode from boot where the lanes press the same buttons for the first half, like the
+    // branches of a search sharing their start, then each their own
+    constexpr unsigned int EpisodeFrames = 32;
+    constexpr unsigned int SharedFrames = EpisodeFrames / 2;
+
+    [[nodiscard]] byte GetButtons(const unsigned int lane, const unsigned int frame)
+    {
+        return frame < SharedFrames ? 0 : static_cast<byte>(lane);
+    }
+
+    void RegisterRunner(BenchmarkRunner& runner, const std::string& name, const std::vector<byte>& rom, const unsigned int threadCount)
+    {
+        runner.Register(name, [rom, threadCount](BenchmarkState& state)
+        {
+            while (state.KeepRunning())
+            {
+                LockstepRunner lockstepRunner(rom, LaneCount, FramesPerSecond, threadCount);
+                for (unsigned int frame = 0; frame < EpisodeFrames; frame++)
+                {
+                    for (unsigned int lane = 0; lane < LaneCount; lane++)
+                        lockstepRunner.SetButtons(lane, GetButtons(lane, frame));
+                    lockstepRunner.RunFrame();
+                }
+            }
+
+            state.SetItemsProcessed(state.GetIterations() * LaneCount * EpisodeFrames);
+        });
+    }
+}
+
+void Benchmarks::RegisterLockstepBenchmarks(BenchmarkRunner& runner)
+{
+    const std::vector<byte> rom = Workloads::Build(Workload::Poll);
+
+    // The same episodes on a device per lane, what the runner is measured against
+    runner.Register("Lockstep/Independent", [rom](BenchmarkState& state)
+    {
+        while (state.KeepRunning())
+        {
+            std::vector<std::unique_ptr<Device>> devices;
+            for (unsigned int lane = 0; lane < LaneCount; lane++)
+            {
+                devices.push_back(std::make_unique<Device>(std::vector<byte>(), rom, FramesPerSecond));
+                devices.back()->SetHeadless(true);
+            }
+
+            for (unsigned int frame = 0; frame < EpisodeFrames; frame++)
+            {
+                for (unsigned int lane = 0; lane < LaneCount; lane++)
+                {
+                    devices[lane]->SetButtons(GetButtons(lane, frame));
+                    devices[lane]->RunFrame();
+                }
+            }
+        }
+
+        state.SetItemsProcessed(state.GetIterations() * LaneCount * EpisodeFrames);
+    });
+
+    RegisterRunner(runner, "Lockstep/Runner", rom, 1);
+    RegisterRunner(runner, "Lockstep/Runner/Threads", rom, 0);
+
+    // Branching off a device a few frames in, the memory is shared so this doesn't depend on its size
+    runner.Register("Lockstep/Fork", [rom](BenchmarkState& state)
+    {
+        Device device(std::vector<byte>(), rom, FramesPerSecond);
+        device.SetHeadless(true);
+        for (unsigned int frame = 0; frame < SharedFrames; frame++)
+            device.RunFrame();
+
+        while (state.KeepRunning())
+        {
+            const std::unique_ptr<Device> fork = device.Fork();
+        }
+
+        state.SetItemsProcessed(state.GetIterations());
+    });
+}
@@ -0,0 +1,65 @@
+#include "Benchmarks.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Benchmark/BenchmarkRunner.h"
+#include "Emulator/Device.h"
+#include "Emulator/ScreenSampler.h"
+#include "Workloads/Workloads.h"
+
+namespace
+{
+    constexpr int FramesPerSecond = 64;
+    constexpr unsigned int ScreenScale = 2;
+    // Past the boot, with the workload's memory written to
+    constexpr unsigned int WarmUpFrames = 16;
+}
+
+void Benchmarks::RegisterRunAheadBenchmarks(BenchmarkRunner& runner)
+{
+    for (const Workload workload : {Workload::Poll, Workload::Halt, Workload::BankSwitch})
+    {
+        const auto rom = std::make_shared<const std::vector<byte>>(Workloads::Build(workload));
+        const std::string name = Workloads::GetName(workload);
+
+        // Saving and restoring a state, as running ahead pays once per frame
+        runner.Register("RunAhead/CopyState/" + name, [rom](BenchmarkState& state)
+        {
+            Device device(std::vector<byte>(), rom, FramesPerSecond);
+            device.SetHeadless(true);
+            for (unsigned int frame = 0; frame < WarmUpFrames; frame++)
+                device.RunFrame();
+
+            const std::unique_ptr<Device> saved = device.Fork();
+            saved->RunFrame();
+
+            while (state.KeepRunning())
+                saved->CopyStateFrom(device);
+
+            state.SetItemsProcessed(state.GetIterations());
+        });
+
+        // Frames shown a few frames ahead, sampling the screen after each like a front end would
+        for (const unsigned int runAheadFrames : {0u, 1u, 3u})
+        {
+            runner.Register("RunAhead/Frame/" + name + "/" + std::to_string(runAheadFrames), [rom, runAheadFrames](BenchmarkState& state)
+            {
+                Device device(std::vector<byte>(), rom, FramesPerSecond);
+                device.SetHeadless(true);
+                device.SetRunAheadFrames(runAheadFrames);
+                ScreenSampler screenSampler(ScreenScale);
+
+                while (state.KeepRunning())
+                {
+                    device.RunFrame();
+                    device.SampleScreen(screenSampler);
+                    DoNotOptimize(screenSampler.GetPixels()[0]);
+                }
+
+                state.SetItemsProcessed(state.GetIterations());
+            });
+        }
+    }
+}
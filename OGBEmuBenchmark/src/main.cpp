@@ -0,0 +1,90 @@
+#include <string>
+#include <vector>
+
+#include "Core/Logger.h"
+
+#include "Benchmark/BenchmarkReport.h"
+#include "Benchmark/BenchmarkRunner.h"
+#include "Benchmarks/Benchmarks.h"
+
+namespace
+{
+    constexpr double DefaultMaxRegressionPercent = 10.;
+
+    struct Options
+    {
+        std::string filter;
+        double minTimeSeconds = 0.5;
+        std::string romDirectory;
+        std::string jsonPath;
+        std::string baselinePath;
+        double maxRegressionPercent = DefaultMaxRegressionPercent;
+    };
+}
+
+bool ParseArguments(const int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (argument == "--filter" && hasValue)
+            options.filter = argv[++i];
+        else if (argument == "--min-time" && hasValue)
+            options.minTimeSeconds = std::stod(argv[++i]);
+        else if (argument == "--rom-dir" && hasValue)
+            options.romDirectory = argv[++i];
+        else if (argument == "--json" && hasValue)
+            options.jsonPath = argv[++i];
+        else if (argument == "--baseline" && hasValue)
+            options.baselinePath = argv[++i];
+        else if (argument == "--max-regression" && hasValue)
+            options.maxRegressionPercent = std::stod(argv[++i]);
+        else
+            return false;
+    }
+
+    return true;
+}
+
+// Returns 1 when a benchmark regressed past the allowed percentage of its baseline, so CI can fail on it
+int main(const int argc, char* argv[])
+{
+    Options options;
+
+    if (!ParseArguments(argc, argv, options))
+    {
+        DEBUGBREAKLOG("Wrong program arguments, usage: OGBEmuBenchmark [--filter text] [--min-time seconds] [--rom-dir directory] "
+            "[--json output.json] [--baseline baseline.json] [--max-regression percent]");
+        return 2;
+    }
+
+    BenchmarkRunner runner;
+    runner.SetFilter(options.filter);
+    runner.SetMinTime(options.minTimeSeconds);
+
+    Benchmarks::RegisterCpuBenchmarks(runner);
+    Benchmarks::RegisterBusBenchmarks(runner);
+    Benchmarks::RegisterCartridgeBenchmarks(runner);
+    Benchmarks::RegisterFrameBenchmarks(runner, options.romDirectory);
+    Benchmarks::RegisterAnalysisBenchmarks(runner);
+    Benchmarks::RegisterLockstepBenchmarks(runner);
+    Benchmarks::RegisterEnvironmentBenchmarks(runner);
+    Benchmarks::RegisterFuzzBenchmarks(runner);
+    Benchmarks::RegisterRunAheadBenchmarks(runner);
+
+    const std::vector<BenchmarkResult> results = runner.Run();
+
+    if (!options.jsonPath.empty() && !BenchmarkReport::WriteJson(options.jsonPath, results))
+        return 2;
+
+    if (options.baselinePath.empty())
+        return 0;
+
+    std::vector<BenchmarkResult> baseline;
+    if (!BenchmarkReport::ReadJson(options.baselinePath, baseline))
+        return 2;
+
+    return BenchmarkReport::CompareToBaseline(results, baseline, options.maxRegressionPercent) ? 0 : 1;
+}
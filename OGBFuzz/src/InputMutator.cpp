@@ -0,0 +1,89 @@
+#include "InputMutator.h"
+
+#include <algorithm>
+
+namespace
+{
+    constexpr unsigned int MaxEditsPerMutation = 4;
+    // Longest run of steps erased or repeated at once
+    constexpr size_t MaxRangeSize = 8;
+
+    enum class Edit
+    {
+        Append,
+        Insert,
+        Replace,
+        ToggleButton,
+        Erase,
+        Repeat,
+        Count
+    };
+}
+
+InputMutator::InputMutator(const unsigned int seed) : _random(seed)
+{
+}
+
+size_t InputMutator::Pick(const size_t count)
+{
+    return std::uniform_int_distribution<size_t>(0, count - 1)(_random);
+}
+
+void InputMutator::Mutate(std::vector<byte>& input, const size_t maxSize)
+{
+    const unsigned int editCount = 1 + static_cast<unsigned int>(Pick(MaxEditsPerMutation));
+    for (unsigned int i = 0; i < editCount; i++)
+        MutateOnce(input, maxSize);
+}
+
+void InputMutator::MutateOnce(std::vector<byte>& input, const size_t maxSize)
+{
+    if (maxSize == 0)
+        return;
+
+    auto edit = static_cast<Edit>(Pick(static_cast<size_t>(Edit::Count)));
+    // Every edit but appending needs a step to work on
+    if (input.empty())
+        edit = Edit::Append;
+    if (input.size() >= maxSize && (edit == Edit::Append || edit == Edit::Insert || edit == Edit::Repeat))
+        edit = Edit::Replace;
+
+    switch (edit)
+    {
+    case Edit::Append:
+        input.push_back(RandomButtons());
+        break;
+    case Edit::Insert:
+        input.insert(input.begin() + static_cast<std::ptrdiff_t>(Pick(input.size() + 1)), RandomButtons());
+        break;
+    case Edit::Replace:
+        input[Pick(input.size())] = RandomButtons();
+        break;
+    case Edit::ToggleButton:
+        input[Pick(input.size())] ^= static_cast<byte>(1 << Pick(8));
+        break;
+    case Edit::Erase:
+    {
+        const size_t start = Pick(input.size());
+        const size_t size = 1 + Pick(std::min(MaxRangeSize, input.size() - start));
+        input.erase(input.begin() + static_cast<std::ptrdiff_t>(start), input.begin() + static_cast<std::ptrdiff_t>(start + size));
+        break;
+    }
+    case Edit::Repeat:
+    {
+        // Holding the same buttons for longer
+        const size_t position = Pick(input.size());
+        const size_t count = 1 + Pick(std::min(MaxRangeSize, maxSize - input.size()));
+        const byte buttons = input[position];
+        input.insert(input.begin() + static_cast<std::ptrdiff_t>(position), count, buttons);
+        break;
+    }
+    case Edit::Count:
+        break;
+    }
+}
+
+byte InputMutator::RandomButtons()
+{
+    return static_cast<byte>(Pick(0x100));
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <random>
+#include <vector>
+
+#include "Core/Definitions.h"
+
+// Random edits of joypad inputs, one byte of buttons per step, for fuzzing without libFuzzer. A few edits are stacked
+// on each mutation, the input never grows past the maximum size.
+class InputMutator
+{
+public:
+    explicit InputMutator(unsigned int seed);
+
+    [[nodiscard]] size_t Pick(size_t count);
+    void Mutate(std::vector<byte>& input, size_t maxSize);
+
+private:
+    void MutateOnce(std::vector<byte>& input, size_t maxSize);
+    [[nodiscard]] byte RandomButtons();
+
+    std::mt19937 _random;
+};
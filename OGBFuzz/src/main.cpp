@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Core/Logger.h"
+#include "Core/Utils.h"
+
+#include "Emulator/Fault.h"
+#include "Emulator/Fuzzing/CoverageMap.h"
+#include "Emulator/Fuzzing/FuzzHarness.h"
+
+#ifndef OGB_LIBFUZZER
+#include "InputMutator.h"
+#endif
+
+// Built with -fsanitize=fuzzer and OGB_LIBFUZZER defined, libFuzzer drives LLVMFuzzerTestOneInput and saves the inputs
+// that abort. Otherwise main runs a simpler coverage guided loop of its own. Options use the --name=value form, which
+// libFuzzer leaves alone.
+namespace
+{
+    struct Options
+    {
+        std::string romPath;
+        unsigned int framesPerInput = 4;
+        unsigned int maxFrames = 600;
+        // Run once before the snapshot every input starts from, to skip an intro for instance
+        unsigned int warmUpFrames = 0;
+        int framesPerSecond = 64;
+
+        // Without libFuzzer only
+        std::string replayPath;
+        std::string crashDirectory = ".";
+        unsigned int seconds = 60;
+        unsigned int seed = 0;
+        size_t maxInputSize = 256;
+    };
+
+    std::unique_ptr<FuzzHarness> fuzzHarness;
+
+#if defined(OGB_LIBFUZZER) && defined(__linux__)
+    // libFuzzer reads these after each input as extra coverage, one counter per bucket of emulated addresses
+    constexpr size_t ExtraCounterCount = 1 << 16;
+    __attribute__((section("__libfuzzer_extra_counters"))) uint8_t extraCounters[ExtraCounterCount];
+#endif
+
+    [[nodiscard]] std::string FormatFault(const Fault& fault, const unsigned int frame)
+    {
+        switch (fault.type)
+        {
+        case FaultType::InvalidOpcode:
+            return std::format("Invalid opcode {:02X} at {:04X} in frame {}", fault.value, fault.address, frame);
+        case FaultType::UnmappedWrite:
+            return std::format("Write of {:02X} to unmapped {:04X} in frame {}", fault.value, fault.address, frame);
+        case FaultType::NotUsedWrite:
+            return std::format("Write of {:02X} to unused {:04X} in frame {}", fault.value, fault.address, frame);
+        case FaultType::None:
+            break;
+        }
+
+        return "No fault";
+    }
+
+    bool CreateHarness(const Options& options)
+    {
+        std::vector<byte> rom = Utils::ReadBinaryFile(options.romPath);
+        if (rom.empty())
+            return false;
+
+        fuzzHarness = std::make_unique<FuzzHarness>(std::make_shared<const std::vector<byte>>(std::move(rom)), options.framesPerInput,
+                                                    options.maxFrames, options.warmUpFrames, options.framesPerSecond);
+        return fuzzHarness->IsValid();
+    }
+
+    // The emulator logs every fault and much more, none of which helps at thousands of runs per second
+    Fault RunInput(const byte* input, const size_t size)
+    {
+        Logger::SetMuted(true);
+        const Fault fault = fuzzHarness->Run(input, size);
+        Logger::SetMuted(false);
+        return fault;
+    }
+}
+
+bool ParseArguments(const int argc, char* argv[], Options& options, const bool ignoresUnknown)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument(argv[i]);
+        const size_t separator = argument.find('=');
+        const std::string name = argument.substr(0, separator);
+        const std::string value = separator == std::string::npos ? std::string() : argument.substr(separator + 1);
+        const bool hasValue = !value.empty();
+
+        if (name == "--rom" && hasValue)
+            options.romPath = value;
+        else if (name == "--frames-per-input" && hasValue)
+            options.framesPerInput = static_cast<unsigned int>(std::stoul(value));
+        else if (name == "--max-frames" && hasValue)
+            options.maxFrames = static_cast<unsigned int>(std::stoul(value));
+        else if (name == "--warm-up" && hasValue)
+            options.warmUpFrames = static_cast<unsigned int>(std::stoul(value));
+        else if (name == "--fps" && hasValue)
+            options.framesPerSecond = std::stoi(value);
+        else if (name == "--replay" && hasValue)
+            options.replayPath = value;
+        else if (name == "--crash-dir" && hasValue)
+            options.crashDirectory = value;
+        else if (name == "--seconds" && hasValue)
+            options.seconds = static_cast<unsigned int>(std::stoul(value));
+        else if (name == "--seed" && hasValue)
+            options.seed = static_cast<unsigned int>(std::stoul(value));
+        else if (name == "--max-input" && hasValue)
+            options.maxInputSize = std::stoul(value);
+        // libFuzzer's own flags and corpus directories
+        else if (!ignoresUnknown)
+            return false;
+    }
+
+    return !options.romPath.empty();
+}
+
+extern "C" int LLVMFuzzerInitialize(int* argc, char*** argv)
+{
+    Options options;
+    if (!ParseArguments(*argc, *argv, options, true))
+    {
+        DEBUGBREAKLOG("Wrong program arguments, usage: OGBFuzz --rom=romPath.gb [--frames-per-input=n] [--max-frames=n] [--warm-up=frames] "
+            "[--fps=n] [libFuzzer flags] [corpus directories]");
+        std::exit(1);
+    }
+
+    if (!CreateHarness(options))
+        std::exit(1);
+
+    return 0;
+}
+
+// Each byte of the data is the buttons held for the next frames. A fault aborts so libFuzzer keeps the input.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, const size_t size)
+{
+    const Fault fault = RunInput(data, size);
+
+#if defined(OGB_LIBFUZZER) && defined(__linux__)
+    fuzzHarness->GetCoverage().ForEachCovered([](const size_t bit)
+    {
+        extraCounters[bit % ExtraCounterCount] = 1;
+    });
+#endif
+
+    if (fault.IsSet())
+    {
+        LOG(FormatFault(fault, fuzzHarness->GetFramesRun()));
+        std::abort();
+    }
+
+    return 0;
+}
+
+#ifndef OGB_LIBFUZZER
+namespace
+{
+    int Replay(const Options& options)
+    {
+        const std::vector<byte> input = Utils::ReadBinaryFile(options.replayPath);
+        const Fault fault = RunInput(input.data(), input.size());
+        LOG(FormatFault(fault, fuzzHarness->GetFramesRun()) << ", " << fuzzHarness->GetCoverage().CountCovered() << " addresses run");
+        return fault.IsSet() ? 2 : 0;
+    }
+
+    void LogCoverage(const CoverageMap& coverage)
+    {
+        constexpr size_t romBankSize = 16 * 1024;
+        for (unsigned int bank = 0; bank < coverage.GetRomSize() / romBankSize; bank++)
+        {
+            if (const size_t covered = coverage.CountCoveredInBank(bank))
+                LOG(std::format("Bank {:>3}: {} addresses", bank, covered));
+        }
+        LOG(std::format("RAM:      {} addresses", coverage.CountCoveredInRam()));
+    }
+
+    int Fuzz(const Options& options)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        InputMutator mutator(options.seed);
+        CoverageMap totalCoverage(fuzzHarness->GetCoverage().GetRomSize());
+        std::vector<std::vector<byte>> corpus(1);
+        std::vector<Fault> faults;
+        unsigned long long runCount = 0;
+
+        std::error_code error;
+        std::filesystem::create_directories(options.crashDirectory, error);
+
+        const Clock::time_point startTime = Clock::now();
+        const Clock::time_point endTime = startTime + std::chrono::seconds(options.seconds);
+        Clock::time_point nextReportTime = startTime + std::chrono::seconds(1);
+
+        for (Clock::time_point now = startTime; now < endTime; now = Clock::now())
+        {
+            std::vector<byte> input = corpus[mutator.Pick(corpus.size())];
+            mutator.Mutate(input, options.maxInputSize);
+
+            const Fault fault = RunInput(input.data(), input.size());
+            runCount++;
+            const size_t newCoverage = totalCoverage.Merge(fuzzHarness->GetCoverage());
+
+            if (fault.IsSet())
+            {
+                // One input per kind of fault at each address is enough to reproduce it
+                const bool isKnown = std::ranges::any_of(faults, [&fault](const Fault& known)
+                {
+                    return known.type == fault.type && known.address == fault.address;
+                });
+                if (!isKnown)
+                {
+                    faults.push_back(fault);
+                    const std::filesystem::path crashPath = std::filesystem::path(options.crashDirectory) /
+                        std::format("crash-{}-{:04X}.bin", static_cast<int>(fault.type), fault.address);
+                    Utils::WriteBinaryFile(crashPath.string(), input);
+                    LOG(FormatFault(fault, fuzzHarness->GetFramesRun()) << ", input saved to " << crashPath.string());
+                }
+            }
+            else if (newCoverage)
+                corpus.push_back(std::move(input));
+
+            if (now >= nextReportTime)
+            {
+                const double seconds = std::chrono::duration<double>(now - startTime).count();
+                LOG(std::format("{} runs, {:.0f} per second, {} addresses covered, corpus {}, faults {}", runCount,
+                                static_cast<double>(runCount) / seconds, totalCoverage.CountCovered(), corpus.size(), faults.size()));
+                nextReportTime += std::chrono::seconds(1);
+            }
+        }
+
+        LogCoverage(totalCoverage);
+        return faults.empty() ? 0 : 2;
+    }
+}
+
+// Fuzzes the joypad input of a ROM for a while and saves an input for each fault found, for instance:
+// OGBFuzz --rom=game.gb --seconds=600 --crash-dir=crashes, then OGBFuzz --rom=game.gb --replay=crashes/crash-1-4A20.bin
+int main(const int argc, char* argv[])
+{
+    Options options;
+
+    if (!ParseArguments(argc, argv, options, false))
+    {
+        DEBUGBREAKLOG("Wrong program arguments, usage: OGBFuzz --rom=romPath.gb [--frames-per-input=n] [--max-frames=n] [--warm-up=frames] "
+            "[--fps=n] [--seconds=n] [--seed=n] [--max-input=steps] [--crash-dir=path] [--replay=inputPath]");
+        return 1;
+    }
+
+    if (!CreateHarness(options))
+        return 1;
+
+    if (!options.replayPath.empty())
+        return Replay(options);
+
+    return Fuzz(options);
+}
+#endif
@@ -0,0 +1,414 @@
+#include "CodeEmitter.h"
+
+#include <format>
+
+#include "Emulator/Disassembly/Disassembler.h"
+#include "Emulator/Recompiler/RecompiledCode.h"
+
+namespace
+{
+    constexpr unsigned int BankSize = 0x4000;
+
+    // Indexed like the opcodes encode them, 6 being (HL)
+    constexpr const char* Registers[] = {"s.b", "s.c", "s.d", "s.e", "s.h", "s.l", nullptr, "s.a"};
+    constexpr const char* PairHighs[] = {"s.b", "s.d", "s.h"};
+    constexpr const char* PairLows[] = {"s.c", "s.e", "s.l"};
+    // NZ, Z, NC and C
+    constexpr const char* Conditions[] = {"!(s.f & FlagZ)", "s.f & FlagZ", "!(s.f & FlagC)", "s.f & FlagC"};
+    constexpr const char* EndInstruction = "if (!context->endInstruction(context))\n                return;\n";
+
+    [[nodiscard]] bool IsTranslatedOpcode(const byte opcode, const byte prefixedOpcode)
+    {
+        if (Disassembler::GetOpcodeInfo(opcode).flow == Disassembler::Flow::Illegal)
+            return false;
+
+        switch (opcode)
+        {
+        case 0x08: case 0x09: case 0x10: case 0x19: case 0x27: case 0x29: case 0x39: case 0x40: case 0x76: case 0xD9: case 0xE8:
+        case 0xF3: case 0xF8: case 0xFB:
+            return false;
+        case 0xCB:
+            // SWAP sits between SRA and SRL
+            return prefixedOpcode < 0x20 || (prefixedOpcode >= 0x30 && prefixedOpcode < 0x38) || prefixedOpcode >= 0x40;
+        default:
+            return true;
+        }
+    }
+
+    [[nodiscard]] std::string GetPair(const unsigned int index)
+    {
+        return index == 3 ? "s.sp" : std::format("GetPair({}, {})", PairHighs[index], PairLows[index]);
+    }
+
+    [[nodiscard]] std::string SetPair(const unsigned int index, const std::string& value)
+    {
+        return index == 3 ? std::format("s.sp = {};", value) : std::format("SetPair({}, {}, {});", PairHighs[index], PairLows[index], value);
+    }
+
+    // Value of the operand in the low 3 bits, reading (HL) from the bus
+    [[nodiscard]] std::string GetOperand(const unsigned int index)
+    {
+        return index == 6 ? "context->read(context, GetPair(s.h, s.l))" : Registers[index];
+    }
+
+    [[nodiscard]] std::string EmitAlu(const unsigned int operation, const std::string& value)
+    {
+        switch (operation)
+        {
+        case 0: return std::format("Add(s, {}, 0);", value);
+        case 1: return std::format("Add(s, {}, GetCarry(s));", value);
+        case 2: return std::format("Sub(s, {}, 0);", value);
+        case 3: return std::format("Sub(s, {}, GetCarry(s));", value);
+        case 4: return std::format("And(s, {});", value);
+        case 5: return std::format("Xor(s, {});", value);
+        case 6: return std::format("Or(s, {});", value);
+        default: return std::format("(void)Compare(s, {}, 0);", value);
+        }
+    }
+
+    [[nodiscard]] std::string EmitPrefixed(const byte opcode)
+    {
+        const unsigned int index = opcode & 0x7;
+        const unsigned int bit = opcode >> 3 & 0x7;
+
+        if (opcode >= 0x40 && opcode < 0x80)
+            return std::format("Bit(s, {}, {});", bit, GetOperand(index));
+
+        std::string operation;
+        if (opcode < 0x40)
+        {
+            constexpr const char* rotates[] = {"Rlc", "Rrc", "Rl", "Rr", nullptr, nullptr, "Swap"};
+            operation = std::format("{}(s, value);", rotates[bit]);
+        }
+        else if (opcode < 0xC0)
+            operation = std::format("value &= {:#04x};", static_cast<byte>(~(1 << bit)));
+        else
+            operation = std::format("value |= {:#04x};", 1 << bit);
+
+        if (index == 6)
+        {
+            return std::format("{{\n            byte value = context->read(context, GetPair(s.h, s.l));\n            {}\n"
+                                    "            context->write(context, GetPair(s.h, s.l), value);\n        }}", operation);
+        }
+
+        std::string code = operation;
+        code.replace(code.find("value"), 5, Registers[index]);
+        return code;
+    }
+}
+
+CodeEmitter::CodeEmitter(const std::vector<byte>& rom, const ControlFlowGraph& graph) : _rom(rom), _instructions(graph.GetInstructionOffsets()),
+                                                                                         _instructionIndices(rom.size())
+{
+    for (unsigned int i = 0; i < _instructions.size(); i++)
+        _instructionIndices[_instructions[i]] = i + 1;
+}
+
+std::string CodeEmitter::Emit()
+{
+    BuildBlocks();
+
+    std::string output = std::format("// Generated by OGBRecompiler from a ROM with global checksum {:04X}, don't edit\n"
+                                     "#include \"Emulator/Recompiler/RecompiledCode.h\"\n\n"
+                                     "using namespace RecompiledCode;\n\n"
+                                     "namespace\n{{\n",
+                                     _rom[0x14E] << 8 | _rom[0x14F]);
+
+    for (unsigned int i = 0; i < _blocks.size(); i++)
+        EmitBlock(i, output);
+
+    if (_translatedCount == 0)
+        output += "    constexpr const Entry* Entries = nullptr;\n";
+    else
+    {
+        output += "    constexpr Entry Entries[] =\n    {\n";
+        for (unsigned int i = 0; i < _instructions.size(); i++)
+        {
+            if (_instructionBlocks[i] < 0)
+                continue;
+
+            const unsigned int first = _instructions[_blocks[_instructionBlocks[i]].instructions[0]];
+            output += std::format("        {{{:#x}, {:#06x}, {}, Block{:X}}},\n", _instructions[i], ControlFlowGraph::GetAddress(_instructions[i]),
+                                  _instructionPositions[i], first);
+        }
+        output += "    };\n";
+    }
+
+    output += std::format("\n    constexpr Module RecompiledModule = {{AbiVersion, {:#06x}, {:#x}, {}, Entries}};\n}}\n\n",
+                          _rom[0x14E] << 8 | _rom[0x14F], _rom.size(), _translatedCount);
+    output += std::format("#ifdef _WIN32\n#define OGB_EXPORT __declspec(dllexport)\n#else\n#define OGB_EXPORT __attribute__((visibility(\"default\")))\n#endif\n\n"
+                          "extern \"C\" OGB_EXPORT const Module* {}()\n{{\n    return &RecompiledModule;\n}}\n", RecompiledCode::ModuleSymbol);
+    return output;
+}
+
+void CodeEmitter::BuildBlocks()
+{
+    _blocks.clear();
+    _instructionBlocks.assign(_instructions.size(), -1);
+    _instructionPositions.assign(_instructions.size(), 0);
+    _translatedCount = 0;
+
+    for (unsigned int i = 0; i < _instructions.size(); i++)
+    {
+        if (_instructionBlocks[i] >= 0 || !IsTranslated(_instructions[i]))
+            continue;
+
+        const int blockIndex = static_cast<int>(_blocks.size());
+        Block& block = _blocks.emplace_back();
+
+        unsigned int instruction = i;
+        while (true)
+        {
+            _instructionBlocks[instruction] = blockIndex;
+            _instructionPositions[instruction] = static_cast<unsigned int>(block.instructions.size());
+            block.instructions.push_back(instruction);
+            _translatedCount++;
+
+            // Runs go on with the next instruction in the bank, when it was translated and isn't in another run
+            const unsigned int current = _instructions[instruction];
+            const unsigned int size = Disassembler::GetSize(_rom[current]);
+            const unsigned int nextOffset = current + size;
+            if (current % BankSize + size >= BankSize || _instructionIndices[nextOffset] == 0)
+                break;
+
+            const unsigned int next = _instructionIndices[nextOffset] - 1;
+            if (_instructionBlocks[next] >= 0 || !IsTranslated(nextOffset))
+                break;
+
+            instruction = next;
+        }
+
+        block.isBranchTarget.resize(block.instructions.size());
+    }
+
+    for (unsigned int i = 0; i < _blocks.size(); i++)
+    {
+        for (const unsigned int instruction : _blocks[i].instructions)
+        {
+            const unsigned int current = _instructions[instruction];
+            const Disassembler::Instruction decoded = Disassembler::Decode(&_rom[current], ControlFlowGraph::GetAddress(current));
+            if (!decoded.hasTarget)
+                continue;
+
+            if (const int target = FindInBlock(i, decoded.target); target >= 0)
+                _blocks[i].isBranchTarget[target] = true;
+        }
+    }
+}
+
+bool CodeEmitter::IsTranslated(const unsigned int romOffset) const
+{
+    return IsTranslatedOpcode(_rom[romOffset], romOffset + 1 < _rom.size() ? _rom[romOffset + 1] : 0);
+}
+
+int CodeEmitter::FindInBlock(const unsigned int blockIndex, const word address) const
+{
+    const unsigned int first = _instructions[_blocks[blockIndex].instructions[0]];
+    if (address > 0x7FFF || (address < BankSize) != (first < BankSize))
+        return -1;
+
+    const unsigned int romOffset = first - first % BankSize + address % BankSize;
+    if (_instructionIndices[romOffset] == 0)
+        return -1;
+
+    const unsigned int instruction = _instructionIndices[romOffset] - 1;
+    return _instructionBlocks[instruction] == static_cast<int>(blockIndex) ? static_cast<int>(_instructionPositions[instruction]) : -1;
+}
+
+void CodeEmitter::EmitBlock(const unsigned int blockIndex, std::string& output) const
+{
+    const Block& block = _blocks[blockIndex];
+    output += std::format("    void Block{:X}(Context* context, const unsigned int entry)\n    {{\n        State& s = context->state;\n\n"
+                          "        switch (entry)\n        {{\n", _instructions[block.instructions[0]]);
+
+    for (unsigned int position = 0; position < block.instructions.size(); position++)
+        EmitInstruction(blockIndex, position, output);
+
+    output += "        default:\n            return;\n        }\n    }\n\n";
+}
+
+void CodeEmitter::EmitInstruction(const unsigned int blockIndex, const unsigned int position, std::string& output) const
+{
+    const Block& block = _blocks[blockIndex];
+    const unsigned int romOffset = _instructions[block.instructions[position]];
+    const Disassembler::Instruction instruction = Disassembler::Decode(&_rom[romOffset], ControlFlowGraph::GetAddress(romOffset));
+    const byte opcode = instruction.GetOpcode();
+    const word nextAddress = static_cast<word>(instruction.address + instruction.info->size);
+    const byte immediate8 = instruction.GetImmediate8();
+    const word immediate16 = instruction.GetImmediate16();
+    const unsigned int high = opcode >> 4;
+    const unsigned int row = opcode >> 3 & 0x7;
+    const unsigned int column = opcode & 0x7;
+    // Added to the cycles when a conditional branch is taken
+    const unsigned int branchCycles = instruction.info->branchCycles - instruction.info->cycles;
+
+    std::string code;
+    // Whether the instruction can go on to the next one
+    bool fallsThrough = true;
+
+    if (opcode == 0x00)
+        code = "";
+    else if (opcode == 0x01 || opcode == 0x11 || opcode == 0x21 || opcode == 0x31)
+        code = SetPair(high, std::format("{:#06x}", immediate16));
+    else if ((opcode & 0xC7) == 0x02)
+    {
+        // (BC), (DE), (HL+) and (HL-)
+        std::string address;
+        if (high < 2)
+            address = GetPair(high);
+        else
+        {
+            address = "address";
+            code = std::format("const word address = GetPair(s.h, s.l);\n            SetPair(s.h, s.l, static_cast<word>(address {} 1));\n            ",
+                               high == 2 ? "+" : "-");
+        }
+
+        if (opcode & 0x08)
+            code += std::format("s.a = context->read(context, {});", address);
+        else
+            code += std::format("context->write(context, {}, s.a);", address);
+    }
+    else if ((opcode & 0xC7) == 0x03)
+        code = SetPair(high, std::format("static_cast<word>({} {} 1)", GetPair(high), opcode & 0x08 ? "-" : "+"));
+    else if ((opcode & 0xC6) == 0x04)
+    {
+        const char* operation = opcode & 0x01 ? "Dec" : "Inc";
+        if (row == 6)
+        {
+            code = std::format("byte value = context->read(context, GetPair(s.h, s.l));\n            {}(s, value);\n"
+                               "            context->write(context, GetPair(s.h, s.l), value);", operation);
+        }
+        else
+            code = std::format("{}(s, {});", operation, Registers[row]);
+    }
+    else if ((opcode & 0xC7) == 0x06)
+    {
+        code = row == 6 ? std::format("context->write(context, GetPair(s.h, s.l), {:#04x});", immediate8)
+                        : std::format("{} = {:#04x};", Registers[row], immediate8);
+    }
+    else if (opcode == 0x07 || opcode == 0x0F || opcode == 0x17 || opcode == 0x1F)
+    {
+        constexpr const char* rotates[] = {"Rlca", "Rrca", "Rla", "Rra"};
+        code = std::format("{}(s);", rotates[row]);
+    }
+    else if (opcode == 0x2F)
+        code = "s.a ^= 0xFF;\n            s.f |= FlagN | FlagH;";
+    else if (opcode == 0x37)
+        code = "s.f = (s.f & FlagZ) | FlagC;";
+    else if (opcode == 0x3F)
+        code = "s.f = (s.f & (FlagZ | FlagC)) ^ FlagC;";
+    else if (opcode == 0x18 || (opcode & 0xE7) == 0x20)
+    {
+        const std::string jump = std::format("RelativeJump(s, {});\n            {}", static_cast<int>(static_cast<signed_byte>(immediate8)),
+                                             EmitBranchEnd(blockIndex, instruction.target));
+        if (opcode == 0x18)
+        {
+            code = jump;
+            fallsThrough = false;
+        }
+        else
+            code = std::format("if ({})\n            {{\n                s.cycles += {};\n                {}\n            }}", Conditions[row - 4], branchCycles, jump);
+    }
+    else if (opcode >= 0x40 && opcode < 0x80)
+    {
+        code = row == 6 ? std::format("context->write(context, GetPair(s.h, s.l), {});", Registers[column])
+                        : std::format("{} = {};", Registers[row], GetOperand(column));
+    }
+    else if (opcode >= 0x80 && opcode < 0xC0)
+        code = EmitAlu(row, GetOperand(column));
+    else if ((opcode & 0xC7) == 0xC6)
+        code = EmitAlu(row, std::format("{:#04x}", immediate8));
+    else if (opcode == 0xC9 || (opcode & 0xE7) == 0xC0)
+    {
+        // RET doesn't count as a branch for idle loop detection, and where it lands is only known at run time
+        const std::string ret = "s.pc = Pop(context);\n            return;";
+        if (opcode == 0xC9)
+        {
+            code = ret;
+            fallsThrough = false;
+        }
+        else
+        {
+            code = std::format("if ({})\n            {{\n                s.cycles += {};\n                s.pc = Pop(context);\n                return;\n            }}",
+                               Conditions[row], branchCycles);
+        }
+    }
+    else if ((opcode & 0xCF) == 0xC1)
+    {
+        code = high == 0xF ? "const word value = Pop(context);\n            s.a = static_cast<byte>(value >> 8);\n            s.f = value & 0xF0;"
+                           : SetPair(high - 0xC, "Pop(context)");
+    }
+    else if ((opcode & 0xCF) == 0xC5)
+        code = std::format("Push(context, {});", high == 0xF ? "GetPair(s.a, s.f)" : GetPair(high - 0xC));
+    else if (opcode == 0xC3 || (opcode & 0xE7) == 0xC2)
+    {
+        const std::string jump = std::format("Jump(s, {:#06x});\n            {}", immediate16, EmitBranchEnd(blockIndex, immediate16));
+        if (opcode == 0xC3)
+        {
+            code = jump;
+            fallsThrough = false;
+        }
+        else
+            code = std::format("if ({})\n            {{\n                s.cycles += {};\n                {}\n            }}", Conditions[row], branchCycles, jump);
+    }
+    else if (opcode == 0xCD || (opcode & 0xE7) == 0xC4 || (opcode & 0xC7) == 0xC7)
+    {
+        const std::string call = std::format("Push(context, s.pc);\n            Jump(s, {:#06x});\n            {}", instruction.target,
+                                             EmitBranchEnd(blockIndex, instruction.target));
+        if ((opcode & 0xE7) == 0xC4)
+        {
+            code = std::format("if ({})\n            {{\n                s.cycles += {};\n                {}\n            }}", Conditions[row], branchCycles, call);
+        }
+        else
+        {
+            code = call;
+            fallsThrough = false;
+        }
+    }
+    else if (opcode == 0xCB)
+        code = EmitPrefixed(immediate8);
+    else if (opcode == 0xE0 || opcode == 0xF0)
+    {
+        code = opcode == 0xE0 ? std::format("context->write(context, {:#06x}, s.a);", 0xFF00 | immediate8)
+                              : std::format("s.a = context->read(context, {:#06x});", 0xFF00 | immediate8);
+    }
+    else if (opcode == 0xE2 || opcode == 0xF2)
+        code = opcode == 0xE2 ? "context->write(context, static_cast<word>(0xFF00 | s.c), s.a);" : "s.a = context->read(context, static_cast<word>(0xFF00 | s.c));";
+    else if (opcode == 0xEA || opcode == 0xFA)
+    {
+        code = opcode == 0xEA ? std::format("context->write(context, {:#06x}, s.a);", immediate16)
+                              : std::format("s.a = context->read(context, {:#06x});", immediate16);
+    }
+    else if (opcode == 0xE9)
+    {
+        code = "s.pc = GetPair(s.h, s.l);\n            return;";
+        fallsThrough = false;
+    }
+    else if (opcode == 0xF9)
+        code = "s.sp = GetPair(s.h, s.l);";
+
+    if (block.isBranchTarget[position])
+        output += std::format("        case {}:\n        Instruction{}:\n", position, position);
+    else
+        output += std::format("        case {}:\n", position);
+
+    output += std::format("        {{\n            // {:04X}\n            s.cycles = {};\n            s.pc = {:#06x};\n", instruction.address, instruction.info->cycles, nextAddress);
+    if (!code.empty())
+        output += std::format("            {}\n", code);
+
+    if (!fallsThrough)
+        output += "        }\n";
+    else if (position + 1 < block.instructions.size())
+        output += std::format("            {}        }}\n            [[fallthrough]];\n", EndInstruction);
+    else
+        output += "            return;\n        }\n";
+}
+
+std::string CodeEmitter::EmitBranchEnd(const unsigned int blockIndex, const word target) const
+{
+    const int position = FindInBlock(blockIndex, target);
+    if (position < 0)
+        return "return;";
+
+    return std::format("if (!context->endInstruction(context))\n                return;\n            goto Instruction{};", position);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Core/Definitions.h"
+
+#include "Emulator/Disassembly/ControlFlowGraph.h"
+
+// Translates the instructions of a control flow graph to C++ against Emulator/Recompiler/RecompiledCode.h. Runs of consecutive
+// instructions become block functions, every instruction in them an entry point. Instructions that need the rest of
+// the CPU (HALT, STOP, DI, EI, RETI, DAA) or that the interpreter handles differently from hardware (ADD HL, SLA,
+// SRA, SRL) are left to the interpreter, as is LD B,B which it stops on as a debug breakpoint.
+class CodeEmitter
+{
+public:
+    CodeEmitter(const std::vector<byte>& rom, const ControlFlowGraph& graph);
+
+    [[nodiscard]] std::string Emit();
+    [[nodiscard]] unsigned int GetTranslatedCount() const { return _translatedCount; }
+    [[nodiscard]] unsigned int GetBlockCount() const { return static_cast<unsigned int>(_blocks.size()); }
+
+private:
+    struct Block
+    {
+        // Indices into the instructions, in address order
+        std::vector<unsigned int> instructions;
+        // Whether a branch in the block lands on the instruction, which then needs a label
+        std::vector<bool> isBranchTarget;
+    };
+
+    void BuildBlocks();
+    [[nodiscard]] bool IsTranslated(unsigned int romOffset) const;
+    // Index in the block of the instruction a branch from it to address lands on, -1 when it leaves the block
+    [[nodiscard]] int FindInBlock(unsigned int blockIndex, word address) const;
+    void EmitBlock(unsigned int blockIndex, std::string& output) const;
+    void EmitInstruction(unsigned int blockIndex, unsigned int position, std::string& output) const;
+    // What runs once a branch was taken, going on in the block when it lands there
+    [[nodiscard]] std::string EmitBranchEnd(unsigned int blockIndex, word target) const;
+
+    const std::vector<byte>& _rom;
+    // ROM offsets of the instructions found
+    std::vector<unsigned int> _instructions;
+    // Index of the instruction + 1 by ROM offset, 0 where none starts
+    std::vector<unsigned int> _instructionIndices;
+    std::vector<Block> _blocks;
+    // Block and position in it by instruction
+    std::vector<int> _instructionBlocks;
+    std::vector<unsigned int> _instructionPositions;
+    unsigned int _translatedCount = 0;
+};
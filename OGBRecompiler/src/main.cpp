@@ -0,0 +1,87 @@
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "Core/Logger.h"
+#include "Core/Utils.h"
+
+#include "CodeEmitter.h"
+
+namespace
+{
+    struct Options
+    {
+        std::string romPath;
+        std::string outputPath;
+        // Compiles the output to a module when set, with the output and then "-o" and the library path appended
+        std::string compilerCommand;
+        std::string libraryPath;
+    };
+}
+
+bool ParseArguments(const int argc, char* argv[], Options& options)
+{
+    std::vector<std::string> positionalArguments;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (argument == "--compiler" && hasValue)
+            options.compilerCommand = argv[++i];
+        else if (argument == "--library" && hasValue)
+            options.libraryPath = argv[++i];
+        else if (argument.starts_with("--"))
+            return false;
+        else
+            positionalArguments.push_back(argument);
+    }
+
+    if (positionalArguments.size() != 2 || options.compilerCommand.empty() != options.libraryPath.empty())
+        return false;
+
+    options.romPath = positionalArguments[0];
+    options.outputPath = positionalArguments[1];
+    return true;
+}
+
+// Translates the code of a ROM to C++ the emulator loads with --recompiled once compiled as a shared library, for
+// instance: OGBRecompiler game.gb game.cpp --compiler "g++ -O2 -std=c++20 -shared -fPIC -I OGBEmu/src" --library game.so
+int main(const int argc, char* argv[])
+{
+    Options options;
+
+    if (!ParseArguments(argc, argv, options))
+    {
+        DEBUGBREAKLOG("Wrong program arguments, usage: OGBRecompiler [--compiler command --library output] romPath.gb output.cpp");
+        return 1;
+    }
+
+    const std::vector<byte> rom = Utils::ReadBinaryFile(options.romPath);
+    if (rom.empty())
+        return 1;
+
+    const ControlFlowGraph graph(rom);
+    CodeEmitter emitter(rom, graph);
+    const std::string source = emitter.Emit();
+
+    if (!Utils::WriteBinaryFile(options.outputPath, std::vector<byte>(source.begin(), source.end())))
+        return 1;
+
+    LOG("Found " << graph.GetInstructionCount() << " instructions, translated " << emitter.GetTranslatedCount() << " in " << emitter.GetBlockCount()
+        << " blocks to " << options.outputPath);
+
+    if (options.compilerCommand.empty())
+        return 0;
+
+    const std::string command = options.compilerCommand + " \"" + options.outputPath + "\" -o \"" + options.libraryPath + "\"";
+    LOG("Compiling: " << command);
+    if (std::system(command.c_str()) != 0)
+    {
+        LOG("Compilation failed");
+        return 1;
+    }
+
+    return 0;
+}
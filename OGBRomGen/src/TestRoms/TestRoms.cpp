@@ -0,0 +1,184 @@
+#include "TestRoms.h"
+
+#include <iterator>
+
+#include "Core/Logger.h"
+
+#include "Emulator/Memory/AddressConstants.h"
+
+#include "Workloads/RomBuilder.h"
+
+namespace
+{
+    // Past the code of every test
+    constexpr unsigned int ReportOffset = 0x1000;
+    constexpr unsigned int SubroutineOffset = 0x1100;
+
+    constexpr byte Di = 0xF3;
+    constexpr byte Jr = 0x18;
+    constexpr byte Jp = 0xC3;
+    constexpr byte Call = 0xCD;
+    constexpr byte Ret = 0xC9;
+    constexpr byte JrNz = 0x20;
+    constexpr byte JpNz = 0xC2;
+
+    struct Reporting
+    {
+        word passAddress = 0;
+        // Expects the failing case number in D
+        word failAddress = 0;
+    };
+
+    void EmitString(RomBuilder& builder, const char* text)
+    {
+        for (const char* character = text; *character != '\0'; character++)
+            builder.Emit(static_cast<byte>(*character));
+        builder.Emit(0x00);
+    }
+
+    // JP, CALL or one of their conditional forms
+    void EmitAbsolute(RomBuilder& builder, const byte opcode, const word address)
+    {
+        builder.Emit(opcode);
+        builder.EmitWord(address);
+    }
+
+    // Serial printing routines and the pass and fail endings, which print their result and loop forever
+    [[nodiscard]] Reporting EmitReporting(RomBuilder& builder)
+    {
+        builder.SetOffset(ReportOffset);
+
+        const word passedAddress = builder.GetAddress();
+        EmitString(builder, "Passed\n");
+        const word caseAddress = builder.GetAddress();
+        EmitString(builder, "Case ");
+        // Last, as a run stops as soon as the pattern is printed
+        const word failedAddress = builder.GetAddress();
+        EmitString(builder, "\nFailed\n");
+
+        // Sends A with the internal clock and waits for the transfer to end
+        const word printCharacterAddress = builder.GetAddress();
+        builder.Emit({0xE0, AddressConstants::SerialData & 0xFF, 0x3E, 0x81, 0xE0, AddressConstants::SerialControl & 0xFF}); // LDH (SB),A; LD A,81; LDH (SC),A
+        const word waitAddress = builder.GetAddress();
+        builder.Emit({0xF0, AddressConstants::SerialControl & 0xFF, 0xCB, 0x7F}); // LDH A,(SC); BIT 7,A
+        builder.EmitRelativeJump(JrNz, waitAddress);
+        builder.Emit(Ret);
+
+        // Sends the zero terminated string at HL
+        const word printAddress = builder.GetAddress();
+        builder.Emit({0x2A, 0xB7, 0xC8}); // LD A,(HL+); OR A; RET Z
+        EmitAbsolute(builder, Call, printCharacterAddress);
+        builder.EmitRelativeJump(Jr, printAddress);
+
+        Reporting reporting;
+
+        reporting.passAddress = builder.GetAddress();
+        builder.Emit({0x21, static_cast<byte>(passedAddress), static_cast<byte>(passedAddress >> 8)}); // LD HL,passed
+        EmitAbsolute(builder, Call, printAddress);
+        builder.Emit({Jr, 0xFE}); // JR to itself
+
+        reporting.failAddress = builder.GetAddress();
+        builder.Emit({0x21, static_cast<byte>(caseAddress), static_cast<byte>(caseAddress >> 8)}); // LD HL,case
+        EmitAbsolute(builder, Call, printAddress);
+        builder.Emit({0x7A, 0xC6, '0'}); // LD A,D; ADD '0'
+        EmitAbsolute(builder, Call, printCharacterAddress);
+        builder.Emit({0x21, static_cast<byte>(failedAddress), static_cast<byte>(failedAddress >> 8)}); // LD HL,failed
+        EmitAbsolute(builder, Call, printAddress);
+        builder.Emit({Jr, 0xFE}); // JR to itself
+
+        builder.SetOffset(RomBuilder::EntryPoint);
+        return reporting;
+    }
+
+    [[nodiscard]] std::vector<byte> BuildCallConditions()
+    {
+        struct Case
+        {
+            std::vector<byte> flagSetup;
+            byte callOpcode;
+            bool taken;
+        };
+
+        const std::vector<byte> clearZ = {0x3E, 0x01, 0xB7}; // LD A,1; OR A
+        const std::vector<byte> setZ = {0xAF}; // XOR A
+        const std::vector<byte> clearC = {0x37, 0x3F}; // SCF; CCF
+        const std::vector<byte> setC = {0x37}; // SCF
+        constexpr byte callNz = 0xC4;
+        constexpr byte callZ = 0xCC;
+        constexpr byte callNc = 0xD4;
+        constexpr byte callC = 0xDC;
+
+        const Case cases[] = {
+            {clearZ, callNz, true}, {setZ, callNz, false},
+            {setZ, callZ, true}, {clearZ, callZ, false},
+            {clearC, callNc, true}, {setC, callNc, false},
+            {setC, callC, true}, {clearC, callC, false},
+        };
+
+        RomBuilder builder("CALLCC");
+        const Reporting reporting = EmitReporting(builder);
+
+        // Counts the calls taken in B
+        builder.SetOffset(SubroutineOffset);
+        const word subroutineAddress = builder.GetAddress();
+        builder.Emit({0x04, Ret}); // INC B; RET
+
+        builder.SetOffset(RomBuilder::EntryPoint);
+        builder.Emit(Di);
+
+        for (byte i = 0; i < std::size(cases); i++)
+        {
+            builder.Emit({0x16, static_cast<byte>(i + 1), 0x06, 0x00}); // LD D,case; LD B,0
+            for (const byte data : cases[i].flagSetup)
+                builder.Emit(data);
+            EmitAbsolute(builder, cases[i].callOpcode, subroutineAddress);
+            builder.Emit({0x78, 0xFE, static_cast<byte>(cases[i].taken ? 1 : 0)}); // LD A,B; CP taken
+            EmitAbsolute(builder, JpNz, reporting.failAddress);
+        }
+
+        EmitAbsolute(builder, Jp, reporting.passAddress);
+
+        return builder.Build();
+    }
+}
+
+const char* TestRoms::GetName(const TestRom testRom)
+{
+    switch (testRom)
+    {
+    case TestRom::CallConditions:
+        return "CallConditions";
+    case TestRom::Count:
+        break;
+    }
+
+    return "";
+}
+
+bool TestRoms::FromName(const std::string& name, TestRom& testRom)
+{
+    for (byte i = 0; i < static_cast<byte>(TestRom::Count); i++)
+    {
+        if (name == GetName(static_cast<TestRom>(i)))
+        {
+            testRom = static_cast<TestRom>(i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::vector<byte> TestRoms::Build(const TestRom testRom)
+{
+    switch (testRom)
+    {
+    case TestRom::CallConditions:
+        return BuildCallConditions();
+    case TestRom::Count:
+        break;
+    }
+
+    DEBUGBREAKLOG("Invalid test ROM: " << static_cast<int>(testRom));
+    return {};
+}
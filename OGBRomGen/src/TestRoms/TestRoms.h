@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Core/Definitions.h"
+
+// Cartridge images checking one behaviour of the emulator. Like Blargg's test ROMs, each one prints "Passed", or the
+// failing case number followed by "Failed", over serial and then loops forever. A run can stop on the result with
+// --serial-stop Passed --serial-stop Failed.
+enum class TestRom : byte
+{
+    // CALL NZ, CALL Z, CALL NC and CALL C, each with its condition met and not met
+    CallConditions,
+    Count
+};
+
+namespace TestRoms
+{
+    [[nodiscard]] const char* GetName(TestRom testRom);
+    // Case sensitive, returns false when no test ROM has the name
+    [[nodiscard]] bool FromName(const std::string& name, TestRom& testRom);
+
+    [[nodiscard]] std::vector<byte> Build(TestRom testRom);
+}
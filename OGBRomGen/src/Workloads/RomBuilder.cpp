@@ -0,0 +1,104 @@
+#include "RomBuilder.h"
+
+#include <bit>
+
+#include "Core/Logger.h"
+
+#include "Emulator/GbConstants.h"
+#include "Emulator/Memory/AddressConstants.h"
+
+RomBuilder::RomBuilder(const std::string& title, const CartridgeType cartridgeType, const unsigned int bankCount) :
+    _rom(static_cast<size_t>(bankCount) * BankSize)
+{
+    if (bankCount < 2 || !std::has_single_bit(bankCount))
+        DEBUGBREAKLOG("ROM bank count must be a power of two of at least 2, got " << bankCount);
+
+    // NOP; JP EntryPoint
+    _rom[0x100] = 0x00;
+    _rom[0x101] = 0xC3;
+    _rom[0x102] = EntryPoint & 0xFF;
+    _rom[0x103] = EntryPoint >> 8;
+
+    for (size_t i = 0; i < title.size() && AddressConstants::CartridgeTitleStartAddress + i < AddressConstants::CartridgeTitleNewEndAddress; i++)
+        _rom[AddressConstants::CartridgeTitleStartAddress + i] = static_cast<byte>(title[i]);
+
+    _rom[AddressConstants::CartridgeTypeAddress] = static_cast<byte>(cartridgeType);
+    _rom[AddressConstants::CartridgeRomSizeAddress] = static_cast<byte>(std::countr_zero(bankCount) - 1);
+    _rom[AddressConstants::CartridgeRamSizeAddress] = GbConstants::RamSizeFlagNoRam;
+}
+
+word RomBuilder::GetAddress() const
+{
+    if (_offset < BankSize)
+        return static_cast<word>(_offset);
+
+    return static_cast<word>(AddressConstants::StartRomBankNAddress + _offset % BankSize);
+}
+
+void RomBuilder::Emit(const byte data)
+{
+    if (_offset >= _rom.size())
+    {
+        DEBUGBREAKLOG("Emitting past the end of the ROM, offset " << _offset);
+        return;
+    }
+
+    _rom[_offset++] = data;
+}
+
+void RomBuilder::Emit(const std::initializer_list<byte> bytes)
+{
+    for (const byte data : bytes)
+        Emit(data);
+}
+
+void RomBuilder::EmitWord(const word data)
+{
+    Emit(static_cast<byte>(data));
+    Emit(static_cast<byte>(data >> 8));
+}
+
+void RomBuilder::EmitRelativeJump(const byte opcode, const word targetAddress)
+{
+    Emit(opcode);
+
+    const int offset = targetAddress - (GetAddress() + 1);
+    if (offset < -128 || offset > 127)
+        DEBUGBREAKLOG("Relative jump out of range, from " << GetAddress() << " to " << targetAddress);
+
+    Emit(static_cast<byte>(offset));
+}
+
+std::vector<byte> RomBuilder::Build()
+{
+    byte headerChecksum = 0;
+    for (word address = AddressConstants::CartridgeTitleStartAddress; address < AddressConstants::CartridgeHeaderChecksumAddress; address++)
+        headerChecksum = static_cast<byte>(headerChecksum - _rom[address] - 1);
+    _rom[AddressConstants::CartridgeHeaderChecksumAddress] = headerChecksum;
+
+    word globalChecksum = 0;
+    for (size_t i = 0; i < _rom.size(); i++)
+    {
+        if (i != AddressConstants::CartridgeGlobalChecksumAddressStart && i != AddressConstants::CartridgeGlobalChecksumAddressEnd)
+            globalChecksum = static_cast<word>(globalChecksum + _rom[i]);
+    }
+    _rom[AddressConstants::CartridgeGlobalChecksumAddressStart] = static_cast<byte>(globalChecksum >> 8);
+    _rom[AddressConstants::CartridgeGlobalChecksumAddressEnd] = static_cast<byte>(globalChecksum);
+
+    return _rom;
+}
+
+std::vector<byte> RomBuilder::CreateBootRom()
+{
+    std::vector<byte> bootRom(GbConstants::BootRomSize);
+
+    // LD SP,FFFE; JP 00FC
+    constexpr byte start[] = {0x31, 0xFE, 0xFF, 0xC3, 0xFC, 0x00};
+    std::copy(std::begin(start), std::end(start), bootRom.begin());
+
+    // LD A,1; LDH (50),A, the cartridge entry follows
+    constexpr byte unmap[] = {0x3E, 0x01, 0xE0, 0x50};
+    std::copy(std::begin(unmap), std::end(unmap), bootRom.begin() + 0xFC);
+
+    return bootRom;
+}
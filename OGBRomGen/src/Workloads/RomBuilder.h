@@ -0,0 +1,41 @@
+#pragma once
+
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include "Core/Definitions.h"
+
+#include "Emulator/Memory/Cartridge.h"
+
+// Assembles cartridge images in memory. Code is emitted from the entry point on, and Build fills in a header that
+// passes Cartridge::IsValid, with correct header and global checksums.
+class RomBuilder
+{
+public:
+    RomBuilder(const std::string& title, CartridgeType cartridgeType = CartridgeType::RomOnly, unsigned int bankCount = 2);
+
+    static constexpr word EntryPoint = 0x150;
+    static constexpr unsigned int BankSize = 16 * 1024;
+
+    // Offset in the image where the next byte is emitted, banks follow each other
+    [[nodiscard]] unsigned int GetOffset() const { return _offset; }
+    void SetOffset(const unsigned int offset) { _offset = offset; }
+    // Bus address the next byte will be seen at, in bank 0 or the switchable bank
+    [[nodiscard]] word GetAddress() const;
+
+    void Emit(byte data);
+    void Emit(std::initializer_list<byte> bytes);
+    void EmitWord(word data);
+    // JR or JR cc to an address of the same bank
+    void EmitRelativeJump(byte opcode, word targetAddress);
+
+    [[nodiscard]] std::vector<byte> Build();
+
+    // Minimal boot ROM that unmaps itself and jumps to the cartridge entry
+    [[nodiscard]] static std::vector<byte> CreateBootRom();
+
+private:
+    std::vector<byte> _rom;
+    unsigned int _offset = EntryPoint;
+};
@@ -0,0 +1,275 @@
+#include "Workloads.h"
+
+#include "Core/Logger.h"
+
+#include "Emulator/GbConstants.h"
+#include "Emulator/Memory/AddressConstants.h"
+#include "Emulator/Memory/Cartridge.h"
+
+#include "RomBuilder.h"
+
+namespace
+{
+    constexpr word WRamBankAddress = 0xD000;
+    constexpr word CopySize = 0x1000;
+    constexpr word FlagAddress = 0xC000;
+    // Subroutines live past the main code, which never grows that far
+    constexpr unsigned int SubroutineOffset = 0x1000;
+    constexpr unsigned int BankSwitchBankCount = 8;
+
+    constexpr byte Jr = 0x18;
+    constexpr byte JrNz = 0x20;
+    constexpr byte JrZ = 0x28;
+    constexpr byte Di = 0xF3;
+    constexpr byte Ret = 0xC9;
+    constexpr byte Reti = 0xD9;
+
+    // Timer overflows every 16 * (256 - modulo) cycles with only its interrupt enabled, then interrupts are enabled
+    void EmitTimerSetup(RomBuilder& builder, const byte modulo)
+    {
+        builder.Emit({0x3E, modulo, 0xE0, AddressConstants::Tma & 0xFF}); // LD A,modulo; LDH (TMA),A
+        builder.Emit({0x3E, 0x05, 0xE0, AddressConstants::Tac & 0xFF}); // LD A,05; LDH (TAC),A
+        builder.Emit({0x3E, GbConstants::TimerInterrupt, 0xE0, AddressConstants::StartIeAddress & 0xFF}); // LD A,04; LDH (IE),A
+        builder.Emit({0xAF, 0xE0, AddressConstants::InterruptFlag & 0xFF}); // XOR A; LDH (IF),A
+        builder.Emit(0xFB); // EI
+    }
+
+    [[nodiscard]] std::vector<byte> BuildAlu()
+    {
+        RomBuilder builder("ALU");
+
+        builder.Emit(Di);
+        const word loopAddress = builder.GetAddress();
+        builder.Emit({0x80, 0x89, 0x92, 0x9B, 0xA4, 0xAD, 0xB4, 0xBF}); // ADD B; ADC C; SUB D; SBC E; AND H; XOR L; OR H; CP A
+        builder.Emit({0x04, 0x0D, 0x14, 0x1D, 0x07, 0x17, 0x2F, 0x27}); // INC B; DEC C; INC D; DEC E; RLCA; RLA; CPL; DAA
+        builder.Emit({0xC6, 0x35, 0xE6, 0xF7, 0xEE, 0x5A}); // ADD 35; AND F7; XOR 5A
+        builder.Emit({0xCB, 0x37, 0xCB, 0x20, 0xCB, 0x19, 0x47}); // SWAP A; SLA B; RR C; LD B,A
+        builder.Emit({0x24, 0x2C}); // INC H; INC L
+        builder.EmitRelativeJump(Jr, loopAddress);
+
+        return builder.Build();
+    }
+
+    [[nodiscard]] std::vector<byte> BuildMemoryCopy()
+    {
+        RomBuilder builder("MEMCOPY");
+
+        // Source data in the switchable bank
+        builder.SetOffset(RomBuilder::BankSize);
+        for (unsigned int i = 0; i < CopySize; i++)
+            builder.Emit(static_cast<byte>(i * 7));
+
+        // HL source, DE destination, BC size
+        builder.SetOffset(SubroutineOffset);
+        const word copyAddress = builder.GetAddress();
+        const word copyLoopAddress = builder.GetAddress();
+        builder.Emit({0x2A, 0x12, 0x13, 0x0B, 0x78, 0xB1}); // LD A,(HL+); LD (DE),A; INC DE; DEC BC; LD A,B; OR C
+        builder.EmitRelativeJump(JrNz, copyLoopAddress);
+        builder.Emit(Ret);
+
+        builder.SetOffset(RomBuilder::EntryPoint);
+        builder.Emit(Di);
+        const word loopAddress = builder.GetAddress();
+        builder.Emit({0x21, AddressConstants::StartRomBankNAddress & 0xFF, AddressConstants::StartRomBankNAddress >> 8}); // LD HL,4000
+        builder.Emit({0x11, AddressConstants::StartWRamAddress & 0xFF, AddressConstants::StartWRamAddress >> 8}); // LD DE,C000
+        builder.Emit({0x01, CopySize & 0xFF, CopySize >> 8}); // LD BC,size
+        builder.Emit(0xCD); // CALL copy
+        builder.EmitWord(copyAddress);
+        builder.Emit({0x21, AddressConstants::StartWRamAddress & 0xFF, AddressConstants::StartWRamAddress >> 8}); // LD HL,C000
+        builder.Emit({0x11, WRamBankAddress & 0xFF, WRamBankAddress >> 8}); // LD DE,D000
+        builder.Emit({0x01, CopySize & 0xFF, CopySize >> 8}); // LD BC,size
+        builder.Emit(0xCD); // CALL copy
+        builder.EmitWord(copyAddress);
+        builder.EmitRelativeJump(Jr, loopAddress);
+
+        return builder.Build();
+    }
+
+    [[nodiscard]] std::vector<byte> BuildBranch()
+    {
+        RomBuilder builder("BRANCH");
+
+        // Returns early on every other call
+        builder.SetOffset(SubroutineOffset);
+        const word subroutineAddress = builder.GetAddress();
+        builder.Emit({0xCB, 0x51, 0xC8, 0x24, Ret}); // BIT 2,C; RET Z; INC H; RET
+
+        builder.SetOffset(RomBuilder::EntryPoint);
+        builder.Emit(Di);
+        const word loopAddress = builder.GetAddress();
+        builder.Emit({0x0C, 0xCB, 0x41}); // INC C; BIT 0,C
+        builder.Emit({JrZ, 0x01, 0x14}); // JR Z,+1; INC D
+        builder.Emit({0xCB, 0x49, 0xC2}); // BIT 1,C; JP NZ over INC E
+        builder.EmitWord(static_cast<word>(builder.GetAddress() + 3));
+        builder.Emit(0x1C); // INC E
+        builder.Emit(0xCD); // CALL subroutine
+        builder.EmitWord(subroutineAddress);
+        builder.Emit({0x79, 0xE6, 0x07}); // LD A,C; AND 07
+        builder.EmitRelativeJump(JrNz, loopAddress);
+        builder.Emit(0x2C); // INC L
+        builder.EmitRelativeJump(Jr, loopAddress);
+
+        return builder.Build();
+    }
+
+    [[nodiscard]] std::vector<byte> BuildHalt()
+    {
+        RomBuilder builder("HALT");
+
+        builder.SetOffset(AddressConstants::TimerHandlerAddress);
+        builder.Emit(Reti);
+
+        builder.SetOffset(RomBuilder::EntryPoint);
+        builder.Emit(Di);
+        EmitTimerSetup(builder, 0x00);
+
+        const word loopAddress = builder.GetAddress();
+        builder.Emit(0x76); // HALT
+        builder.EmitRelativeJump(Jr, loopAddress);
+
+        return builder.Build();
+    }
+
+    [[nodiscard]] std::vector<byte> BuildInterrupt()
+    {
+        RomBuilder builder("INTERRUPT");
+
+        // Counts interrupts in work RAM
+        builder.SetOffset(AddressConstants::TimerHandlerAddress);
+        builder.Emit(0xC3); // JP handler
+        builder.EmitWord(SubroutineOffset);
+
+        builder.SetOffset(SubroutineOffset);
+        builder.Emit({0xF5, 0xFA, FlagAddress & 0xFF, FlagAddress >> 8}); // PUSH AF; LD A,(flag)
+        builder.Emit({0x3C, 0xEA, FlagAddress & 0xFF, FlagAddress >> 8}); // INC A; LD (flag),A
+        builder.Emit({0xF1, Reti}); // POP AF; RETI
+
+        builder.SetOffset(RomBuilder::EntryPoint);
+        builder.Emit(Di);
+        EmitTimerSetup(builder, 0xF0);
+
+        const word loopAddress = builder.GetAddress();
+        builder.Emit({0x04, 0x80}); // INC B; ADD B
+        builder.EmitRelativeJump(Jr, loopAddress);
+
+        return builder.Build();
+    }
+
+    [[nodiscard]] std::vector<byte> BuildPoll()
+    {
+        RomBuilder builder("POLL");
+
+        builder.SetOffset(AddressConstants::TimerHandlerAddress);
+        builder.Emit({0x3E, 0x01, 0xEA, FlagAddress & 0xFF, FlagAddress >> 8, Reti}); // LD A,1; LD (flag),A; RETI
+
+        builder.SetOffset(RomBuilder::EntryPoint);
+        builder.Emit(Di);
+        EmitTimerSetup(builder, 0x00);
+
+        const word restartAddress = builder.GetAddress();
+        builder.Emit({0xAF, 0xEA, FlagAddress & 0xFF, FlagAddress >> 8}); // XOR A; LD (flag),A
+
+        const word pollAddress = builder.GetAddress();
+        builder.Emit({0xFA, FlagAddress & 0xFF, FlagAddress >> 8, 0xB7}); // LD A,(flag); OR A
+        builder.EmitRelativeJump(JrZ, pollAddress);
+        builder.EmitRelativeJump(Jr, restartAddress);
+
+        return builder.Build();
+    }
+
+    [[nodiscard]] std::vector<byte> BuildBankSwitch()
+    {
+        RomBuilder builder("BANKSWITCH", CartridgeType::MBC1, BankSwitchBankCount);
+
+        // Each switchable bank adds its number to B
+        constexpr word bankNumberAddress = AddressConstants::StartRomBankNAddress + 0x100;
+        for (unsigned int bank = 1; bank < BankSwitchBankCount; bank++)
+        {
+            builder.SetOffset(bank * RomBuilder::BankSize);
+            builder.Emit({0xFA, bankNumberAddress & 0xFF, bankNumberAddress >> 8, 0x80, 0x47, Ret}); // LD A,(number); ADD B; LD B,A; RET
+
+            builder.SetOffset(bank * RomBuilder::BankSize + (bankNumberAddress - AddressConstants::StartRomBankNAddress));
+            builder.Emit(static_cast<byte>(bank));
+        }
+
+        builder.SetOffset(RomBuilder::EntryPoint);
+        builder.Emit(Di);
+        const word loopAddress = builder.GetAddress();
+        builder.Emit({0x0E, 0x01}); // LD C,1
+
+        const word nextBankAddress = builder.GetAddress();
+        builder.Emit({0x79, 0xEA, 0x00, 0x20}); // LD A,C; LD (2000),A
+        builder.Emit(0xCD); // CALL 4000
+        builder.EmitWord(AddressConstants::StartRomBankNAddress);
+        builder.Emit({0x0C, 0x79, 0xFE, BankSwitchBankCount}); // INC C; LD A,C; CP count
+        builder.EmitRelativeJump(JrNz, nextBankAddress);
+        builder.EmitRelativeJump(Jr, loopAddress);
+
+        return builder.Build();
+    }
+}
+
+const char* Workloads::GetName(const Workload workload)
+{
+    switch (workload)
+    {
+    case Workload::Alu:
+        return "Alu";
+    case Workload::MemoryCopy:
+        return "MemoryCopy";
+    case Workload::Branch:
+        return "Branch";
+    case Workload::Halt:
+        return "Halt";
+    case Workload::Interrupt:
+        return "Interrupt";
+    case Workload::Poll:
+        return "Poll";
+    case Workload::BankSwitch:
+        return "BankSwitch";
+    case Workload::Count:
+        break;
+    }
+
+    return "";
+}
+
+bool Workloads::FromName(const std::string& name, Workload& workload)
+{
+    for (byte i = 0; i < static_cast<byte>(Workload::Count); i++)
+    {
+        if (name == GetName(static_cast<Workload>(i)))
+        {
+            workload = static_cast<Workload>(i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::vector<byte> Workloads::Build(const Workload workload)
+{
+    switch (workload)
+    {
+    case Workload::Alu:
+        return BuildAlu();
+    case Workload::MemoryCopy:
+        return BuildMemoryCopy();
+    case Workload::Branch:
+        return BuildBranch();
+    case Workload::Halt:
+        return BuildHalt();
+    case Workload::Interrupt:
+        return BuildInterrupt();
+    case Workload::Poll:
+        return BuildPoll();
+    case Workload::BankSwitch:
+        return BuildBankSwitch();
+    case Workload::Count:
+        break;
+    }
+
+    DEBUGBREAKLOG("Invalid workload: " << static_cast<int>(workload));
+    return {};
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Core/Definitions.h"
+
+// Cartridge images looping forever on one kind of work, each one keeps a single hot path of the emulator busy
+enum class Workload : byte
+{
+    // Register arithmetic and logic
+    Alu,
+    // Block copies from ROM to work RAM and within work RAM
+    MemoryCopy,
+    // Taken and not taken conditional jumps, calls and returns
+    Branch,
+    // Halted between timer interrupts
+    Halt,
+    // Timer interrupts every 256 cycles interrupting a busy loop
+    Interrupt,
+    // Polling a work RAM flag raised by an interrupt
+    Poll,
+    // MBC1 bank switches, calling code in every switchable bank
+    BankSwitch,
+    Count
+};
+
+namespace Workloads
+{
+    [[nodiscard]] const char* GetName(Workload workload);
+    // Case sensitive, returns false when no workload has the name
+    [[nodiscard]] bool FromName(const std::string& name, Workload& workload);
+
+    [[nodiscard]] std::vector<byte> Build(Workload workload);
+}
@@ -0,0 +1,128 @@
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "Core/Logger.h"
+#include "Core/Utils.h"
+
+#include "TestRoms/TestRoms.h"
+#include "Workloads/RomBuilder.h"
+#include "Workloads/Workloads.h"
+
+namespace
+{
+    struct Options
+    {
+        std::string outputDirectory;
+        std::string bootRomPath;
+        std::vector<Workload> workloads;
+        std::vector<TestRom> testRoms;
+    };
+}
+
+bool ParseArguments(const int argc, char* argv[], Options& options)
+{
+    std::vector<std::string> positionalArguments;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (argument == "--boot-rom" && hasValue)
+            options.bootRomPath = argv[++i];
+        else if (argument.starts_with("--"))
+            return false;
+        else
+            positionalArguments.push_back(argument);
+    }
+
+    if (positionalArguments.empty())
+        return false;
+
+    options.outputDirectory = positionalArguments[0];
+
+    for (size_t i = 1; i < positionalArguments.size(); i++)
+    {
+        Workload workload;
+        TestRom testRom;
+        if (Workloads::FromName(positionalArguments[i], workload))
+            options.workloads.push_back(workload);
+        else if (TestRoms::FromName(positionalArguments[i], testRom))
+            options.testRoms.push_back(testRom);
+        else
+        {
+            LOG("Unknown workload or test ROM " << positionalArguments[i]);
+            return false;
+        }
+    }
+
+    // Every workload and test ROM by default
+    if (options.workloads.empty() && options.testRoms.empty())
+    {
+        for (byte i = 0; i < static_cast<byte>(Workload::Count); i++)
+            options.workloads.push_back(static_cast<Workload>(i));
+        for (byte i = 0; i < static_cast<byte>(TestRom::Count); i++)
+            options.testRoms.push_back(static_cast<TestRom>(i));
+    }
+
+    return true;
+}
+
+bool WriteRom(const std::string& outputDirectory, const std::string& name, const std::vector<byte>& rom)
+{
+    const std::filesystem::path romPath = std::filesystem::path(outputDirectory) / (name + ".gb");
+    if (!Utils::WriteBinaryFile(romPath.string(), rom))
+        return false;
+
+    LOG("Wrote " << romPath.string());
+    return true;
+}
+
+int main(const int argc, char* argv[])
+{
+    Options options;
+
+    if (!ParseArguments(argc, argv, options))
+    {
+        DEBUGBREAKLOG("Wrong program arguments, usage: OGBRomGen [--boot-rom bootRom.bin] outputDirectory [workload | testRom]...");
+
+        std::string workloadNames;
+        for (byte i = 0; i < static_cast<byte>(Workload::Count); i++)
+            workloadNames += std::string(" ") + Workloads::GetName(static_cast<Workload>(i));
+        LOG("Workloads:" << workloadNames);
+
+        std::string testRomNames;
+        for (byte i = 0; i < static_cast<byte>(TestRom::Count); i++)
+            testRomNames += std::string(" ") + TestRoms::GetName(static_cast<TestRom>(i));
+        LOG("Test ROMs:" << testRomNames);
+
+        return 1;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(options.outputDirectory, error);
+    if (error)
+    {
+        LOG("Couldn't create directory " << options.outputDirectory << ": " << error.message());
+        return 1;
+    }
+
+    // The emulator needs a boot ROM, this one only unmaps itself
+    if (!options.bootRomPath.empty() && !Utils::WriteBinaryFile(options.bootRomPath, RomBuilder::CreateBootRom()))
+        return 1;
+
+    for (const Workload workload : options.workloads)
+    {
+        if (!WriteRom(options.outputDirectory, Workloads::GetName(workload), Workloads::Build(workload)))
+            return 1;
+    }
+
+    for (const TestRom testRom : options.testRoms)
+    {
+        if (!WriteRom(options.outputDirectory, TestRoms::GetName(testRom), TestRoms::Build(testRom)))
+            return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <deque>
+#include <format>
+#include <string>
+#include <vector>
+
+#include "Core/Logger.h"
+
+#include "Emulator/Disassembly/Disassembler.h"
+#include "Emulator/Trace/InstructionTrace.h"
+#include "Emulator/Trace/InstructionTraceReader.h"
+
+namespace
+{
+    struct Options
+    {
+        std::string tracePath;
+        // Stops before the given occurrence of the PC, negative to read the whole trace
+        int untilPc = -1;
+        unsigned int untilPcOccurrence = 1;
+        word pcRangeStart = 0x0000;
+        word pcRangeEnd = 0xFFFF;
+        unsigned long long startCycle = 0;
+        // Only the last records printed are kept, 0 to print all
+        unsigned int lastCount = 0;
+        bool countOnly = false;
+        // Prints the most frequent pairs of consecutive opcodes instead of the records, 0 to print none
+        unsigned int opcodePairCount = 0;
+    };
+
+    [[nodiscard]] word ParseAddress(const std::string& text)
+    {
+        return static_cast<word>(std::stoul(text, nullptr, 16));
+    }
+
+    [[nodiscard]] std::string FormatRecord(const InstructionTrace::Record& record)
+    {
+        std::string instruction;
+        std::string mnemonic;
+        if (record.isHalted)
+            instruction = "HALTED";
+        else
+        {
+            const Disassembler::Instruction decoded = Disassembler::Decode(record.instruction.data(), record.state.pc);
+            for (byte i = 0; i < decoded.info->size; i++)
+                instruction += std::format("{:02X} ", record.instruction[i]);
+            mnemonic = Disassembler::Format(decoded);
+        }
+
+        return std::format("{:>12} {:04X}: {:<9} {:<16} AF={:04X} BC={:04X} DE={:04X} HL={:04X} SP={:04X} IME={}", record.cycle, record.state.pc,
+                           instruction, mnemonic, record.state.af, record.state.bc, record.state.de, record.state.hl, record.state.sp, record.state.ime);
+    }
+}
+
+bool ParseArguments(const int argc, char* argv[], Options& options)
+{
+    std::vector<std::string> positionalArguments;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (argument == "--until-pc" && hasValue)
+            options.untilPc = ParseAddress(argv[++i]);
+        else if (argument == "--occurrence" && hasValue)
+            options.untilPcOccurrence = static_cast<unsigned int>(std::stoul(argv[++i]));
+        else if (argument == "--pc-range" && hasValue)
+        {
+            const std::string range(argv[++i]);
+            const size_t separator = range.find('-');
+            if (separator == std::string::npos)
+                return false;
+
+            options.pcRangeStart = ParseAddress(range.substr(0, separator));
+            options.pcRangeEnd = ParseAddress(range.substr(separator + 1));
+        }
+        else if (argument == "--from-cycle" && hasValue)
+            options.startCycle = std::stoull(argv[++i]);
+        else if (argument == "--last" && hasValue)
+            options.lastCount = static_cast<unsigned int>(std::stoul(argv[++i]));
+        else if (argument == "--count")
+            options.countOnly = true;
+        else if (argument == "--opcode-pairs" && hasValue)
+            options.opcodePairCount = static_cast<unsigned int>(std::stoul(argv[++i]));
+        else if (argument.starts_with("--"))
+            return false;
+        else
+            positionalArguments.push_back(argument);
+    }
+
+    if (positionalArguments.size() != 1)
+        return false;
+
+    options.tracePath = positionalArguments[0];
+    return true;
+}
+
+// Prints the records of a trace matching the filters, for instance the last 10000 instructions before the first time
+// PC reaches 1234: OGBTrace trace.ogbt --until-pc 1234 --last 10000
+int main(const int argc, char* argv[])
+{
+    Options options;
+
+    if (!ParseArguments(argc, argv, options))
+    {
+        DEBUGBREAKLOG("Wrong program arguments, usage: OGBTrace [--until-pc hexAddress [--occurrence n]] [--pc-range hexStart-hexEnd] "
+            "[--from-cycle cycle] [--last count] [--count] [--opcode-pairs count] trace.ogbt");
+        return 1;
+    }
+
+    InstructionTraceReader reader(options.tracePath);
+    if (!reader.IsValid())
+        return 1;
+
+    std::deque<InstructionTrace::Record> lastRecords;
+    std::vector<InstructionTrace::Record> block;
+    unsigned long long matchedCount = 0;
+    unsigned int untilPcCount = 0;
+    bool reachedUntilPc = false;
+
+    // Indexed by the first opcode in the upper byte, CB prefixed instructions count as CB
+    std::vector<unsigned long long> opcodePairCounts(options.opcodePairCount ? 0x10000 : 0);
+    int previousOpcode = -1;
+
+    while (!reachedUntilPc && reader.ReadBlock(block))
+    {
+        for (const InstructionTrace::Record& record : block)
+        {
+            if (record.state.pc == options.untilPc && !record.isHalted && ++untilPcCount == options.untilPcOccurrence)
+            {
+                reachedUntilPc = true;
+                break;
+            }
+
+            if (record.cycle < options.startCycle || record.state.pc < options.pcRangeStart || record.state.pc > options.pcRangeEnd)
+                continue;
+
+            matchedCount++;
+            if (options.countOnly)
+                continue;
+
+            if (options.opcodePairCount)
+            {
+                // A halt, or an interrupt, breaks the sequence
+                const int opcode = record.isHalted ? -1 : record.instruction[0];
+                if (previousOpcode >= 0 && opcode >= 0)
+                    opcodePairCounts[previousOpcode << 8 | opcode]++;
+                previousOpcode = opcode;
+                continue;
+            }
+
+            if (options.lastCount == 0)
+            {
+                LOG(FormatRecord(record));
+                continue;
+            }
+
+            lastRecords.push_back(record);
+            if (lastRecords.size() > options.lastCount)
+                lastRecords.pop_front();
+        }
+    }
+
+    for (const InstructionTrace::Record& record : lastRecords)
+        LOG(FormatRecord(record));
+
+    if (options.untilPc >= 0 && !reachedUntilPc)
+        LOG(std::format("PC {:04X} wasn't reached {} times", options.untilPc, options.untilPcOccurrence));
+
+    if (options.countOnly)
+        LOG(matchedCount << " matching instructions");
+
+    if (options.opcodePairCount)
+    {
+        std::vector<unsigned int> pairs(opcodePairCounts.size());
+        for (unsigned int i = 0; i < pairs.size(); i++)
+            pairs[i] = i;
+
+        const unsigned int printedCount = std::min<unsigned int>(options.opcodePairCount, static_cast<unsigned int>(pairs.size()));
+        std::partial_sort(pairs.begin(), pairs.begin() + printedCount, pairs.end(), [&opcodePairCounts](const unsigned int lhs, const unsigned int rhs)
+        {
+            return opcodePairCounts[lhs] > opcodePairCounts[rhs];
+        });
+
+        for (unsigned int i = 0; i < printedCount && opcodePairCounts[pairs[i]] != 0; i++)
+        {
+            const unsigned long long count = opcodePairCounts[pairs[i]];
+            LOG(std::format("{:02X} {:02X} {:>12} {:6.2f}%", pairs[i] >> 8, pairs[i] & 0xFF, count,
+                            100. * static_cast<double>(count) / static_cast<double>(matchedCount)));
+        }
+    }
+
+    return 0;
+}
@@ -63,4 +63,343 @@ project "OGBEmu"
 	filter "configurations:Dist"
 		defines "HZ_DIST"
 		runtime "Release"
-		optimize "on"
\ No newline at end of file
+		optimize "on"
+
+project "OGBEmuBenchmark"
+	location "OGBEmuBenchmark"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+	staticruntime "on"
+
+	targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+	files
+	{
+		"%{prj.name}/src/**.h",
+		"%{prj.name}/src/**.cpp",
+		"OGBEmu/src/Core/**.h",
+		"OGBEmu/src/Core/**.cpp",
+		"OGBEmu/src/Emulator/**.h",
+		"OGBEmu/src/Emulator/**.cpp",
+		"OGBRomGen/src/Workloads/**.h",
+		"OGBRomGen/src/Workloads/**.cpp",
+	}
+
+	defines
+	{
+	}
+
+	includedirs
+	{
+		"%{prj.name}/src",
+		"OGBEmu/src",
+		"OGBRomGen/src",
+	}
+
+	links 
+	{
+	}
+
+	filter "system:windows"
+		systemversion "latest"
+
+		defines
+		{
+		}
+
+	filter "configurations:Debug"
+		defines "HZ_DEBUG"
+		runtime "Debug"
+		symbols "on"
+
+	filter "configurations:Release"
+		defines "HZ_RELEASE"
+		runtime "Release"
+		optimize "on"
+
+	filter "configurations:Dist"
+		defines "HZ_DIST"
+		runtime "Release"
+		optimize "on"
+
+project "OGBRomGen"
+	location "OGBRomGen"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+	staticruntime "on"
+
+	targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+	files
+	{
+		"%{prj.name}/src/**.h",
+		"%{prj.name}/src/**.cpp",
+		"OGBEmu/src/Core/**.h",
+		"OGBEmu/src/Core/**.cpp",
+	}
+
+	defines
+	{
+	}
+
+	includedirs
+	{
+		"%{prj.name}/src",
+		"OGBEmu/src",
+	}
+
+	links 
+	{
+	}
+
+	filter "system:windows"
+		systemversion "latest"
+
+		defines
+		{
+		}
+
+	filter "configurations:Debug"
+		defines "HZ_DEBUG"
+		runtime "Debug"
+		symbols "on"
+
+	filter "configurations:Release"
+		defines "HZ_RELEASE"
+		runtime "Release"
+		optimize "on"
+
+	filter "configurations:Dist"
+		defines "HZ_DIST"
+		runtime "Release"
+		optimize "on"
+
+project "OGBTrace"
+	location "OGBTrace"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+	staticruntime "on"
+
+	targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+	files
+	{
+		"%{prj.name}/src/**.h",
+		"%{prj.name}/src/**.cpp",
+		"OGBEmu/src/Core/**.h",
+		"OGBEmu/src/Core/**.cpp",
+		"OGBEmu/src/Emulator/Trace/**.h",
+		"OGBEmu/src/Emulator/Trace/**.cpp",
+		"OGBEmu/src/Emulator/Disassembly/**.h",
+		"OGBEmu/src/Emulator/Disassembly/**.cpp",
+	}
+
+	defines
+	{
+	}
+
+	includedirs
+	{
+		"%{prj.name}/src",
+		"OGBEmu/src",
+	}
+
+	links 
+	{
+	}
+
+	filter "system:windows"
+		systemversion "latest"
+
+		defines
+		{
+		}
+
+	filter "configurations:Debug"
+		defines "HZ_DEBUG"
+		runtime "Debug"
+		symbols "on"
+
+	filter "configurations:Release"
+		defines "HZ_RELEASE"
+		runtime "Release"
+		optimize "on"
+
+	filter "configurations:Dist"
+		defines "HZ_DIST"
+		runtime "Release"
+		optimize "on"
+
+project "OGBRecompiler"
+	location "OGBRecompiler"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+	staticruntime "on"
+
+	targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+	files
+	{
+		"%{prj.name}/src/**.h",
+		"%{prj.name}/src/**.cpp",
+		"OGBEmu/src/Core/**.h",
+		"OGBEmu/src/Core/**.cpp",
+		"OGBEmu/src/Emulator/Disassembly/**.h",
+		"OGBEmu/src/Emulator/Disassembly/**.cpp",
+	}
+
+	defines
+	{
+	}
+
+	includedirs
+	{
+		"%{prj.name}/src",
+		"OGBEmu/src",
+	}
+
+	links 
+	{
+	}
+
+	filter "system:windows"
+		systemversion "latest"
+
+		defines
+		{
+		}
+
+	filter "configurations:Debug"
+		defines "HZ_DEBUG"
+		runtime "Debug"
+		symbols "on"
+
+	filter "configurations:Release"
+		defines "HZ_RELEASE"
+		runtime "Release"
+		optimize "on"
+
+	filter "configurations:Dist"
+		defines "HZ_DIST"
+		runtime "Release"
+		optimize "on"
+
+project "OGBFuzz"
+	location "OGBFuzz"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+	staticruntime "on"
+
+	targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+	files
+	{
+		"%{prj.name}/src/**.h",
+		"%{prj.name}/src/**.cpp",
+		"OGBEmu/src/Core/**.h",
+		"OGBEmu/src/Core/**.cpp",
+		"OGBEmu/src/Emulator/**.h",
+		"OGBEmu/src/Emulator/**.cpp",
+	}
+
+	defines
+	{
+	}
+
+	includedirs
+	{
+		"%{prj.name}/src",
+		"OGBEmu/src",
+	}
+
+	links 
+	{
+	}
+
+	filter "system:windows"
+		systemversion "latest"
+
+		defines
+		{
+		}
+
+	filter "configurations:Debug"
+		defines "HZ_DEBUG"
+		runtime "Debug"
+		symbols "on"
+
+	filter "configurations:Release"
+		defines "HZ_RELEASE"
+		runtime "Release"
+		optimize "on"
+
+	filter "configurations:Dist"
+		defines "HZ_DIST"
+		runtime "Release"
+		optimize "on"
+
+project "OGBBisect"
+	location "OGBBisect"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+	staticruntime "on"
+
+	targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+	files
+	{
+		"%{prj.name}/src/**.h",
+		"%{prj.name}/src/**.cpp",
+		"OGBEmu/src/Core/**.h",
+		"OGBEmu/src/Core/**.cpp",
+		"OGBEmu/src/Emulator/**.h",
+		"OGBEmu/src/Emulator/**.cpp",
+	}
+
+	defines
+	{
+	}
+
+	includedirs
+	{
+		"%{prj.name}/src",
+		"OGBEmu/src",
+	}
+
+	links 
+	{
+	}
+
+	filter "system:windows"
+		systemversion "latest"
+
+		defines
+		{
+		}
+
+	filter "configurations:Debug"
+		defines "HZ_DEBUG"
+		runtime "Debug"
+		symbols "on"
+
+	filter "configurations:Release"
+		defines "HZ_RELEASE"
+		runtime "Release"
+		optimize "on"
+
+	filter "configurations:Dist"
+		defines "HZ_DIST"
+		runtime "Release"
+		optimize "on"